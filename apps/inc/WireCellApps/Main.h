@@ -85,6 +85,18 @@ namespace WireCell {
         /// log. (levels: critical, error, warn, info, debug, trace).
         void set_loglevel(const std::string& log, const std::string& level = "");
 
+        /// Set the number of worker processes.  If more than one,
+        /// initialize() forks this many workers after loading plugins
+        /// and configuration.  Each worker processes a disjoint Shard
+        /// of the events and fails if any source is not sharded()
+        /// (see ISourceNodeBase).  A worker writes each file named
+        /// by an "outname" configuration parameter to its own file.
+        /// In the original process, operator()() waits for the
+        /// workers and merges their tar outputs into the original
+        /// files using the event index written by the file sinks
+        /// (see Shard::record()).
+        void set_workers(int nworkers);
+
         /// Call once after all setup has been done and before
         /// running.
         void initialize();
@@ -107,6 +119,22 @@ namespace WireCell {
         // Limit number of threads.  0 means set no limit.  This is
         // only relevant if we are built with TBB support
         int m_threads{0};
+
+        // Number of worker processes, this process's worker index
+        // (-1 if not a worker), the worker process IDs and the
+        // original output file names.
+        int m_workers{0};
+        int m_worker{-1};
+        std::vector<int> m_pids;
+        std::vector<std::string> m_outnames;
+
+        // Fork workers, called by initialize().
+        void fork_workers();
+        // Wait for workers and merge their output, called by
+        // operator()() in the original process.
+        void join_workers();
+
+        bool forked() const { return m_workers > 1 and m_worker < 0; }
     };
 
 }  // namespace WireCell
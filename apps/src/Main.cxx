@@ -7,20 +7,30 @@
 #include "WireCellUtil/NamedFactory.h"
 #include "WireCellUtil/String.h"
 #include "WireCellUtil/Point.h"
+#include "WireCellUtil/Shard.h"
 
 #include "WireCellIface/IConfigurable.h"
 #include "WireCellIface/ITerminal.h"
 #include "WireCellIface/IApplication.h"
 #include "WireCellIface/INamed.h"
+#include "WireCellIface/ISourceNode.h"
 
 #include <boost/program_options.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <regex>
 #include <string>
 #include <vector>
 #include <iostream>
 
+#include <sys/wait.h>
+#include <unistd.h>
+
 #if HAVE_FFTWTHREADS_LIB
 #include <fftw3.h>
 #endif
@@ -88,6 +98,10 @@ int Main::cmdline(int argc, char* argv[])
          "limit number of threads used")
 #endif
 
+        ("workers,w", po::value<int>(),
+         "fork this number of worker processes, each processing "
+         "a disjoint share of the events")
+
         ("version,v", 
          "print the compiled version to stdout")
 
@@ -199,6 +213,9 @@ int Main::cmdline(int argc, char* argv[])
         m_threads = opts["threads"].as<int>();
     }
 #endif
+    if (opts.count("workers")) {
+        set_workers(opts["workers"].as<int>());
+    }
 
     return 0;
 }
@@ -241,6 +258,104 @@ void Main::tla_code(const std::string& name, const std::string& value) { m_tlaco
 
 void Main::add_path(const std::string& dirname) { m_load_path.push_back(dirname); }
 
+void Main::set_workers(int nworkers)
+{
+    if (nworkers < 0) {
+        THROW(ValueError() << errmsg{"number of workers must be non-negative"});
+    }
+    m_workers = nworkers;
+}
+
+void Main::fork_workers()
+{
+    Configuration all = m_cfgmgr.all();
+    for (const auto& c : all) {
+        if (c.isObject() and c["data"].isObject() and c["data"]["outname"].isString()) {
+            m_outnames.push_back(c["data"]["outname"].asString());
+        }
+    }
+
+    log->info("forking {} workers", m_workers);
+    std::cout.flush();
+    std::cerr.flush();
+    for (int ind = 0; ind < m_workers; ++ind) {
+        const pid_t pid = fork();
+        if (pid < 0) {
+            log->critical("failed to fork worker {}: {}", ind, strerror(errno));
+            THROW(RuntimeError() << errmsg{"failed to fork worker"});
+        }
+        if (pid > 0) {
+            m_pids.push_back(pid);
+            continue;
+        }
+
+        // In the worker.
+        m_worker = ind;
+        m_pids.clear();
+        Shard::set(ind, m_workers);
+        for (auto& c : all) {
+            if (c.isObject() and c["data"].isObject() and c["data"]["outname"].isString()) {
+                const std::string partname = Shard::outname(c["data"]["outname"].asString(), ind);
+                std::remove(Shard::indexname(partname).c_str());  // stale from an earlier run
+                c["data"]["outname"] = partname;
+            }
+        }
+        m_cfgmgr = ConfigManager();
+        m_cfgmgr.extend(all);
+        log->debug("worker {} of {} started with pid {}", ind, m_workers, getpid());
+        return;
+    }
+}
+
+void Main::join_workers()
+{
+    int nfailed = 0;
+    for (size_t ind = 0; ind < m_pids.size(); ++ind) {
+        int status = 0;
+        if (waitpid(m_pids[ind], &status, 0) < 0 or !WIFEXITED(status) or WEXITSTATUS(status)) {
+            log->error("worker {} with pid {} failed", ind, m_pids[ind]);
+            ++nfailed;
+        }
+    }
+    m_pids.clear();
+    if (nfailed) {
+        log->critical("{} of {} workers failed, not merging output", nfailed, m_workers);
+        THROW(RuntimeError() << errmsg{"worker failed"});
+    }
+
+    const std::regex archive("[_.](tar|tgz|tbz|tbz2)\\b");
+    for (const auto& outname : m_outnames) {
+        std::vector<std::string> partnames;
+        for (int ind = 0; ind < m_workers; ++ind) {
+            const std::string partname = Shard::outname(outname, ind);
+            if (std::ifstream(partname).good()) {
+                partnames.push_back(partname);
+            }
+        }
+        if (partnames.empty()) {
+            continue;
+        }
+        if (!std::regex_search(outname, archive)) {
+            log->warn("can not merge {} worker outputs of non-archive file {}", partnames.size(), outname);
+            continue;
+        }
+        const bool indexed = std::all_of(partnames.begin(), partnames.end(), [](const std::string& partname) {
+            return std::ifstream(Shard::indexname(partname)).good();
+        });
+        if (!indexed) {
+            log->warn("can not merge {} worker outputs into {} without an event index from each",
+                      partnames.size(), outname);
+            continue;
+        }
+        log->debug("merging {} worker outputs into {}", partnames.size(), outname);
+        Shard::merge(outname, partnames);
+        for (const auto& partname : partnames) {
+            std::remove(partname.c_str());
+            std::remove(Shard::indexname(partname).c_str());
+        }
+    }
+}
+
 void Main::initialize()
 {
     // Here we got thought the boot-up sequence steps.
@@ -293,6 +408,15 @@ void Main::initialize()
         pm.add(pname, lname);
     }
 
+    // Workers share loaded plugins and configuration.  The original
+    // process goes no further.
+    if (m_workers > 1) {
+        fork_workers();
+        if (forked()) {
+            return;
+        }
+    }
+
     // Apply any component configuration sequence.
 
     // Instantiation
@@ -314,6 +438,23 @@ void Main::initialize()
         Factory::lookup_tn<IApplication>(c);
     }
 
+    // Every source must skip the events of the other workers.
+    if (m_worker >= 0) {
+        for (auto c : m_cfgmgr.all()) {
+            if (c.isNull()) {
+                continue;
+            }
+            const string type = get<string>(c, "type");
+            const string name = get<string>(c, "name");
+            auto src = Factory::find_maybe<ISourceNodeBase>(type, name);
+            if (src and !src->sharded()) {
+                log->critical("worker {}: source \"{}\":\"{}\" does not support splitting events across workers",
+                              m_worker, type, name);
+                THROW(ValueError() << errmsg{"source does not support workers: " + type});
+            }
+        }
+    }
+
     // Give any named components their name.
     for (auto c : m_cfgmgr.all()) {
         if (c.isNull()) {
@@ -352,6 +493,11 @@ void Main::initialize()
 
 void Main::operator()()
 {
+    if (forked()) {
+        join_workers();
+        return;
+    }
+
     // Find all IApplications to execute
     vector<IApplication::pointer> app_objs;
     for (auto component : m_apps) {
@@ -383,10 +529,17 @@ void Main::operator()()
         aobj->execute();  // throws
     }
 
+    if (m_worker >= 0) {
+        Shard::save();
+    }
+
 }
 
 void Main::finalize()
 {
+    if (forked()) {
+        return;  // workers finalize their own components
+    }
     for (auto c : m_cfgmgr.all()) {
         if (c.isNull()) {
             continue;  // allow and ignore any totally empty configurations
@@ -0,0 +1,104 @@
+// Check that Main with workers splits events across forked worker
+// processes and merges their archives in event order.
+
+#include "WireCellApps/Main.h"
+
+#include "WireCellIface/IApplication.h"
+#include "WireCellIface/IConfigurable.h"
+#include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Shard.h"
+#include "WireCellUtil/Stream.h"
+#include "WireCellUtil/Testing.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace WireCell;
+
+const int nevents = 5;
+const int nworkers = 2;
+
+// Writes the events of this process's Shard to an archive and
+// records them in the Shard index as a file sink would.
+class ShardWriter : public IApplication, public IConfigurable {
+   public:
+    virtual ~ShardWriter() {}
+
+    virtual void configure(const Configuration& cfg) { m_outname = get<std::string>(cfg, "outname"); }
+    virtual Configuration default_configuration() const
+    {
+        Configuration cfg;
+        cfg["outname"] = "";
+        return cfg;
+    }
+
+    virtual void execute()
+    {
+        boost::iostreams::filtering_ostream out;
+        Stream::output_filters(out, m_outname);
+        for (int event = 0; event < nevents; ++event) {
+            if (!Shard::mine(event)) {
+                continue;
+            }
+            const std::vector<int> data{event, (int) Shard::index()};
+            Stream::write(out, "frame_test_" + std::to_string(event) + ".npy", data);
+            Shard::record(m_outname, event, 1);
+        }
+        out.pop();
+    }
+
+   private:
+    std::string m_outname;
+};
+
+int main(int argc, char* argv[])
+{
+    // Register the app as a plugin would.
+    NamedFactory<ShardWriter> factory;
+    Factory::associate<Interface>("ShardWriter", &factory);
+    Factory::associate<IApplication>("ShardWriter", &factory);
+    Factory::associate<IConfigurable>("ShardWriter", &factory);
+
+    const std::string name = argv[0];
+    const std::string cfgname = name + ".json";
+    const std::string outname = name + ".tar";
+    {
+        std::ofstream cfg(cfgname);
+        cfg << "[{\"type\":\"wire-cell\",\"data\":{\"apps\":[\"ShardWriter\"]}},"
+            << "{\"type\":\"ShardWriter\",\"data\":{\"outname\":\"" << outname << "\"}}]\n";
+    }
+
+    {
+        Main m;
+        m.add_config(cfgname);
+        m.set_workers(nworkers);
+        m.initialize();
+        m();
+        if (Shard::count() > 1) {
+            // A worker is done.
+            return 0;
+        }
+    }
+
+    // Back in the original process with all workers joined.
+    for (int worker = 0; worker < nworkers; ++worker) {
+        Assert(!std::ifstream(Shard::outname(outname, worker)).good());
+        Assert(!std::ifstream(Shard::indexname(Shard::outname(outname, worker))).good());
+    }
+    boost::iostreams::filtering_istream in;
+    Stream::input_filters(in, outname);
+    for (int event = 0; event < nevents; ++event) {
+        std::string member;
+        std::vector<int> data;
+        Stream::read(in, member, data);
+        Assert(in);
+        std::cerr << member << ": event " << data[0] << " from worker " << data[1] << "\n";
+        Assert(member == "frame_test_" + std::to_string(event) + ".npy");
+        Assert(data[0] == event);
+        Assert(data[1] == event % nworkers);
+    }
+    std::remove(cfgname.c_str());
+    std::remove(outname.c_str());
+    return 0;
+}
@@ -48,6 +48,8 @@
 
 #include "WireCellIface/IDFT.h"
 #include <vector>
+#include <memory>
+#include <mutex>
 #include "WireCellUtil/Eigen.h"
 
 namespace WireCell::Aux::DftTools {
@@ -67,9 +69,10 @@ namespace WireCell::Aux::DftTools {
     complex_array_t fwd(const IDFT::pointer& dft, const complex_array_t& cwave, int axis);
 
     // Perform forward DFT, returning a complex spectrum given a real
-    // waveform.  The spectrum will have Hermitian symmetry along the
-    // axis of transform but only up to round-off errors accrued
-    // during the transform.
+    // waveform.  This uses the IDFT r2c transform and the half
+    // spectrum is mirrored so the spectrum spans the full frequency
+    // range with exact Hermitian symmetry along the axis of
+    // transform.
     complex_vector_t fwd_r2c(const IDFT::pointer& dft, const real_vector_t& wave);
     complex_array_t fwd_r2c(const IDFT::pointer& dft, const real_array_t& wave, int axis);
 
@@ -80,12 +83,21 @@ namespace WireCell::Aux::DftTools {
     complex_array_t inv(const IDFT::pointer& dft, const complex_array_t& spec, int axis);
 
     // Perform inverse or reverse DFT, returning a real waveform given
-    // a complex spectrum.  Prior to the DFT, the spectrum is forced
-    // to have Hermitian symmetry and thus any input values above the
+    // a complex spectrum.  This uses the IDFT c2r transform which
+    // assumes Hermitian symmetry and thus any input values above the
     // Nyquist frequency are ignored.
     real_vector_t inv_c2r(const IDFT::pointer& dft, const complex_vector_t& spec);
     real_array_t inv_c2r(const IDFT::pointer& dft, const complex_array_t& spec, int axis);
 
+    // As the 2D array functions above but with the result written
+    // to "out" which is resized only if its shape differs.  Reusing
+    // one "out" over many calls thus reuses its storage.  The fwd()
+    // and inv() forms transform in place if "out" is "in".
+    void fwd(const IDFT::pointer& dft, const complex_array_t& in, complex_array_t& out, int axis);
+    void inv(const IDFT::pointer& dft, const complex_array_t& in, complex_array_t& out, int axis);
+    void fwd_r2c(const IDFT::pointer& dft, const real_array_t& in, complex_array_t& out, int axis);
+    void inv_c2r(const IDFT::pointer& dft, const complex_array_t& in, real_array_t& out, int axis);
+
 
     /// Convolve in1 and in2 via DFT.  Returned vecgtor has size sum
     /// of sizes of in1 and in2 less one element in order to assure no
@@ -112,6 +124,67 @@ namespace WireCell::Aux::DftTools {
                           const real_vector_t& res1,
                           const real_vector_t& res2);
 
+    /// A fixed real kernel, such as a response or a filter, used as
+    /// one operand of many convolve() or replace() calls.  Its half
+    /// spectrum (see IDFT r2c) is computed for each padded length
+    /// that is requested and reused thereafter.  At most "capacity"
+    /// spectra are held, the least recently used is dropped first.
+    /// A Kernel may be shared by threads.
+    class Kernel {
+      public:
+        using spectrum_ptr = std::shared_ptr<const complex_vector_t>;
+
+        Kernel(const IDFT::pointer& dft, const real_vector_t& wave, size_t capacity = 4);
+
+        /// The length of the kernel waveform.
+        size_t size() const { return m_wave.size(); }
+
+        /// The half spectrum, of length size/2+1, of the kernel
+        /// zero-padded to the given size.
+        spectrum_ptr spectrum(size_t size) const;
+
+        /// The number of spectra currently held.
+        size_t cached() const;
+
+      private:
+        IDFT::pointer m_dft;
+        real_vector_t m_wave;
+        size_t m_capacity;
+        mutable std::mutex m_mutex;
+        // Most recently used first.
+        mutable std::vector<std::pair<size_t, spectrum_ptr>> m_spectra;
+    };
+
+    /// As above but with one or both responses held as a Kernel so
+    /// each call transforms only the waveform.  The transforms are
+    /// padded to the next fft_best_length() so that traces of
+    /// similar length share a cached kernel spectrum.  The result is
+    /// truncated to the same size as returned by the forms above.
+    ///
+    /// The padding makes no difference to convolve() as its result
+    /// already has no periodic aliasing.  It does for replace().
+    /// Dividing by res1 does not give a finite result and so the
+    /// result of replace() is periodic in the transform length.  The
+    /// form above wraps at exactly the returned size while these
+    /// forms wrap at the larger padded length.  The two then agree
+    /// when meas holds res1 convolved with some signal, as the
+    /// division is exact, but may differ for other meas.
+    real_vector_t convolve(const IDFT::pointer& dft,
+                           const real_vector_t& wave,
+                           const Kernel& kernel);
+    real_vector_t replace(const IDFT::pointer& dft,
+                          const real_vector_t& meas,
+                          const real_vector_t& res1,
+                          const Kernel& res2);
+    real_vector_t replace(const IDFT::pointer& dft,
+                          const real_vector_t& meas,
+                          const Kernel& res1,
+                          const real_vector_t& res2);
+    real_vector_t replace(const IDFT::pointer& dft,
+                          const real_vector_t& meas,
+                          const Kernel& res1,
+                          const Kernel& res2);
+
 
 
     // Fixme: possible additions
@@ -1,7 +1,12 @@
 #ifndef WIRECELLAUX_FFTWDFT
 #define WIRECELLAUX_FFTWDFT
 
+#include "WireCellAux/Logger.h"
 #include "WireCellIface/IDFT.h"
+#include "WireCellIface/IConfigurable.h"
+#include "WireCellIface/ITerminal.h"
+
+#include <string>
 
 namespace WireCell::Aux {
 
@@ -11,14 +16,35 @@ namespace WireCell::Aux {
         All instances share a common thread-safe plan cache.  There is
         no benefit to using more than one instance in a process.
 
+        Configuration is optional and sets the FFTW planning rigor
+        and a file of FFTW "wisdom" which is loaded at configure time
+        and saved at finalize time.  The planning rigor is that of
+        the instance and applies to plans made after configuration.
+        Cached plans are known by their rigor so instances with
+        different rigor do not share plans.  FFTW wisdom is kept by
+        FFTW for the whole process.  Planning other than
+        "estimate" is done on scratch arrays and may be slow the
+        first time a transform shape is seen, which the wisdom file
+        amortizes across jobs.
+
         See IDFT.h for important comments.
     */
-    class FftwDFT : public IDFT {
+    class FftwDFT : public Aux::Logger,
+                    public IDFT,
+                    public IConfigurable,
+                    public ITerminal {
       public:
         
         FftwDFT();
         virtual ~FftwDFT();
 
+        // IConfigurable
+        virtual WireCell::Configuration default_configuration() const;
+        virtual void configure(const WireCell::Configuration& cfg);
+
+        // ITerminal
+        virtual void finalize();
+
         // 1d 
 
         virtual 
@@ -44,6 +70,40 @@ namespace WireCell::Aux {
         void inv2d(const complex_t* in, complex_t* out,
                    int nrows, int ncols) const;
 
+        // r2c / c2r
+
+        virtual
+        void fwd1d_r2c(const scalar_t* in, complex_t* out, int size) const;
+        virtual
+        void inv1d_c2r(const complex_t* in, scalar_t* out, int size) const;
+
+        virtual
+        void fwd1b_r2c(const scalar_t* in, complex_t* out,
+                       int nrows, int ncols, int axis) const;
+        virtual
+        void inv1b_c2r(const complex_t* in, scalar_t* out,
+                       int nrows, int ncols, int axis) const;
+
+        virtual
+        void fwd2d_r2c(const scalar_t* in, complex_t* out,
+                       int nrows, int ncols) const;
+        virtual
+        void inv2d_c2r(const complex_t* in, scalar_t* out,
+                       int nrows, int ncols) const;
+
+        // plans
+
+        virtual
+        c2c_plan::pointer plan_fwd1b(int nrows, int ncols, int axis) const;
+        virtual
+        c2c_plan::pointer plan_inv1b(int nrows, int ncols, int axis,
+                                     bool normalize = true) const;
+        virtual
+        r2c_plan::pointer plan_fwd1b_r2c(int nrows, int ncols, int axis) const;
+        virtual
+        c2r_plan::pointer plan_inv1b_c2r(int nrows, int ncols, int axis,
+                                         bool normalize = true) const;
+
         virtual
         void transpose(const scalar_t* in, scalar_t* out,
                        int nrows, int ncols) const;
@@ -51,6 +111,12 @@ namespace WireCell::Aux {
         void transpose(const complex_t* in, complex_t* out,
                        int nrows, int ncols) const;
 
+      private:
+
+        std::string m_wisdom{""};
+
+        // FFTW planning flags.
+        unsigned m_planning;
     };
 }
 
@@ -1,5 +1,5 @@
 #include "WireCellAux/DftTools.h"
-#include "WireCellUtil/Spectrum.h"
+#include "WireCellUtil/FFTBestLength.h"
 #include <algorithm>
 
 #include <iostream>             // debugging
@@ -7,7 +7,6 @@
 
 using namespace WireCell;
 using namespace WireCell::Aux;
-using namespace WireCell::Spectrum; // hermitian_mirror
 
 /*** helpers, both vector/array types ***/
 
@@ -23,10 +22,17 @@ DftTools::complex_vector_t DftTools::fwd(const IDFT::pointer& dft, const DftTool
 
 DftTools::complex_vector_t DftTools::fwd_r2c(const IDFT::pointer& dft, const DftTools::real_vector_t& vec)
 {
-    complex_vector_t cvec(vec.size());
-    std::transform(vec.begin(), vec.end(), cvec.begin(),
-                   [](float re) { return DftTools::complex_t(re,0.0); } );
-    return fwd(dft, cvec);
+    const size_t size = vec.size();
+    complex_vector_t ret(size);
+    if (!size) {
+        return ret;
+    }
+    dft->fwd1d_r2c(vec.data(), ret.data(), size);
+    // Fill above Nyquist from the half spectrum.
+    for (size_t ind = size/2+1; ind < size; ++ind) {
+        ret[ind] = std::conj(ret[size-ind]);
+    }
+    return ret;
 }
 
 DftTools::complex_vector_t DftTools::inv(const IDFT::pointer& dft, const DftTools::complex_vector_t& spec)
@@ -38,14 +44,12 @@ DftTools::complex_vector_t DftTools::inv(const IDFT::pointer& dft, const DftTool
 
 DftTools::real_vector_t DftTools::inv_c2r(const IDFT::pointer& dft, const DftTools::complex_vector_t& spec)
 {
-    // fixme: in future, expand IDFT to have c2r 
-    complex_vector_t symspec(spec.size());
-    hermitian_mirror(spec.begin(), spec.end(), symspec.begin());
-
-    auto cvec = inv(dft, symspec);
-    real_vector_t rvec(cvec.size());
-    std::transform(cvec.begin(), cvec.end(), rvec.begin(),
-                   [](const DftTools::complex_t& c) { return std::real(c); });
+    // c2r reads only the half spectrum up to Nyquist.
+    real_vector_t rvec(spec.size());
+    if (rvec.empty()) {
+        return rvec;
+    }
+    dft->inv1d_c2r(spec.data(), rvec.data(), rvec.size());
     return rvec;
 }
 
@@ -55,7 +59,8 @@ DftTools::real_vector_t DftTools::inv_c2r(const IDFT::pointer& dft, const DftToo
 //
 // - We make an initial copy to get rid of any potential IsRowMajor
 //   optimization/confusion over storage order.  This suffers a copy
-//   but we need to allocate return anyways.
+//   but we need to allocate return anyways.  The forms given an
+//   output array copy into it unless transforming in place.
 //
 // - We then have column-wise storage order but IDFT assumes row-wise
 // - so we reverse (nrows, ncols) and meaning of axis.
@@ -64,8 +69,8 @@ DftTools::complex_array_t DftTools::fwd(const IDFT::pointer& dft,
                               const DftTools::complex_array_t& arr, 
                               int axis)
 {
-    DftTools::complex_array_t ret = arr; 
-    dft->fwd1b(ret.data(), ret.data(), ret.cols(), ret.rows(), !axis);
+    DftTools::complex_array_t ret;
+    fwd(dft, arr, ret, axis);
     return ret;
 }
 
@@ -73,11 +78,29 @@ DftTools::complex_array_t DftTools::inv(const IDFT::pointer& dft,
                               const DftTools::complex_array_t& arr,
                               int axis)
 {
-    DftTools::complex_array_t ret = arr; 
-    dft->inv1b(ret.data(), ret.data(), ret.cols(), ret.rows(), !axis);
+    DftTools::complex_array_t ret;
+    inv(dft, arr, ret, axis);
     return ret;
 }
 
+void DftTools::fwd(const IDFT::pointer& dft, const DftTools::complex_array_t& in,
+                   DftTools::complex_array_t& out, int axis)
+{
+    if (&out != &in) {
+        out = in;
+    }
+    dft->fwd1b(out.data(), out.data(), out.cols(), out.rows(), !axis);
+}
+
+void DftTools::inv(const IDFT::pointer& dft, const DftTools::complex_array_t& in,
+                   DftTools::complex_array_t& out, int axis)
+{
+    if (&out != &in) {
+        out = in;
+    }
+    dft->inv1b(out.data(), out.data(), out.cols(), out.rows(), !axis);
+}
+
 
 /*
   Big fat warning to future me: Passing by reference means the input
@@ -124,47 +147,118 @@ DftTools::complex_array_t DftTools::inv(const IDFT::pointer& dft, const DftTools
 }
 
 
+// The r2c/c2r array forms follow the same column-wise storage notes
+// as fwd()/inv() above.  Along axis=1 the half spectrum is the
+// leading n/2+1 columns which are contiguous and so the output, or
+// input, array is used directly.  Along axis=0 the half spectrum is
+// held in its own column-wise array with n/2+1 rows.
+
 DftTools::complex_array_t DftTools::fwd_r2c(const IDFT::pointer& dft, const DftTools::real_array_t& wave, int axis)
 {
-    complex_array_t cwave = wave.cast<complex_t>();
-    return fwd(dft, cwave, axis);
+    complex_array_t ret;
+    fwd_r2c(dft, wave, ret, axis);
+    return ret;
+}
+
+void DftTools::fwd_r2c(const IDFT::pointer& dft, const DftTools::real_array_t& wave,
+                       DftTools::complex_array_t& ret, int axis)
+{
+    const int nrows = wave.rows(), ncols = wave.cols();
+    ret.resize(nrows, ncols);
+    if (!nrows or !ncols) {
+        return;
+    }
+
+    if (axis == 0) {
+        const int nhalf = nrows/2+1;
+        complex_array_t hspec(nhalf, ncols);
+        dft->fwd1b_r2c(wave.data(), hspec.data(), ncols, nrows, 1);
+        ret.topRows(nhalf) = hspec;
+        for (int irow = nhalf; irow < nrows; ++irow) {
+            ret.row(irow) = hspec.row(nrows-irow).conjugate();
+        }
+        return;
+    }
+
+    const int nhalf = ncols/2+1;
+    dft->fwd1b_r2c(wave.data(), ret.data(), ncols, nrows, 0);
+    for (int icol = nhalf; icol < ncols; ++icol) {
+        ret.col(icol) = ret.col(ncols-icol).conjugate();
+    }
 }
 
 DftTools::real_array_t DftTools::inv_c2r(const IDFT::pointer& dft, const DftTools::complex_array_t& spec, int axis)
 {
-    complex_array_t symspec = hermitian_mirror(spec, axis);
-    complex_array_t cwave = inv(dft, symspec, axis);
-    // Drops the small imaginary that is accrued due to round-off errors.
-    return cwave.real();        
+    real_array_t ret;
+    inv_c2r(dft, spec, ret, axis);
+    return ret;
+}
+
+void DftTools::inv_c2r(const IDFT::pointer& dft, const DftTools::complex_array_t& spec,
+                       DftTools::real_array_t& ret, int axis)
+{
+    const int nrows = spec.rows(), ncols = spec.cols();
+    ret.resize(nrows, ncols);
+    if (!nrows or !ncols) {
+        return;
+    }
+
+    if (axis == 0) {
+        // Copy the half spectrum to contiguous, column-wise storage.
+        complex_array_t hspec = spec.topRows(nrows/2+1);
+        dft->inv1b_c2r(hspec.data(), ret.data(), ncols, nrows, 1);
+        return;
+    }
+    dft->inv1b_c2r(spec.data(), ret.data(), ncols, nrows, 0);
 }
 
 
 
 /*** high level functions ***/
 
+// Return the half spectrum of the wave zero-padded to size.
+static
+DftTools::complex_vector_t padded_spectrum(const IDFT::pointer& dft,
+                                           const DftTools::real_vector_t& wave,
+                                           size_t size)
+{
+    DftTools::real_vector_t padded(size, 0);
+    std::copy(wave.begin(), wave.begin() + std::min(size, wave.size()), padded.begin());
+    DftTools::complex_vector_t spec(size/2+1);
+    dft->fwd1d_r2c(padded.data(), spec.data(), size);
+    return spec;
+}
+
+static
+DftTools::real_vector_t inverse_spectrum(const IDFT::pointer& dft,
+                                         const DftTools::complex_vector_t& spec,
+                                         size_t size)
+{
+    DftTools::real_vector_t ret(size);
+    dft->inv1d_c2r(spec.data(), ret.data(), size);
+    return ret;
+}
+
+// Size of replace() result.
+static
+size_t replace_size(size_t nmeas, size_t nres1, size_t nres2)
+{
+    size_t sizes[3] = {nmeas, nres1, nres2};
+    return sizes[0] + sizes[1] + sizes[2] - *std::min_element(sizes, sizes + 3) - 1;
+}
+
 DftTools::real_vector_t DftTools::convolve(const IDFT::pointer& dft,
                                  const DftTools::real_vector_t& in1,
                                  const DftTools::real_vector_t& in2)
 {
     size_t size = in1.size() + in2.size() - 1;
-    DftTools::complex_vector_t cin1(size,0), cin2(size,0);
-
-    std::transform(in1.begin(), in1.end(), cin1.begin(),
-                   [](float re) { return DftTools::complex_t(re,0.0); } );
-    std::transform(in2.begin(), in2.end(), cin2.begin(),
-                   [](float re) { return DftTools::complex_t(re,0.0); } );
 
-    dft->fwd1d(cin1.data(), cin1.data(), size);
-    dft->fwd1d(cin2.data(), cin2.data(), size);
-
-    for (size_t ind=0; ind<size; ++ind) {
-        cin1[ind] *= cin2[ind];
+    auto spec1 = padded_spectrum(dft, in1, size);
+    auto spec2 = padded_spectrum(dft, in2, size);
+    for (size_t ind=0; ind<spec1.size(); ++ind) {
+        spec1[ind] *= spec2[ind];
     }
-
-    DftTools::real_vector_t ret(size);
-    std::transform(cin1.begin(), cin1.end(), ret.begin(),
-                   [](const complex_t& c) { return std::real(c); });
-    return ret;
+    return inverse_spectrum(dft, spec1, size);
 }
 
 DftTools::real_vector_t DftTools::replace(const IDFT::pointer& dft,
@@ -172,28 +266,116 @@ DftTools::real_vector_t DftTools::replace(const IDFT::pointer& dft,
                                 const DftTools::real_vector_t& res1,
                                 const DftTools::real_vector_t& res2)
 {
-    size_t sizes[3] = {meas.size(), res1.size(), res2.size()};
-    size_t size = sizes[0] + sizes[1] + sizes[2] - *std::min_element(sizes, sizes + 3) - 1;
+    size_t size = replace_size(meas.size(), res1.size(), res2.size());
 
-    DftTools::complex_vector_t cmeas(size,0), cres1(size,0), cres2(size,0);
-    std::transform(meas.begin(), meas.end(), cmeas.begin(),
-                   [](float re) { return DftTools::complex_t(re,0.0); } );
-    std::transform(res1.begin(), res1.end(), cres1.begin(),
-                   [](float re) { return DftTools::complex_t(re,0.0); } );
-    std::transform(res2.begin(), res2.end(), cres2.begin(),
-                   [](float re) { return DftTools::complex_t(re,0.0); } );
+    auto smeas = padded_spectrum(dft, meas, size);
+    auto sres1 = padded_spectrum(dft, res1, size);
+    auto sres2 = padded_spectrum(dft, res2, size);
+    for (size_t ind=0; ind<smeas.size(); ++ind) {
+        smeas[ind] *= sres2[ind]/sres1[ind];
+    }
+    return inverse_spectrum(dft, smeas, size);
+}
 
-    dft->fwd1d(cmeas.data(), cmeas.data(), size);
-    dft->fwd1d(cres1.data(), cres1.data(), size);
-    dft->fwd1d(cres2.data(), cres2.data(), size);
 
-    for (size_t ind=0; ind<size; ++ind) {
-        cmeas[ind] *= res2[ind]/res1[ind];
+DftTools::Kernel::Kernel(const IDFT::pointer& dft, const DftTools::real_vector_t& wave, size_t capacity)
+    : m_dft(dft), m_wave(wave), m_capacity(std::max<size_t>(capacity, 1))
+{
+}
+
+DftTools::Kernel::spectrum_ptr DftTools::Kernel::spectrum(size_t size) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_spectra.begin(), m_spectra.end(),
+                           [&](const auto& one) { return one.first == size; });
+    if (it == m_spectra.end()) {
+        if (m_spectra.size() == m_capacity) {
+            m_spectra.pop_back();
+        }
+        auto spec = std::make_shared<const complex_vector_t>(padded_spectrum(m_dft, m_wave, size));
+        m_spectra.emplace(m_spectra.begin(), size, spec);
+        return spec;
     }
-    DftTools::real_vector_t ret(size);
-    std::transform(cmeas.begin(), cmeas.end(), ret.begin(),
-                   [](const complex_t& c) { return std::real(c); });
+    std::rotate(m_spectra.begin(), it, it + 1);
+    return m_spectra.front().second;
+}
+
+size_t DftTools::Kernel::cached() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_spectra.size();
+}
+
+DftTools::real_vector_t DftTools::convolve(const IDFT::pointer& dft,
+                                 const DftTools::real_vector_t& wave,
+                                 const DftTools::Kernel& kernel)
+{
+    size_t size = wave.size() + kernel.size() - 1;
+    size_t nfft = fft_best_length(size);
 
+    auto spec = padded_spectrum(dft, wave, nfft);
+    auto kspec = kernel.spectrum(nfft);
+    for (size_t ind=0; ind<spec.size(); ++ind) {
+        spec[ind] *= (*kspec)[ind];
+    }
+    auto ret = inverse_spectrum(dft, spec, nfft);
+    ret.resize(size);
     return ret;
 }
 
+DftTools::real_vector_t DftTools::replace(const IDFT::pointer& dft,
+                                const DftTools::real_vector_t& meas,
+                                const DftTools::real_vector_t& res1,
+                                const DftTools::Kernel& res2)
+{
+    size_t size = replace_size(meas.size(), res1.size(), res2.size());
+    size_t nfft = fft_best_length(size);
+
+    auto smeas = padded_spectrum(dft, meas, nfft);
+    auto sres1 = padded_spectrum(dft, res1, nfft);
+    auto sres2 = res2.spectrum(nfft);
+    for (size_t ind=0; ind<smeas.size(); ++ind) {
+        smeas[ind] *= (*sres2)[ind]/sres1[ind];
+    }
+    auto ret = inverse_spectrum(dft, smeas, nfft);
+    ret.resize(size);
+    return ret;
+}
+
+DftTools::real_vector_t DftTools::replace(const IDFT::pointer& dft,
+                                const DftTools::real_vector_t& meas,
+                                const DftTools::Kernel& res1,
+                                const DftTools::real_vector_t& res2)
+{
+    size_t size = replace_size(meas.size(), res1.size(), res2.size());
+    size_t nfft = fft_best_length(size);
+
+    auto smeas = padded_spectrum(dft, meas, nfft);
+    auto sres1 = res1.spectrum(nfft);
+    auto sres2 = padded_spectrum(dft, res2, nfft);
+    for (size_t ind=0; ind<smeas.size(); ++ind) {
+        smeas[ind] *= sres2[ind]/(*sres1)[ind];
+    }
+    auto ret = inverse_spectrum(dft, smeas, nfft);
+    ret.resize(size);
+    return ret;
+}
+
+DftTools::real_vector_t DftTools::replace(const IDFT::pointer& dft,
+                                const DftTools::real_vector_t& meas,
+                                const DftTools::Kernel& res1,
+                                const DftTools::Kernel& res2)
+{
+    size_t size = replace_size(meas.size(), res1.size(), res2.size());
+    size_t nfft = fft_best_length(size);
+
+    auto smeas = padded_spectrum(dft, meas, nfft);
+    auto sres1 = res1.spectrum(nfft);
+    auto sres2 = res2.spectrum(nfft);
+    for (size_t ind=0; ind<smeas.size(); ++ind) {
+        smeas[ind] *= (*sres2)[ind]/(*sres1)[ind];
+    }
+    auto ret = inverse_spectrum(dft, smeas, nfft);
+    ret.resize(size);
+    return ret;
+}
@@ -1,37 +1,70 @@
 #include "WireCellAux/FftwDFT.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Exceptions.h"
 
 #include <fftw3.h>
+#include <unistd.h>             // getpid
+
+#include <algorithm>
+#include <array>
+#include <cstdio>               // std::rename
 #include <mutex>
 #include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
-WIRECELL_FACTORY(FftwDFT, WireCell::Aux::FftwDFT, WireCell::IDFT)
+WIRECELL_FACTORY(FftwDFT, WireCell::Aux::FftwDFT,
+                 WireCell::INamed,
+                 WireCell::IDFT,
+                 WireCell::IConfigurable,
+                 WireCell::ITerminal)
 
 
 using namespace WireCell;
 
-using plan_key_t = int64_t;
 using plan_type = fftwf_plan;
-using plan_map_t = std::unordered_map<plan_key_t, plan_type>;
 using plan_val_t = fftwf_complex;
 
-// Make a key by which a plan is known.  dir should be FFTW_FORWARD or
-// FFTW_BACKWARD and "axis" is -1 for all or in {0,1} for one of 2D.
-// For 1D, use the default axis=-1.
+// The key by which a plan is known.  The "dir" should be
+// FFTW_FORWARD or FFTW_BACKWARD and "axis" is -1 for all or in {0,1}
+// for one of 2D.  The alignments are those of fftwf_alignment_of()
+// as a plan may only be executed on arrays with the alignment it was
+// made for.  The flags are the planning rigor.
 //
 // Imp note: The key is slightly over-specified as we keep one
 // independent cache for each of the six methods.  The "dir" is
 // thus redundant.
+struct plan_key_t {
+    int nrows, ncols, dir, axis;
+    bool inplace;
+    int salign, dalign;
+    unsigned flags;
+
+    bool operator==(const plan_key_t& o) const
+    {
+        return nrows == o.nrows and ncols == o.ncols and dir == o.dir and axis == o.axis
+            and inplace == o.inplace and salign == o.salign and dalign == o.dalign and flags == o.flags;
+    }
+};
+struct plan_key_hash {
+    size_t operator()(const plan_key_t& k) const
+    {
+        size_t h = std::hash<int>()(k.nrows);
+        for (size_t one : {(size_t) k.ncols, (size_t) k.dir, (size_t) k.axis, (size_t) k.inplace,
+                           (size_t) k.salign, (size_t) k.dalign, (size_t) k.flags}) {
+            h ^= one + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+};
+using plan_map_t = std::unordered_map<plan_key_t, plan_type, plan_key_hash>;
+
+// For 1D, use the default axis=-1.
 static
-plan_key_t make_key(const void * src, void * dst, int nrows, int ncols, int dir, int axis=-1)
+plan_key_t make_key(const void * src, void * dst, int nrows, int ncols, int dir, unsigned flags, int axis=-1)
 {
-    ++axis;                     // need three positive values, default is both axis 
-    bool inverse = dir == FFTW_BACKWARD;
-    bool inplace = (dst==src);
-    bool aligned = ( (reinterpret_cast<size_t>(src)&15) | (reinterpret_cast<size_t>(dst)&15) ) == 0;
-    int64_t key = ( ( (((int64_t)nrows) << 32)| (ncols<<5 ) | (axis<<3) | (inverse<<2) | (inplace<<1) | aligned ) << 1 ) + 1;
-    return key;
+    return plan_key_t{nrows, ncols, dir, axis, dst == src,
+                      fftwf_alignment_of((float*)src), fftwf_alignment_of((float*)dst), flags};
 }
 
 // Look up a plan by key or return NULL
@@ -49,15 +82,72 @@ plan_type get_plan(std::shared_mutex& mutex, plan_map_t& plans, plan_key_t key)
 
 // #include <iostream>             // debugging
 
-using planner_function = std::function<plan_type()>;
+// The FFTW planner is not thread safe, unlike plan execution.  This
+// serializes planning across all methods and wisdom I/O.
+static std::mutex g_planner_mutex;
+
+// Make a plan on scratch arrays of the given number of elements,
+// offset in bytes from FFTW's alignment and possibly in-place.  The
+// padding covers the largest SIMD alignment FFTW uses.
+// Caller must hold the planner mutex.
+template<typename ValueType, typename OutValueType>
+plan_type plan_on_scratch(size_t nin, size_t nout, size_t soff, size_t doff, bool inplace, unsigned flags,
+                          std::function<plan_type(ValueType*, OutValueType*, unsigned)> planner)
+{
+    const size_t sbytes = nin*sizeof(ValueType);
+    const size_t dbytes = nout*sizeof(OutValueType);
+
+    const size_t pad = 64;
+    char* sbuf = (char*)fftwf_malloc(std::max(sbytes, dbytes) + pad);
+    char* dbuf = inplace ? sbuf : (char*)fftwf_malloc(dbytes + pad);
+    auto plan = planner(reinterpret_cast<ValueType*>(sbuf + soff),
+                        reinterpret_cast<OutValueType*>(dbuf + doff), flags);
+    if (!inplace) {
+        fftwf_free(dbuf);
+    }
+    fftwf_free(sbuf);
+    return plan;
+}
+
+// Planning with other than FFTW_ESTIMATE overwrites the arrays.  In
+// that case, plan on scratch arrays of the given number of elements
+// which match the alignment and in-place-ness of the user arrays.
+// Execution later uses the new-array interface.
+template<typename ValueType, typename OutValueType>
+plan_type make_plan_safely(ValueType* src, OutValueType* dst, size_t nin, size_t nout, unsigned flags,
+                           std::function<plan_type(ValueType*, OutValueType*, unsigned)> planner)
+{
+    std::lock_guard<std::mutex> lock(g_planner_mutex);
+    if (flags & FFTW_ESTIMATE) {
+        return planner(src, dst, flags);
+    }
+
+    const size_t soff = fftwf_alignment_of((float*)src);
+    const size_t doff = fftwf_alignment_of((float*)dst);
+    const bool inplace = (void*)src == (void*)dst;
+    return plan_on_scratch(nin, nout, soff, doff, inplace, flags, planner);
+}
+
+// Type helper so the output type of doit() may default to the input.
+template<typename ValueType, typename OutValueType>
+struct plan_funcs {
+    using planner = std::function<plan_type(ValueType*, OutValueType*, unsigned)>;
+    using exec = std::function<void(const plan_type, ValueType*, OutValueType*)>;
+};
 
 // This wraps plan lookup, possible plan creation and subsequent plan
-// execution so that we get thread-safe plan caching.
-template<typename ValueType>
+// execution so that we get thread-safe plan caching.  The nin and
+// nout give the number of elements in the src and dst arrays.  The
+// make_plan is called with arrays to plan on and the planning flags
+// of the key.
+//
+// The output value type differs from the input for r2c/c2r and is
+// otherwise taken to be the same.
+template<typename ValueType, typename OutValueType = ValueType>
 void doit(std::shared_mutex& mutex, plan_map_t& plans, plan_key_t key,
-          ValueType* src, ValueType* dst,
-          planner_function make_plan,
-          std::function<void(const plan_type, ValueType*, ValueType*)> exec_plan)
+          ValueType* src, OutValueType* dst, size_t nin, size_t nout,
+          typename plan_funcs<ValueType, OutValueType>::planner make_plan,
+          typename plan_funcs<ValueType, OutValueType>::exec exec_plan)
 {
     auto plan = get_plan(mutex, plans, key);
     if (!plan) {
@@ -66,7 +156,7 @@ void doit(std::shared_mutex& mutex, plan_map_t& plans, plan_key_t key,
         auto it = plans.find(key);
         if (it == plans.end()) {
             //std::cerr << "make plan for " << key << std::endl;
-            plan = make_plan();
+            plan = make_plan_safely(src, dst, nin, nout, key.flags, make_plan);
             plans[key] = plan;
         }
         else {
@@ -92,9 +182,10 @@ void Aux::FftwDFT::fwd1d(const complex_t* in, complex_t* out, int ncols) const
     static const int dir = FFTW_FORWARD;
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
-    auto key = make_key(src, dst, 1, ncols, dir);
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return fftwf_plan_dft_1d(ncols, src, dst, dir, FFTW_ESTIMATE|FFTW_PRESERVE_INPUT);
+    auto key = make_key(src, dst, 1, ncols, dir, m_planning);
+    doit<plan_val_t>(mutex, plans, key, src, dst, ncols, ncols,
+                     [&](auto* s, auto* d, unsigned flags) {
+        return fftwf_plan_dft_1d(ncols, s, d, dir, flags|FFTW_PRESERVE_INPUT);
     }, fftwf_execute_dft);
 }
 void Aux::FftwDFT::inv1d(const complex_t* in, complex_t* out, int ncols) const
@@ -104,10 +195,11 @@ void Aux::FftwDFT::inv1d(const complex_t* in, complex_t* out, int ncols) const
     static const int dir = FFTW_BACKWARD;
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
-    auto key = make_key(src, dst, 1, ncols, dir);
+    auto key = make_key(src, dst, 1, ncols, dir, m_planning);
 
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return fftwf_plan_dft_1d(ncols, src, dst, dir, FFTW_ESTIMATE|FFTW_PRESERVE_INPUT);
+    doit<plan_val_t>(mutex, plans, key, src, dst, ncols, ncols,
+                     [&](auto* s, auto* d, unsigned flags) {
+        return fftwf_plan_dft_1d(ncols, s, d, dir, flags|FFTW_PRESERVE_INPUT);
     }, fftwf_execute_dft);
 
     // Apply 1/n normalization
@@ -118,7 +210,7 @@ void Aux::FftwDFT::inv1d(const complex_t* in, complex_t* out, int ncols) const
 
 
 fftwf_plan plan_1b(fftwf_complex *in, fftwf_complex *out,
-                   int nrows, int ncols, int sign, int axis)
+                   int nrows, int ncols, int sign, int axis, unsigned flags)
 {
     // (r,c) element at in + r*stride + c*dist
 
@@ -135,14 +227,12 @@ fftwf_plan plan_1b(fftwf_complex *in, fftwf_complex *out,
     }
     int *inembed=&n, *onembed=&n;
 
-    unsigned int flags =  FFTW_ESTIMATE|FFTW_PRESERVE_INPUT;
-
     return fftwf_plan_many_dft(rank, &n, howmany,
                                in, inembed,
                                stride, dist,
                                out, onembed,
                                stride, dist,
-                               sign, flags);
+                               sign, flags|FFTW_PRESERVE_INPUT);
 }
 
 
@@ -153,10 +243,11 @@ void Aux::FftwDFT::fwd1b(const complex_t* in, complex_t* out, int nrows, int nco
     static const int dir = FFTW_FORWARD;
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
-    auto key = make_key(src, dst, nrows, ncols, dir, axis);
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning, axis);
 
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return plan_1b(src, dst, nrows, ncols, dir, axis);
+    doit<plan_val_t>(mutex, plans, key, src, dst, nrows*ncols, nrows*ncols,
+                     [&](auto* s, auto* d, unsigned flags) {
+        return plan_1b(s, d, nrows, ncols, dir, axis, flags);
     }, fftwf_execute_dft);
 }
 
@@ -168,10 +259,11 @@ void Aux::FftwDFT::inv1b(const complex_t* in, complex_t* out, int nrows, int nco
     static const int dir = FFTW_BACKWARD;
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
-    auto key = make_key(src, dst, nrows, ncols, dir, axis);
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning, axis);
 
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return plan_1b(src, dst, nrows, ncols, dir, axis);
+    doit<plan_val_t>(mutex, plans, key, src, dst, nrows*ncols, nrows*ncols,
+                     [&](auto* s, auto* d, unsigned flags) {
+        return plan_1b(s, d, nrows, ncols, dir, axis, flags);
     }, fftwf_execute_dft);
 
     // 1/n normalization
@@ -190,9 +282,10 @@ void Aux::FftwDFT::fwd2d(const complex_t* in, complex_t* out, int nrows, int nco
     static const int dir = FFTW_FORWARD;
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
-    auto key = make_key(src, dst, nrows, ncols, dir);
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return fftwf_plan_dft_2d(ncols, nrows, src, dst, dir, FFTW_ESTIMATE|FFTW_PRESERVE_INPUT);
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning);
+    doit<plan_val_t>(mutex, plans, key, src, dst, nrows*ncols, nrows*ncols,
+                     [&](auto* s, auto* d, unsigned flags) {
+        return fftwf_plan_dft_2d(ncols, nrows, s, d, dir, flags|FFTW_PRESERVE_INPUT);
     }, fftwf_execute_dft);
 }
 
@@ -204,9 +297,10 @@ void Aux::FftwDFT::inv2d(const complex_t* in, complex_t* out, int nrows, int nco
     static const int dir = FFTW_BACKWARD;
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
-    auto key = make_key(src, dst, nrows, ncols, dir);
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return fftwf_plan_dft_2d(ncols, nrows, src, dst, dir, FFTW_ESTIMATE|FFTW_PRESERVE_INPUT);
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning);
+    doit<plan_val_t>(mutex, plans, key, src, dst, nrows*ncols, nrows*ncols,
+                     [&](auto* s, auto* d, unsigned flags) {
+        return fftwf_plan_dft_2d(ncols, nrows, s, d, dir, flags|FFTW_PRESERVE_INPUT);
     }, fftwf_execute_dft);
 
     // reverse normalization
@@ -217,11 +311,275 @@ void Aux::FftwDFT::inv2d(const complex_t* in, complex_t* out, int nrows, int nco
 }
 
 
+/*
+ * r2c / c2r
+ *
+ * The half-spectrum holds n/2+1 complex values along the transformed
+ * axis.  FFTW's c2r may destroy its input except for 1D transforms
+ * planned with FFTW_PRESERVE_INPUT so the 2D c2r works on a copy.
+ */
+
+static
+float* rval_cast(const IDFT::scalar_t * p)
+{
+    return const_cast<float*>(p);
+}
+
+void Aux::FftwDFT::fwd1d_r2c(const scalar_t* in, complex_t* out, int ncols) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    static const int dir = FFTW_FORWARD;
+    auto src = rval_cast(in);
+    auto dst = pval_cast(out);
+    auto key = make_key(src, dst, 1, ncols, dir, m_planning);
+    doit<float, plan_val_t>(mutex, plans, key, src, dst, ncols, ncols/2+1,
+                            [&](auto* s, auto* d, unsigned flags) {
+        return fftwf_plan_dft_r2c_1d(ncols, s, d, flags|FFTW_PRESERVE_INPUT);
+    }, fftwf_execute_dft_r2c);
+}
+
+void Aux::FftwDFT::inv1d_c2r(const complex_t* in, scalar_t* out, int ncols) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    static const int dir = FFTW_BACKWARD;
+    auto src = pval_cast(in);
+    auto dst = out;
+    auto key = make_key(src, dst, 1, ncols, dir, m_planning);
+    doit<plan_val_t, float>(mutex, plans, key, src, dst, ncols/2+1, ncols,
+                            [&](auto* s, auto* d, unsigned flags) {
+        return fftwf_plan_dft_c2r_1d(ncols, s, d, flags|FFTW_PRESERVE_INPUT);
+    }, fftwf_execute_dft_c2r);
+
+    for (int ind=0; ind<ncols; ++ind) {
+        out[ind] /= ncols;
+    }
+}
+
+// Return (n, stride, dist) of the real and the half-spectrum arrays
+// for a batch of 1D transforms along the axis of a real (nrows,ncols)
+// array.
+struct batch_layout_t {
+    int n, howmany, rstride, rdist, cstride, cdist;
+};
+static
+batch_layout_t batch_layout(int nrows, int ncols, int axis)
+{
+    if (axis) {                 // along rows
+        return {ncols, nrows, 1, ncols, 1, ncols/2+1};
+    }
+    return {nrows, ncols, ncols, 1, ncols, 1};
+}
+
+// Number of elements in the half spectrum of a batched r2c.
+static
+size_t half_size(int nrows, int ncols, int axis)
+{
+    if (axis) {
+        return nrows*(ncols/2+1);
+    }
+    return (nrows/2+1)*ncols;
+}
+
+static
+plan_type plan_1b_r2c(float* in, fftwf_complex* out, int nrows, int ncols, int axis, unsigned flags)
+{
+    auto bl = batch_layout(nrows, ncols, axis);
+    return fftwf_plan_many_dft_r2c(1, &bl.n, bl.howmany,
+                                   in, NULL, bl.rstride, bl.rdist,
+                                   out, NULL, bl.cstride, bl.cdist,
+                                   flags|FFTW_PRESERVE_INPUT);
+}
+
+static
+plan_type plan_1b_c2r(fftwf_complex* in, float* out, int nrows, int ncols, int axis, unsigned flags)
+{
+    auto bl = batch_layout(nrows, ncols, axis);
+    return fftwf_plan_many_dft_c2r(1, &bl.n, bl.howmany,
+                                   in, NULL, bl.cstride, bl.cdist,
+                                   out, NULL, bl.rstride, bl.rdist,
+                                   flags|FFTW_PRESERVE_INPUT);
+}
+
+void Aux::FftwDFT::fwd1b_r2c(const scalar_t* in, complex_t* out, int nrows, int ncols, int axis) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    static const int dir = FFTW_FORWARD;
+    auto src = rval_cast(in);
+    auto dst = pval_cast(out);
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning, axis);
+    doit<float, plan_val_t>(mutex, plans, key, src, dst, nrows*ncols, half_size(nrows, ncols, axis),
+                            [&](auto* s, auto* d, unsigned flags) {
+        return plan_1b_r2c(s, d, nrows, ncols, axis, flags);
+    }, fftwf_execute_dft_r2c);
+}
+
+void Aux::FftwDFT::inv1b_c2r(const complex_t* in, scalar_t* out, int nrows, int ncols, int axis) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    static const int dir = FFTW_BACKWARD;
+    auto src = pval_cast(in);
+    auto dst = out;
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning, axis);
+    doit<plan_val_t, float>(mutex, plans, key, src, dst, half_size(nrows, ncols, axis), nrows*ncols,
+                            [&](auto* s, auto* d, unsigned flags) {
+        return plan_1b_c2r(s, d, nrows, ncols, axis, flags);
+    }, fftwf_execute_dft_c2r);
+
+    const int norm = axis ? ncols : nrows;
+    const int ntot = ncols*nrows;
+    for (int ind=0; ind<ntot; ++ind) {
+        out[ind] /= norm;
+    }
+}
+
+void Aux::FftwDFT::fwd2d_r2c(const scalar_t* in, complex_t* out, int nrows, int ncols) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    static const int dir = FFTW_FORWARD;
+    auto src = rval_cast(in);
+    auto dst = pval_cast(out);
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning);
+    doit<float, plan_val_t>(mutex, plans, key, src, dst, nrows*ncols, nrows*(ncols/2+1),
+                            [&](auto* s, auto* d, unsigned flags) {
+        return fftwf_plan_dft_r2c_2d(nrows, ncols, s, d, flags|FFTW_PRESERVE_INPUT);
+    }, fftwf_execute_dft_r2c);
+}
+
+void Aux::FftwDFT::inv2d_c2r(const complex_t* in, scalar_t* out, int nrows, int ncols) const
+{
+    static std::shared_mutex mutex;
+    static plan_map_t plans;
+    static const int dir = FFTW_BACKWARD;
+
+    // Multi-dimensional c2r destroys its input.
+    std::vector<complex_t> tmp(in, in + nrows*(ncols/2+1));
+    auto src = pval_cast(tmp.data());
+    auto dst = out;
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning);
+    doit<plan_val_t, float>(mutex, plans, key, src, dst, nrows*(ncols/2+1), nrows*ncols,
+                            [&](auto* s, auto* d, unsigned flags) {
+        return fftwf_plan_dft_c2r_2d(nrows, ncols, s, d, flags|FFTW_DESTROY_INPUT);
+    }, fftwf_execute_dft_c2r);
+
+    const int ntot = ncols*nrows;
+    for (int ind=0; ind<ntot; ++ind) {
+        out[ind] /= ntot;
+    }
+}
+
+
+/*
+ * Plan handles
+ *
+ * A handle holds up to four FFTW plans for the combinations of
+ * in-place or not and of arrays with FFTW's SIMD alignment or not.
+ * Each is made on first use on scratch arrays so no user array is
+ * touched by planning.  Once made, a call costs an alignment check
+ * and an atomic load in addition to the FFTW execution.
+ */
+
+template<typename InType, typename OutType, typename FftwIn, typename FftwOut>
+class FftwPlan : public IDFT::Plan<InType, OutType> {
+  public:
+    using planner_t = std::function<plan_type(FftwIn*, FftwOut*, unsigned)>;
+    using exec_t = void (*)(const plan_type, FftwIn*, FftwOut*);
+
+    // A non-unity scale is applied to the nout output values.  The
+    // flags give the planning rigor.
+    FftwPlan(planner_t planner, exec_t exec, size_t nin, size_t nout, float scale, unsigned flags)
+      : m_planner(planner), m_exec(exec), m_nin(nin), m_nout(nout), m_scale(scale), m_flags(flags) {}
+
+    virtual ~FftwPlan() {
+        std::lock_guard<std::mutex> lock(g_planner_mutex);
+        for (auto plan : m_plans) {
+            if (plan) {
+                fftwf_destroy_plan(plan);
+            }
+        }
+    }
+
+    virtual void operator()(const InType* in, OutType* out) const {
+        auto src = reinterpret_cast<FftwIn*>(const_cast<InType*>(in));
+        auto dst = reinterpret_cast<FftwOut*>(out);
+        const bool inplace = (void*)src == (void*)dst;
+        const bool aligned = fftwf_alignment_of((float*)src) == 0
+            and fftwf_alignment_of((float*)dst) == 0;
+        const int slot = (inplace << 1) | aligned;
+
+        std::call_once(m_once[slot], [&]() {
+            unsigned flags = m_flags;
+            if (!aligned) {
+                flags |= FFTW_UNALIGNED;
+            }
+            std::lock_guard<std::mutex> lock(g_planner_mutex);
+            m_plans[slot] = plan_on_scratch(m_nin, m_nout, 0, 0, inplace, flags, m_planner);
+        });
+        m_exec(m_plans[slot], src, dst);
+
+        if (m_scale == 1.0) {
+            return;
+        }
+        for (size_t ind=0; ind<m_nout; ++ind) {
+            out[ind] *= m_scale;
+        }
+    }
+
+  private:
+    planner_t m_planner;
+    exec_t m_exec;
+    size_t m_nin, m_nout;
+    float m_scale;
+    unsigned m_flags;
+    mutable std::array<std::once_flag, 4> m_once;
+    mutable std::array<plan_type, 4> m_plans{};
+};
+
+IDFT::c2c_plan::pointer Aux::FftwDFT::plan_fwd1b(int nrows, int ncols, int axis) const
+{
+    const size_t size = nrows*ncols;
+    return std::make_shared<FftwPlan<complex_t, complex_t, plan_val_t, plan_val_t>>(
+        [=](plan_val_t* s, plan_val_t* d, unsigned flags) {
+            return plan_1b(s, d, nrows, ncols, FFTW_FORWARD, axis, flags);
+        }, fftwf_execute_dft, size, size, 1.0, m_planning);
+}
+
+IDFT::c2c_plan::pointer Aux::FftwDFT::plan_inv1b(int nrows, int ncols, int axis, bool normalize) const
+{
+    const size_t size = nrows*ncols;
+    const float scale = normalize ? 1.0/(axis ? ncols : nrows) : 1.0;
+    return std::make_shared<FftwPlan<complex_t, complex_t, plan_val_t, plan_val_t>>(
+        [=](plan_val_t* s, plan_val_t* d, unsigned flags) {
+            return plan_1b(s, d, nrows, ncols, FFTW_BACKWARD, axis, flags);
+        }, fftwf_execute_dft, size, size, scale, m_planning);
+}
+
+IDFT::r2c_plan::pointer Aux::FftwDFT::plan_fwd1b_r2c(int nrows, int ncols, int axis) const
+{
+    return std::make_shared<FftwPlan<scalar_t, complex_t, float, plan_val_t>>(
+        [=](float* s, plan_val_t* d, unsigned flags) {
+            return plan_1b_r2c(s, d, nrows, ncols, axis, flags);
+        }, fftwf_execute_dft_r2c, nrows*ncols, half_size(nrows, ncols, axis), 1.0, m_planning);
+}
+
+IDFT::c2r_plan::pointer Aux::FftwDFT::plan_inv1b_c2r(int nrows, int ncols, int axis, bool normalize) const
+{
+    const float scale = normalize ? 1.0/(axis ? ncols : nrows) : 1.0;
+    return std::make_shared<FftwPlan<complex_t, scalar_t, plan_val_t, float>>(
+        [=](plan_val_t* s, float* d, unsigned flags) {
+            return plan_1b_c2r(s, d, nrows, ncols, axis, flags);
+        }, fftwf_execute_dft_c2r, half_size(nrows, ncols, axis), nrows*ncols, scale, m_planning);
+}
+
+
 // based on example from fftw3 faq
 static
-plan_type transpose_plan_complex(plan_val_t *in, plan_val_t *out, int rows, int cols)
+plan_type transpose_plan_complex(plan_val_t *in, plan_val_t *out, int rows, int cols, unsigned flags)
 {
-    const unsigned flags = FFTW_ESTIMATE; /* other flags are possible */
     fftw_iodim howmany_dims[2];
 
     howmany_dims[0].n  = rows;
@@ -244,16 +602,16 @@ void Aux::FftwDFT::transpose(const complex_t* in, complex_t* out,
     static const int dir = 0;
     auto src = pval_cast(in);
     auto dst = pval_cast(out);
-    auto key = make_key(src, dst, nrows, ncols, dir);
-    doit<plan_val_t>(mutex, plans, key, src, dst, [&]( ) {
-        return transpose_plan_complex(src, dst, nrows, ncols);
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning);
+    doit<plan_val_t>(mutex, plans, key, src, dst, nrows*ncols, nrows*ncols,
+                     [&](auto* s, auto* d, unsigned flags) {
+        return transpose_plan_complex(s, d, nrows, ncols, flags);
     }, fftwf_execute_dft);
 }
 
 static
-plan_type transpose_plan_real(float *in, float *out, int rows, int cols)
+plan_type transpose_plan_real(float *in, float *out, int rows, int cols, unsigned flags)
 {
-    const unsigned flags = FFTW_ESTIMATE; /* other flags are possible */
     fftw_iodim howmany_dims[2];
 
     howmany_dims[0].n  = rows;
@@ -276,16 +634,83 @@ void Aux::FftwDFT::transpose(const scalar_t* in, scalar_t* out,
     static const int dir = 0;
     auto src = const_cast<scalar_t*>(in);
     auto dst = out;
-    auto key = make_key(src, dst, nrows, ncols, dir);
-    doit<float>(mutex, plans, key, src, dst, [&]( ) {
-        return transpose_plan_real(src, dst, nrows, ncols);
+    auto key = make_key(src, dst, nrows, ncols, dir, m_planning);
+    doit<float>(mutex, plans, key, src, dst, nrows*ncols, nrows*ncols,
+                [&](auto* s, auto* d, unsigned flags) {
+        return transpose_plan_real(s, d, nrows, ncols, flags);
     }, fftwf_execute_r2r);
 }
 
 Aux::FftwDFT::FftwDFT()
+  : Aux::Logger("FftwDFT", "aux")
+  , m_planning(FFTW_ESTIMATE)
 {
 }
 Aux::FftwDFT::~FftwDFT()
 {
 }
 
+WireCell::Configuration Aux::FftwDFT::default_configuration() const
+{
+    Configuration cfg;
+    // FFTW planning rigor, one of "estimate", "measure" or "patient".
+    cfg["planning"] = "estimate";
+    // If non-empty, name a file of FFTW wisdom to load at configure
+    // time, if it exists, and to save at finalize time.
+    cfg["wisdom"] = m_wisdom;
+    return cfg;
+}
+
+void Aux::FftwDFT::configure(const WireCell::Configuration& cfg)
+{
+    const std::string planning = get<std::string>(cfg, "planning", "estimate");
+    if (planning == "estimate") {
+        m_planning = FFTW_ESTIMATE;
+    }
+    else if (planning == "measure") {
+        m_planning = FFTW_MEASURE;
+    }
+    else if (planning == "patient") {
+        m_planning = FFTW_PATIENT;
+    }
+    else {
+        raise<ValueError>("FftwDFT: unknown planning \"%s\"", planning);
+    }
+
+    m_wisdom = get<std::string>(cfg, "wisdom", m_wisdom);
+    if (m_wisdom.empty()) {
+        log->debug("planning: {}", planning);
+        return;
+    }
+
+    int ok = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_planner_mutex);
+        ok = fftwf_import_wisdom_from_filename(m_wisdom.c_str());
+    }
+    log->debug("planning: {}, wisdom {}: {}", planning,
+               ok ? "loaded from" : "not loaded from", m_wisdom);
+}
+
+void Aux::FftwDFT::finalize()
+{
+    if (m_wisdom.empty()) {
+        return;
+    }
+
+    // Write then rename so concurrent jobs sharing the file never
+    // read a partial one.
+    const std::string tmp = m_wisdom + ".tmp." + std::to_string(getpid());
+    int ok = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_planner_mutex);
+        ok = fftwf_export_wisdom_to_filename(tmp.c_str());
+    }
+    if (!ok or std::rename(tmp.c_str(), m_wisdom.c_str())) {
+        std::remove(tmp.c_str());
+        log->warn("failed to save wisdom to {}", m_wisdom);
+        return;
+    }
+    log->debug("saved wisdom to {}", m_wisdom);
+}
+
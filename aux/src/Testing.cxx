@@ -15,7 +15,7 @@ WireCell::IDFT::pointer Testing::get_dft()
     // load_plugins({"WireCellAux"});
     // we are in Aux, so no need to load!
 
-    return Factory::lookup<IDFT>("FftwDFT"); // not configurable
+    return Factory::lookup<IDFT>("FftwDFT"); // defaults need no configure
 }
 
 
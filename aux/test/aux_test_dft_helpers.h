@@ -103,6 +103,7 @@ namespace WireCell::Aux::Test {
         std::string cfg_name{""};
         std::string output{""};
         std::vector<std::string> positional;
+        std::vector<int> nthreads{1};
         Configuration cfg;
     };        
 
@@ -118,6 +119,7 @@ namespace WireCell::Aux::Test {
             ("plugin,p", po::value< std::string >(), "plugin holding a IDFT")
             ("typename,t", po::value< std::string >(), "type[:name] of the IDFT to use")
             ("config,c",  po::value< std::string >(), "configuration file")
+            ("threads,j", po::value< std::vector<int> >()->multitoken(), "number(s) of threads to use")
             ("args",  po::value< std::vector<std::string> >(), "positional arguments")
             ;
         po::positional_options_description pos_desc;
@@ -145,6 +147,15 @@ namespace WireCell::Aux::Test {
         if (opts.count("typename")) {
             args.tn = opts["typename"].as< std::string> ();
         }
+        if (opts.count("threads")) {
+            args.nthreads = opts["threads"].as< std::vector<int> >();
+            for (int nthread : args.nthreads) {
+                if (nthread < 1) {
+                    std::cerr << "number of threads must be at least 1, got " << nthread << std::endl;
+                    return 1;
+                }
+            }
+        }
         if (opts.count("args")) {
             args.positional = opts["args"].as< std::vector<std::string> >();
         }
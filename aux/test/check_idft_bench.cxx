@@ -1,25 +1,40 @@
 /**
-   A simple benchmark of IDFT for payloads relevant to WCT
+   A benchmark of IDFT for payloads relevant to WCT.
+
+   Results are written as JSON, one object per timed job.  See
+   check_idft_bench.sh for running over all known IDFT backends.
  */
 
 #include "aux_test_dft_helpers.h"
 
+#include "WireCellUtil/FFTBestLength.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 using namespace WireCell;
 using namespace WireCell::Aux::Test;
 
 using benchmark_function = std::function<void()>;
-using complex_t = std::complex<float>;
+using complex_t = IDFT::complex_t;
+using scalar_t = IDFT::scalar_t;
 
 
 // benchmarks span outer product of:
 // - in-place / out-place
+// - complex and r2c/c2r, by method and by plan
 // - 1d, 1b, 2d
-// - sizes: perfect powers of 2 and with larger prime factors
+// - sizes: perfect powers of 2, with larger prime factors and those of
+//   detector frames and responses
+// - number of threads concurrently calling the IDFT
 // - use repitition numbers to keep each test roughly same runtime
 
-using transform_function = std::function<void(const complex_t* in, complex_t* out)>;
+template<typename InType, typename OutType>
+using transform_function = std::function<void(const InType* in, OutType* out)>;
 
-void ignore_exception(const complex_t* in, complex_t* out, transform_function func)
+template<typename InType, typename OutType>
+void ignore_exception(const InType* in, OutType* out, transform_function<InType,OutType> func)
 {
     try {
         func(in, out);
@@ -29,39 +44,201 @@ void ignore_exception(const complex_t* in, complex_t* out, transform_function fu
     }
 }
 
+// Run ntimes in each of nthreads with each thread using its own
+// arrays and time it with the stopwatch.  The arrays are allocated and
+// the threads started before timing so that only the transforms are
+// timed.
+template<typename InType, typename OutType>
+void run_threads(Stopwatch& sw, const object_t& data,
+                 int nthreads, int ntimes, size_t nin, size_t nout, bool inplace,
+                 transform_function<InType,OutType> func)
+{
+    const size_t nalloc = std::max(nin, nout*sizeof(OutType)/sizeof(InType));
+    std::vector<std::vector<InType>> ins(nthreads, std::vector<InType>(nalloc));
+    std::vector<std::vector<OutType>> outs(nthreads, std::vector<OutType>(inplace ? 0 : nout));
+    auto job = [&](int ind) {
+        const InType* iptr = ins[ind].data();
+        OutType* optr = inplace ? reinterpret_cast<OutType*>(ins[ind].data()) : outs[ind].data();
+        for (int count=0; count<ntimes; ++count) {
+            ignore_exception(iptr, optr, func);
+        }
+    };
+    if (nthreads == 1) {
+        sw([&](){ job(0); }, data);
+        return;
+    }
+
+    // Workers wait for "go" and then count themselves done.
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool go = false;
+    int ndone = 0;
+    std::vector<std::thread> workers;
+    for (int ind=0; ind<nthreads; ++ind) {
+        workers.emplace_back([&, ind]() {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&]() { return go; });
+            }
+            job(ind);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++ndone;
+            }
+            cond.notify_all();
+        });
+    }
+    sw([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        go = true;
+        cond.notify_all();
+        cond.wait(lock, [&]() { return ndone == nthreads; });
+    }, data);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
 const int nominal = 100'000'000;
-void doit(Stopwatch& sw, const std::string& name, int nrows, int ncols, transform_function func)
+
+// Time one transform.  The nin and nout give the number of input and
+// output elements.  In-place is skipped if the transform is real.
+template<typename InType, typename OutType>
+void doit(Stopwatch& sw, const std::vector<int>& nthreads,
+          const std::string& name, int nrows, int ncols, size_t nin, size_t nout,
+          transform_function<InType,OutType> func)
 {
     const int size = nrows*ncols;
     const int ntimes = std::max(1, nominal / size);
     std::cerr << name << ": (" << nrows << "," << ncols << ") x "<<ntimes<<"\n";
 
-    std::vector<complex_t> in(size), out(size);
+    std::vector<bool> inplaces{false};
+    if (std::is_same<InType, OutType>::value) {
+        inplaces.push_back(true);
+    }
+    for (bool inplace : inplaces) {
+        // The first call may include planning.
+        run_threads(sw, {
+                {"nrows",nrows}, {"ncols",ncols}, {"func",name}, {"ntimes",1},
+                {"first",true}, {"in-place",inplace}, {"nthreads",1},
+            }, 1, 1, nin, nout, inplace, func);
 
-    sw([&](){ignore_exception(in.data(), in.data(), func);}, {
-            {"nrows",nrows}, {"ncols",ncols}, {"func",name}, {"ntimes",1}, {"first",true}, {"in-place",true},
-        });
+        for (int nthread : nthreads) {
+            const int nper = std::max(1, ntimes / nthread);
+            run_threads(sw, {
+                    {"nrows",nrows}, {"ncols",ncols}, {"func",name}, {"ntimes",nper*nthread},
+                    {"first",false}, {"in-place",inplace}, {"nthreads",nthread},
+                }, nthread, nper, nin, nout, inplace, func);
+        }
+    }
+}
 
-    sw([&](){
-        for (int count=0; count<ntimes+1; ++count) {
-            ignore_exception(in.data(), in.data(), func);
-        }}, {
-            {"nrows",nrows}, {"ncols",ncols}, {"func",name}, {"ntimes",ntimes}, {"first",false}, {"in-place",true},
-        });
+// Complex to complex of same size.
+void doit_c2c(Stopwatch& sw, const std::vector<int>& nthreads,
+              const std::string& name, int nrows, int ncols,
+              transform_function<complex_t,complex_t> func)
+{
+    const size_t size = nrows*ncols;
+    doit<complex_t,complex_t>(sw, nthreads, name, nrows, ncols, size, size, func);
+}
+
+// Number of half-spectrum elements.
+size_t half_size(int nrows, int ncols, int axis)
+{
+    if (axis) {
+        return nrows*(ncols/2+1);
+    }
+    return (nrows/2+1)*ncols;
+}
+
+void bench_1d(Stopwatch& sw, const std::vector<int>& nthreads, IDFT::pointer idft, int size)
+{
+    const size_t nhalf = size/2+1;
+    doit_c2c(sw, nthreads, "fwd1d", 1, size, [&](const complex_t* in, complex_t* out) {
+        idft->fwd1d(in, out, size);
+    });
+    doit_c2c(sw, nthreads, "inv1d", 1, size, [&](const complex_t* in, complex_t* out) {
+        idft->inv1d(in, out, size);
+    });
+    doit<scalar_t,complex_t>(sw, nthreads, "fwd1d_r2c", 1, size, size, nhalf,
+                             [&](const scalar_t* in, complex_t* out) {
+                                 idft->fwd1d_r2c(in, out, size);
+                             });
+    doit<complex_t,scalar_t>(sw, nthreads, "inv1d_c2r", 1, size, nhalf, size,
+                             [&](const complex_t* in, scalar_t* out) {
+                                 idft->inv1d_c2r(in, out, size);
+                             });
 
-    sw([&](){ignore_exception(in.data(), out.data(), func);}, {
-            {"nrows",nrows}, {"ncols",ncols}, {"func",name}, {"ntimes",1}, {"first",true}, {"in-place",false},
+    auto fwd = idft->plan_fwd1b(1, size, 1);
+    doit_c2c(sw, nthreads, "fwd1d_plan", 1, size, [&](const complex_t* in, complex_t* out) {
+        (*fwd)(in, out);
+    });
+    auto inv = idft->plan_inv1b(1, size, 1);
+    doit_c2c(sw, nthreads, "inv1d_plan", 1, size, [&](const complex_t* in, complex_t* out) {
+        (*inv)(in, out);
+    });
+    auto r2c = idft->plan_fwd1b_r2c(1, size, 1);
+    doit<scalar_t,complex_t>(sw, nthreads, "fwd1d_r2c_plan", 1, size, size, nhalf,
+                             [&](const scalar_t* in, complex_t* out) {
+                                 (*r2c)(in, out);
+                             });
+    auto c2r = idft->plan_inv1b_c2r(1, size, 1);
+    doit<complex_t,scalar_t>(sw, nthreads, "inv1d_c2r_plan", 1, size, nhalf, size,
+                             [&](const complex_t* in, scalar_t* out) {
+                                 (*c2r)(in, out);
+                             });
+}
+
+void bench_2d(Stopwatch& sw, const std::vector<int>& nthreads, IDFT::pointer idft, int nrows, int ncols)
+{
+    const size_t size = nrows*ncols;
+
+    doit_c2c(sw, nthreads, "fwd2d", nrows, ncols, [&](const complex_t* in, complex_t* out) {
+        idft->fwd2d(in, out, nrows, ncols);
+    });
+    doit_c2c(sw, nthreads, "inv2d", nrows, ncols, [&](const complex_t* in, complex_t* out) {
+        idft->inv2d(in, out, nrows, ncols);
+    });
+    doit<scalar_t,complex_t>(sw, nthreads, "fwd2d_r2c", nrows, ncols, size, half_size(nrows, ncols, 1),
+                             [&](const scalar_t* in, complex_t* out) {
+                                 idft->fwd2d_r2c(in, out, nrows, ncols);
+                             });
+    doit<complex_t,scalar_t>(sw, nthreads, "inv2d_c2r", nrows, ncols, half_size(nrows, ncols, 1), size,
+                             [&](const complex_t* in, scalar_t* out) {
+                                 idft->inv2d_c2r(in, out, nrows, ncols);
+                             });
+
+    for (int axis : {0, 1}) {
+        const std::string sax = std::to_string(axis);
+        const size_t nhalf = half_size(nrows, ncols, axis);
+
+        doit_c2c(sw, nthreads, "fwd1b"+sax, nrows, ncols, [&](const complex_t* in, complex_t* out) {
+            idft->fwd1b(in, out, nrows, ncols, axis);
+        });
+        doit_c2c(sw, nthreads, "inv1b"+sax, nrows, ncols, [&](const complex_t* in, complex_t* out) {
+            idft->inv1b(in, out, nrows, ncols, axis);
         });
+        doit<scalar_t,complex_t>(sw, nthreads, "fwd1b"+sax+"_r2c", nrows, ncols, size, nhalf,
+                                 [&](const scalar_t* in, complex_t* out) {
+                                     idft->fwd1b_r2c(in, out, nrows, ncols, axis);
+                                 });
+        doit<complex_t,scalar_t>(sw, nthreads, "inv1b"+sax+"_c2r", nrows, ncols, nhalf, size,
+                                 [&](const complex_t* in, scalar_t* out) {
+                                     idft->inv1b_c2r(in, out, nrows, ncols, axis);
+                                 });
 
-    sw([&](){
-        for (int count=0; count<ntimes+1; ++count) {
-            ignore_exception(in.data(), out.data(), func);
-        }}, {
-            {"nrows",nrows}, {"ncols",ncols}, {"func",name}, {"ntimes",ntimes}, {"first",false}, {"in-place",false},
+        auto fwd = idft->plan_fwd1b(nrows, ncols, axis);
+        doit_c2c(sw, nthreads, "fwd1b"+sax+"_plan", nrows, ncols, [&](const complex_t* in, complex_t* out) {
+            (*fwd)(in, out);
         });
+        auto r2c = idft->plan_fwd1b_r2c(nrows, ncols, axis);
+        doit<scalar_t,complex_t>(sw, nthreads, "fwd1b"+sax+"_r2c_plan", nrows, ncols, size, nhalf,
+                                 [&](const scalar_t* in, complex_t* out) {
+                                     (*r2c)(in, out);
+                                 });
+    }
 }
 
-
 int main(int argc, char* argv[])
 {
     DftArgs args;
@@ -71,32 +248,36 @@ int main(int argc, char* argv[])
         std::cerr << "need output file" << std::endl;
         return 0;
     }
-    
+
     auto idft = make_dft(args.tn, args.pi, args.cfg);
 
     Stopwatch sw({
             {"typename",args.tn},
             {"plugin",args.pi},
-            {"config", object_t::parse(Persist::dumps(args.cfg))}, 
-            {"config_file",args.cfg_name}});
+            {"config", object_t::parse(Persist::dumps(args.cfg))},
+            {"config_file",args.cfg_name},
+            {"nthreads",args.nthreads},
+            {"hardware_concurrency",std::thread::hardware_concurrency()}});
 
     auto fname = args.output;
     if (fname.empty()) {
         fname = "/dev/stdout";
     }
     std::cerr << "writing to: " << fname << std::endl;
-    
+
     std::vector<int> oned_sizes{128, 256, 500, 512, 1000, 1024, 2000,
         2048, 3000, 4096, 6000, 8192, 9375, 9503, 9592, 9595, 9600,
         10000, 16384};
-    for (auto size : oned_sizes) {
-        doit(sw, "fwd1d", 1, size, [&](const complex_t* in, complex_t* out) {
-            idft->fwd1d(in, out, size);
-        });
 
-        doit(sw, "inv1d", 1, size, [&](const complex_t* in, complex_t* out) {
-            idft->inv1d(in, out, size);
-        });
+    // Lengths used by PlaneImpactResponse for its default 100us short
+    // and 10000 tick long responses at 0.5us ticks.
+    oned_sizes.push_back(fft_best_length(200));
+    oned_sizes.push_back(fft_best_length(10000));
+    std::sort(oned_sizes.begin(), oned_sizes.end());
+    oned_sizes.erase(std::unique(oned_sizes.begin(), oned_sizes.end()), oned_sizes.end());
+
+    for (auto size : oned_sizes) {
+        bench_1d(sw, args.nthreads, idft, size);
     }
 
     // channel count from some detectors plus powers of 2
@@ -105,30 +286,14 @@ int main(int argc, char* argv[])
         {2400, 9595}, {3456, 9595}, // uboone u/v daq size
         {1024, 1024}, {2048, 2048}, {4096, 4096}, // perfect powers of 2
     };
+    // As padded by OmnibusSigProc.
+    for (auto two : std::vector<std::pair<int,int>>{{800,6000}, {960,6000}, {2400,9592}, {3456,9592}}) {
+        twod_sizes.emplace_back(fft_best_length(two.first), fft_best_length(two.second));
+    }
     for (const auto& two: twod_sizes) {
-        const size_t nrows = two.first;
-        const size_t ncols = two.second;
-        doit(sw, "fwd2d", nrows, ncols, [&](const complex_t* in, complex_t* out) {
-            idft->fwd2d(in, out, nrows, ncols);
-        });
-        doit(sw, "inv2d", nrows, ncols, [&](const complex_t* in, complex_t* out) {
-            idft->inv2d(in, out, nrows, ncols);
-        });
-
-        doit(sw, "fwd1b0", nrows, ncols, [&](const complex_t* in, complex_t* out) {
-            idft->fwd1b(in, out, nrows, ncols, 0);
-        });
-        doit(sw, "inv1b0", nrows, ncols, [&](const complex_t* in, complex_t* out) {
-            idft->inv1b(in, out, nrows, ncols, 0);
-        });
-        doit(sw, "fwd1b1", nrows, ncols, [&](const complex_t* in, complex_t* out) {
-            idft->fwd1b(in, out, nrows, ncols, 1);
-        });
-        doit(sw, "inv1b1", nrows, ncols, [&](const complex_t* in, complex_t* out) {
-            idft->inv1b(in, out, nrows, ncols, 1);
-        });
+        bench_2d(sw, args.nthreads, idft, two.first, two.second);
     }
-    
+
     sw.save(fname);
 
     return 0;
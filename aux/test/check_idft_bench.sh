@@ -24,6 +24,9 @@ wirecell-aux run-idft-bench -o idft-bench-fftw-cpu.json $cib
 wirecell-aux run-idft-bench -o idft-bench-torch-cpu.json -p WireCellPytorch -t TorchDFT $cib
 wirecell-aux run-idft-bench -o idft-bench-torch-gpu.json -p WireCellPytorch -t TorchDFT -c $torchcfg $cib
 
+# Concurrent callers, the JSON records "nthreads" for each job.
+$cib -o idft-bench-fftw-cpu-threads.json -j 1 2 4 8
+
 wirecell-aux plot-idft-bench -o idft-bench.pdf \
              idft-bench-fftw-cpu.json  \
              idft-bench-torch-cpu.json  \
@@ -4,9 +4,11 @@
 #include "WireCellAux/FftwDFT.h"
 #include "WireCellUtil/Waveform.h"
 #include "WireCellUtil/Spectrum.h"
+#include "WireCellUtil/FFTBestLength.h"
 
 #include <iostream>
 #include <memory>
+#include <cmath>
 
 #include <complex>
 using namespace std::literals;
@@ -274,15 +276,7 @@ void test_1d_c2r_impulse(IDFT::pointer dft, size_t size = 64)
     auto spec = fwd_r2c(dft, rimp);
     spec[3*size/4] = 42;
     auto wave = inv_c2r(dft, spec);
-    for (size_t ind=0; ind<size; ++ind) {
-        // std::cerr << ind << " " << rimp[ind] << " " << wave[ind] << " " << spec[ind] << "\n";
-        if (ind) {
-            assert(wave[ind] == 0.0);
-        }
-        else {
-            assert(wave[ind] == 1.0);
-        }
-    }        
+    assert_impulse_at_index(wave);
 }
 void test_2d_c2r_impulse(IDFT::pointer dft, int axis, int nrows=8, int ncols=4)
 {
@@ -305,12 +299,182 @@ void test_2d_c2r_impulse(IDFT::pointer dft, int axis, int nrows=8, int ncols=4)
     assert_impulse_at_index(wave.data(), size);    
 }
 
+// The forms writing to an output array match those returning one,
+// also when reusing the output or transforming in place.
+void test_2d_output(IDFT::pointer dft, int axis, int nrows=8, int ncols=6)
+{
+    std::cerr << "2d output axis=" << axis << " shape=(" << nrows << ", " << ncols <<")\n";
+
+    FA r = FA::Random(nrows, ncols);
+    auto want_spec = fwd_r2c(dft, r, axis);
+    auto want_wave = inv_c2r(dft, want_spec, axis);
+    auto want_fwd = fwd(dft, want_spec, axis);
+    auto want_inv = inv(dft, want_fwd, axis);
+
+    CA spec;
+    FA wave;
+    for (int count=0; count<2; ++count) {
+        fwd_r2c(dft, r, spec, axis);
+        assert_small((spec - want_spec).abs().maxCoeff(), 1e-5);
+        const complex_t* data = spec.data();
+
+        inv_c2r(dft, spec, wave, axis);
+        assert_small((wave - want_wave).abs().maxCoeff(), 1e-5);
+
+        fwd(dft, spec, spec, axis);
+        assert(spec.data() == data);
+        assert_small((spec - want_fwd).abs().maxCoeff(), 1e-4);
+
+        inv(dft, spec, spec, axis);
+        assert(spec.data() == data);
+        assert_small((spec - want_inv).abs().maxCoeff(), 1e-4);
+    }
+}
+
+void test_convolve(IDFT::pointer dft)
+{
+    std::cerr << "convolve\n";
+    RV in1{1, 2, 3, 0, -1}, in2{0.5, -0.5, 0.25};
+    auto got = convolve(dft, in1, in2);
+    assert(got.size() == in1.size() + in2.size() - 1);
+    for (size_t ind=0; ind<got.size(); ++ind) {
+        real_t want = 0;
+        for (size_t i1=0; i1<in1.size(); ++i1) {
+            if (ind >= i1 and ind-i1 < in2.size()) {
+                want += in1[i1]*in2[ind-i1];
+            }
+        }
+        assert_small(std::abs(got[ind] - want), 1e-5);
+    }
+
+    // Replacing a response by itself is an identity.
+    auto same = replace(dft, in1, in2, in2);
+    for (size_t ind=0; ind<same.size(); ++ind) {
+        real_t want = ind < in1.size() ? in1[ind] : 0;
+        assert_small(std::abs(same[ind] - want), 1e-5);
+    }
+
+    // Cached kernel spectra give the same, also when reused.
+    Kernel kern(dft, in2);
+    for (int count=0; count<2; ++count) {
+        auto kgot = convolve(dft, in1, kern);
+        assert(kgot.size() == got.size());
+        for (size_t ind=0; ind<got.size(); ++ind) {
+            assert_small(std::abs(kgot[ind] - got[ind]), 1e-5);
+        }
+        auto ksame = replace(dft, in1, kern, kern);
+        auto msame = replace(dft, in1, in2, kern);
+        for (size_t ind=0; ind<same.size(); ++ind) {
+            assert_small(std::abs(ksame[ind] - same[ind]), 1e-5);
+            assert_small(std::abs(msame[ind] - same[ind]), 1e-5);
+        }
+    }
+}
+
+// Replacing a known response A by B in x*A must give x*B.  The
+// reverse order would give x*A*A/B.
+void test_replace_order(IDFT::pointer dft)
+{
+    std::cerr << "replace order\n";
+    RV x{1, 2, 3, 0, -1}, A{1, 0.3}, B{0.5, -0.5, 0.25};
+    auto meas = convolve(dft, x, A);
+    auto want = convolve(dft, x, B);
+
+    auto check = [&](const RV& got) {
+        assert(got.size() >= want.size());
+        for (size_t ind=0; ind<got.size(); ++ind) {
+            real_t w = ind < want.size() ? want[ind] : 0;
+            assert_small(std::abs(got[ind] - w), 1e-4);
+        }
+    };
+    check(replace(dft, meas, A, B));
+
+    // Same for each form taking cached kernels.
+    Kernel kA(dft, A), kB(dft, B);
+    for (int count=0; count<2; ++count) {
+        check(replace(dft, meas, A, kB));
+        check(replace(dft, meas, kA, B));
+        check(replace(dft, meas, kA, kB));
+    }
+}
+
+// On a length that is not a best length the Kernel forms pad further
+// than the plain forms.  That leaves convolve() unchanged and also
+// replace() when meas holds res1.  Otherwise the plain replace() wraps
+// around at its returned size and the Kernel form does not.
+void test_kernel_padding(IDFT::pointer dft)
+{
+    std::cerr << "kernel padding\n";
+    RV x(48, 0), A(50, 0), B{0.5, -0.5, 0.25};
+    for (size_t ind=0; ind<x.size(); ++ind) {
+        x[ind] = std::sin(0.7*ind);
+    }
+    for (size_t ind=0; ind<A.size(); ++ind) {
+        A[ind] = std::exp(-0.03*ind);
+    }
+    Kernel kA(dft, A), kB(dft, B);
+
+    auto meas = convolve(dft, x, A);
+    auto kmeas = convolve(dft, x, kA);
+    assert(fft_best_length(meas.size()) != meas.size());
+    assert(kmeas.size() == meas.size());
+    for (size_t ind=0; ind<meas.size(); ++ind) {
+        assert_small(std::abs(kmeas[ind] - meas[ind]), 1e-4);
+    }
+
+    auto got = replace(dft, meas, A, B);
+    auto kgot = replace(dft, meas, kA, kB);
+    assert(fft_best_length(got.size()) != got.size());
+    assert(kgot.size() == got.size());
+    for (size_t ind=0; ind<got.size(); ++ind) {
+        assert_small(std::abs(kgot[ind] - got[ind]), 1e-4);
+    }
+
+    // The plain form wraps the deconvolved tail back to the start.
+    RV other(meas.size(), 0);
+    other[0] = 1;
+    got = replace(dft, other, A, B);
+    kgot = replace(dft, other, kA, kB);
+    assert(kgot.size() == got.size());
+    real_t maxdiff = 0;
+    for (size_t ind=0; ind<got.size(); ++ind) {
+        maxdiff = std::max(maxdiff, std::abs(kgot[ind] - got[ind]));
+    }
+    assert(maxdiff > 1e-3);
+}
+
+// Trace lengths rounding to the same padded size share one cached
+// kernel spectrum and the cache never holds more than its capacity.
+void test_kernel_cache(IDFT::pointer dft)
+{
+    std::cerr << "kernel cache\n";
+    RV kwave{0.5, -0.5, 0.25};
+    Kernel kern(dft, kwave, 2);
+
+    // Both pad to 40 samples.
+    RV wave1(35, 1.0), wave2(36, 1.0);
+    convolve(dft, wave1, kern);
+    convolve(dft, wave2, kern);
+    assert(kern.cached() == 1);
+
+    for (size_t len=10; len<2000; len+=37) {
+        RV wave(len, 1.0);
+        auto got = convolve(dft, wave, kern);
+        assert(got.size() == len + kwave.size() - 1);
+        auto want = convolve(dft, wave, kwave);
+        for (size_t ind=0; ind<got.size(); ++ind) {
+            assert_small(std::abs(got[ind] - want[ind]), 1e-4);
+        }
+        assert(kern.cached() <= 2);
+    }
+    assert(kern.cached() == 2);
+}
+
 int main(int argc, char* argv[])
 {
     test_hs1d();
     test_hs2d_axis1();
     test_hs2d_axis0();
-    return 0;
 
     DftArgs args;
     int rc = make_dft_args(args, argc, argv);
@@ -320,6 +484,12 @@ int main(int argc, char* argv[])
     test_1d_c2r_impulse(idft);
     test_2d_c2r_impulse(idft, 0);
     test_2d_c2r_impulse(idft, 1);
+    test_2d_output(idft, 0);
+    test_2d_output(idft, 1);
+    test_convolve(idft);
+    test_replace_order(idft);
+    test_kernel_cache(idft);
+    test_kernel_padding(idft);
 
     test_1d_impulse(idft);
     test_2d_impulse(idft);
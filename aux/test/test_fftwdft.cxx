@@ -0,0 +1,116 @@
+// Test FftwDFT planning rigor and wisdom configuration.
+
+#include "WireCellAux/FftwDFT.h"
+#include "WireCellUtil/Exceptions.h"
+#include "WireCellUtil/Testing.h"
+
+#include <fftw3.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace WireCell;
+
+static std::shared_ptr<Aux::FftwDFT> make_dft(const std::string& planning, const std::string& wisdom = "")
+{
+    auto dft = std::make_shared<Aux::FftwDFT>();
+    auto cfg = dft->default_configuration();
+    cfg["planning"] = planning;
+    cfg["wisdom"] = wisdom;
+    dft->configure(cfg);
+    return dft;
+}
+
+static std::string wisdom_string()
+{
+    char* cstr = fftwf_export_wisdom_to_string();
+    std::string ret(cstr);
+    free(cstr);
+    return ret;
+}
+
+// Transforms at an offset from the start of the arrays must not be
+// disturbed by planning and must agree with the estimate result.
+static void test_rigor(IDFT::pointer dft, IDFT::pointer est, int size, int offset)
+{
+    std::vector<IDFT::scalar_t> buf(size + offset);
+    for (int ind = 0; ind < size; ++ind) {
+        buf[offset + ind] = std::sin(0.1 * ind) + (ind % 7);
+    }
+    const std::vector<IDFT::scalar_t> orig = buf;
+    const IDFT::scalar_t* in = buf.data() + offset;
+
+    std::vector<IDFT::complex_t> spec(size / 2 + 1 + offset), want(size / 2 + 1);
+    dft->fwd1d_r2c(in, spec.data() + offset, size);
+    est->fwd1d_r2c(in, want.data(), size);
+    Assert(buf == orig);
+    for (int ind = 0; ind < size / 2 + 1; ++ind) {
+        Assert(std::abs(spec[offset + ind] - want[ind]) < 1e-3 * size);
+    }
+
+    std::vector<IDFT::scalar_t> back(size);
+    dft->inv1d_c2r(spec.data() + offset, back.data(), size);
+    for (int ind = 0; ind < size; ++ind) {
+        Assert(std::abs(back[ind] - orig[offset + ind]) < 1e-4 * size);
+    }
+
+    // Plan handles use the same rigor.
+    auto plan = dft->plan_fwd1b_r2c(1, size, 1);
+    std::vector<IDFT::complex_t> pspec(size / 2 + 1);
+    (*plan)(in, pspec.data());
+    Assert(buf == orig);
+    for (int ind = 0; ind < size / 2 + 1; ++ind) {
+        Assert(std::abs(pspec[ind] - want[ind]) < 1e-3 * size);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string wisdom = std::string(argv[0]) + ".wisdom";
+    std::remove(wisdom.c_str());
+
+    auto est = make_dft("estimate");
+    {
+        bool threw = false;
+        try {
+            make_dft("thorough");
+        }
+        catch (ValueError& err) {
+            threw = true;
+        }
+        Assert(threw);
+    }
+
+    // Rigor belongs to the instance: configuring another instance
+    // later does not change it, so measuring still gathers wisdom.
+    fftwf_forget_wisdom();
+    const size_t empty = wisdom_string().size();
+    auto measure = make_dft("measure", wisdom);
+    auto patient = make_dft("patient");
+    auto later = make_dft("estimate");
+    for (int offset : {0, 1, 2, 3}) {
+        test_rigor(measure, est, 360, offset);
+        test_rigor(patient, est, 96, offset);
+    }
+    const std::string gathered = wisdom_string();
+    Assert(gathered.size() > empty);
+
+    // Wisdom is saved at finalize and loaded at configure.
+    measure->finalize();
+    Assert(std::ifstream(wisdom).good());
+    fftwf_forget_wisdom();
+    Assert(wisdom_string().size() == empty);
+    auto loaded = make_dft("measure", wisdom);
+    // FFTW may export loaded wisdom in another order.
+    std::cerr << "wisdom: " << gathered.size() << " gathered, " << wisdom_string().size() << " loaded\n";
+    Assert(wisdom_string().size() == gathered.size());
+    test_rigor(loaded, est, 360, 1);
+
+    std::remove(wisdom.c_str());
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include "aux_test_dft_helpers.h"
 
 #include <chrono>
+#include <cmath>
 #include <vector>
 #include <thread>
 #include <numeric>
@@ -130,6 +131,140 @@ void test_1b_impulse(IDFT::pointer dft, int axis, int nrows=128, int ncols=128)
     assert_impulse_at_index(inback, 0);
 }
 
+// Compare r2c against the complex transform of the same real data and
+// check that c2r returns the original.
+static
+std::vector<IDFT::scalar_t> make_wave(int size)
+{
+    std::vector<IDFT::scalar_t> wave(size);
+    for (int ind=0; ind<size; ++ind) {
+        wave[ind] = std::sin(0.3*ind) + 0.01*(ind%7);
+    }
+    return wave;
+}
+static
+void assert_same(const IDFT::scalar_t* a, const IDFT::scalar_t* b, int size)
+{
+    for (int ind=0; ind<size; ++ind) {
+        assert_small(std::abs(a[ind]-b[ind]), 1e-4);
+    }
+}
+
+static
+void test_1d_r2c(IDFT::pointer dft, int size)
+{
+    std::cerr << "1d r2c size="<<size<<"\n";
+    const int nhalf = size/2+1;
+    auto wave = make_wave(size);
+    std::vector<IDFT::complex_t> cwave(wave.begin(), wave.end()), spec(size), hspec(nhalf);
+    dft->fwd1d(cwave.data(), spec.data(), size);
+    dft->fwd1d_r2c(wave.data(), hspec.data(), size);
+    for (int ind=0; ind<nhalf; ++ind) {
+        assert_small(std::abs(spec[ind] - hspec[ind]), 1e-4*size);
+    }
+    std::vector<IDFT::scalar_t> back(size, 0);
+    dft->inv1d_c2r(hspec.data(), back.data(), size);
+    assert_same(wave.data(), back.data(), size);
+}
+
+static
+void test_1b_r2c(IDFT::pointer dft, int axis, int nrows, int ncols)
+{
+    std::cerr << "1b r2c axis="<<axis << " nrows="<<nrows<<" ncols="<<ncols<<"\n";
+    const int size = nrows*ncols;
+    const int hrows = axis ? nrows : nrows/2+1;
+    const int hcols = axis ? ncols/2+1 : ncols;
+    auto wave = make_wave(size);
+    std::vector<IDFT::complex_t> cwave(wave.begin(), wave.end()), spec(size), hspec(hrows*hcols);
+    dft->fwd1b(cwave.data(), spec.data(), nrows, ncols, axis);
+    dft->fwd1b_r2c(wave.data(), hspec.data(), nrows, ncols, axis);
+    for (int irow=0; irow<hrows; ++irow) {
+        for (int icol=0; icol<hcols; ++icol) {
+            assert_small(std::abs(spec[irow*ncols+icol] - hspec[irow*hcols+icol]), 1e-4*size);
+        }
+    }
+    std::vector<IDFT::scalar_t> back(size, 0);
+    dft->inv1b_c2r(hspec.data(), back.data(), nrows, ncols, axis);
+    assert_same(wave.data(), back.data(), size);
+}
+
+static
+void test_2d_r2c(IDFT::pointer dft, int nrows, int ncols)
+{
+    std::cerr << "2d r2c nrows="<<nrows<<" ncols="<<ncols<<"\n";
+    const int size = nrows*ncols;
+    const int hcols = ncols/2+1;
+    auto wave = make_wave(size);
+    std::vector<IDFT::complex_t> cwave(wave.begin(), wave.end()), spec(size), hspec(nrows*hcols);
+    // The reference is made with the 1b transforms as they follow
+    // the row-major convention of the r2c methods for any shape.
+    dft->fwd1b(cwave.data(), spec.data(), nrows, ncols, 1);
+    dft->fwd1b(spec.data(), spec.data(), nrows, ncols, 0);
+    dft->fwd2d_r2c(wave.data(), hspec.data(), nrows, ncols);
+    for (int irow=0; irow<nrows; ++irow) {
+        for (int icol=0; icol<hcols; ++icol) {
+            assert_small(std::abs(spec[irow*ncols+icol] - hspec[irow*hcols+icol]), 1e-4*size);
+        }
+    }
+    std::vector<IDFT::scalar_t> back(size, 0);
+    dft->inv2d_c2r(hspec.data(), back.data(), nrows, ncols);
+    assert_same(wave.data(), back.data(), size);
+}
+
+// Plans must match the methods and be reusable.
+static
+void test_plans(IDFT::pointer dft, int axis, int nrows, int ncols)
+{
+    std::cerr << "plans axis="<<axis << " nrows="<<nrows<<" ncols="<<ncols<<"\n";
+    const int size = nrows*ncols;
+    const int nhalf = axis ? nrows*(ncols/2+1) : (nrows/2+1)*ncols;
+    const int norm = axis ? ncols : nrows;
+    auto wave = make_wave(size);
+    std::vector<IDFT::complex_t> cwave(wave.begin(), wave.end());
+
+    auto fwd = dft->plan_fwd1b(nrows, ncols, axis);
+    auto inv = dft->plan_inv1b(nrows, ncols, axis);
+    auto inv_nonorm = dft->plan_inv1b(nrows, ncols, axis, false);
+    auto r2c = dft->plan_fwd1b_r2c(nrows, ncols, axis);
+    auto c2r = dft->plan_inv1b_c2r(nrows, ncols, axis);
+    auto c2r_nonorm = dft->plan_inv1b_c2r(nrows, ncols, axis, false);
+
+    for (int count=0; count<2; ++count) {
+        std::vector<IDFT::complex_t> want(size), got(size);
+        dft->fwd1b(cwave.data(), want.data(), nrows, ncols, axis);
+        (*fwd)(cwave.data(), got.data());
+        for (int ind=0; ind<size; ++ind) {
+            assert_small(std::abs(want[ind]-got[ind]), 1e-4);
+        }
+
+        // in-place
+        std::vector<IDFT::complex_t> back(got);
+        (*inv)(back.data(), back.data());
+        for (int ind=0; ind<size; ++ind) {
+            assert_small(std::abs(back[ind]-cwave[ind]), 1e-4);
+        }
+        (*inv_nonorm)(got.data(), back.data());
+        for (int ind=0; ind<size; ++ind) {
+            assert_small(std::abs(back[ind]-cwave[ind]*(float)norm), 1e-4*norm);
+        }
+
+        std::vector<IDFT::complex_t> hwant(nhalf), hgot(nhalf);
+        dft->fwd1b_r2c(wave.data(), hwant.data(), nrows, ncols, axis);
+        (*r2c)(wave.data(), hgot.data());
+        for (int ind=0; ind<nhalf; ++ind) {
+            assert_small(std::abs(hwant[ind]-hgot[ind]), 1e-4);
+        }
+
+        std::vector<IDFT::scalar_t> rback(size);
+        (*c2r)(hgot.data(), rback.data());
+        assert_same(wave.data(), rback.data(), size);
+        (*c2r_nonorm)(hgot.data(), rback.data());
+        for (int ind=0; ind<size; ++ind) {
+            assert_small(std::abs(rback[ind]-wave[ind]*norm), 1e-4*norm);
+        }
+    }
+}
+
 void fwdrev(IDFT::pointer dft, int id, int ntimes, int size)
 {
     int stride=size, nstrides=size;
@@ -219,6 +354,23 @@ int main(int argc, char* argv[])
     test_1b_impulse(idft, 0, 8, 2);
     test_1b_impulse(idft, 1, 8, 2);
 
+    for (int size : {1, 2, 7, 8, 1024}) {
+        test_1d_r2c(idft, size);
+    }
+    for (int axis : {0, 1}) {
+        test_1b_r2c(idft, axis, 2, 8);
+        test_1b_r2c(idft, axis, 8, 2);
+        test_1b_r2c(idft, axis, 5, 7);
+    }
+    for (int axis : {0, 1}) {
+        test_plans(idft, axis, 1, 64);
+        test_plans(idft, axis, 6, 9);
+    }
+
+    test_2d_r2c(idft, 8, 16);
+    test_2d_r2c(idft, 5, 7);
+    test_2d_r2c(idft, 6, 9);
+
     test_2d_transpose<IDFT::scalar_t>(idft, 2, 8);
     test_2d_transpose<IDFT::scalar_t>(idft, 8, 2);
     test_2d_transpose<IDFT::complex_t>(idft, 2, 8);
@@ -7,6 +7,8 @@
 #include "WireCellIface/IDepo.h"
 
 #include "WireCellGen/ImpactData.h"
+#include "WireCellGen/GaussianDiffusion.h"
+#include "WireCellUtil/Array.h"
 
 #include <deque>
 #include "WireCellUtil/Eigen.h"
@@ -24,6 +26,11 @@ namespace WireCell {
          *
          * It covers a fixed and discretely sampled time and pitch
          * domain.
+         *
+         * Diffusions are held as a struct of arrays.  Each use
+         * samples them, in order of addition, one at a time into a
+         * scratch patch whose charge is consumed before the next is
+         * sampled.
          */
         class BinnedDiffusion_transform {
            public:
@@ -77,6 +84,13 @@ namespace WireCell {
             /// drastically different response.
             // ImpactData::pointer impact_data(int bin) const;
 
+            /// Sample each diffusion once and add its charge directly
+            /// to grids, one per reduced impact number in vec_impact.
+            /// Charge on channel ch and tick t is added to element
+            /// (ch - row0, t - col0).
+            void scatter_charge(const std::vector<int>& vec_impact, std::vector<Array::array_xxf>& grids, int row0,
+                                int col0);
+
             // test ...
             void get_charge_vec(std::vector<std::vector<std::tuple<int, int, double> > >& vec_vec_charge,
                                 std::vector<int>& vec_impact);
@@ -113,9 +127,16 @@ namespace WireCell {
             std::pair<int, int> m_window;
             // the content of the current window
             std::map<int, ImpactData::mutable_pointer> m_impacts;
-            // std::vector<std::shared_ptr<GaussianDiffusion> > m_diffs;
-            // std::set<std::shared_ptr<GaussianDiffusion>, GausDiffTimeCompare> m_diffs;
-            std::set<std::shared_ptr<GaussianDiffusion> > m_diffs;
+
+            // The diffusions in order of addition.
+            std::vector<double> m_charges;
+            std::vector<GausDesc> m_time_descs, m_pitch_descs;
+
+            // Sample each diffusion in turn and call visit(extent,
+            // patch, weights).  The patch and weights are only valid
+            // during the call.
+            template <typename Visit>
+            void foreach_patch(Visit visit);
 
             int m_outside_pitch;
             int m_outside_time;
@@ -48,6 +48,11 @@ namespace WireCell {
             int m_frame_count;
             size_t m_count{0};
 
+            // Number of threads over which face/plane pairs and wire
+            // ranges are simulated.  One runs serially, zero uses the
+            // hardware concurrency.
+            int m_nthreads{1};
+
         };
     }  // namespace Gen
 }  // namespace WireCell
@@ -56,10 +56,56 @@ namespace WireCell {
              * domain is 1.0. */
             std::vector<double> binint(double start, double step, int nbins) const;
 
+            /// As above but fill nbins values into caller storage.
+            void binint(double start, double step, int nbins, double* bins) const;
+
             /** Integrate Gaussian diffusion with linear weighting
              *  to redistribute the charge to the two neartest impact positions
              *  for linear interpolation of the field response */
             std::vector<double> weight(double start, double step, int nbins, std::vector<double> pvec) const;
+
+            /// As above but fill nbins values into caller storage.
+            void weight(double start, double step, int nbins, const double* pvec, double* wt) const;
+        };
+
+        /** A DiffusionSampler fills patches of diffused charge into
+         * storage provided by the caller.  Its scratch space is
+         * reused so that sampling many depositions does not allocate.
+         *
+         * A patch of np X nt charges is stored in column-major
+         * (Eigen) order and is accompanied by np weights.  See
+         * GaussianDiffusion::set_sampling().
+         */
+        class DiffusionSampler {
+           public:
+            /// The absolute offset and the size of a patch.
+            struct Extent {
+                int toffset{-1}, poffset{-1};
+                int nt{0}, np{0};
+                int size() const { return nt * np; }
+            };
+
+            DiffusionSampler(const Binning& tbin, const Binning& pbin, double nsigma = 3.0,
+                             IRandom::pointer fluctuate = nullptr, unsigned int weightstrat = 1);
+
+            /// Return the extent of a patch for the Gaussians.  An
+            /// empty extent means there is nothing to sample.
+            Extent extent(const GausDesc& time_desc, const GausDesc& pitch_desc) const;
+
+            /// Fill the patch and weights of the given extent with
+            /// the charge.  Return false if the patch is left
+            /// without charge by fluctuations.
+            bool fill(const GausDesc& time_desc, const GausDesc& pitch_desc, double charge, const Extent& ext,
+                      float* patch, double* weights);
+
+           private:
+            const Binning& m_tbin;
+            const Binning& m_pbin;
+            double m_nsigma;
+            IRandom::pointer m_fluctuate;
+            unsigned int m_weightstrat;
+
+            std::vector<double> m_tvec, m_pvec;
         };
 
         class GaussianDiffusion {
@@ -15,6 +15,13 @@ namespace WireCell {
 
         /** An ImpactTransform transforms charge on impact positions
          * into waveforms via 2D FFT.
+         *
+         * The response kernels depend only on the plane impact
+         * response, the DFT and the number of ticks transformed and
+         * are cached and shared by all instances.  The cache is
+         * bounded and holds a pointer to each plane impact response
+         * it has kernels for, keeping it alive until its entries
+         * are evicted or clear_cache() is called.
          */
         class ImpactTransform {
             IPlaneImpactResponse::pointer m_pir;
@@ -24,7 +31,6 @@ namespace WireCell {
             int m_num_group;     // how many 2D convolution is needed
             int m_num_pad_wire;  // how many wires are needed to pad on each side
             std::vector<std::map<int, IImpactResponse::pointer> > m_vec_map_resp;
-            std::vector<std::vector<std::tuple<int, int, double> > > m_vec_vec_charge;  // ch, time, charge
             // std::vector<Eigen::SparseMatrix<float>* > m_vec_spmatrix;
 
             std::vector<int> m_vec_impact;
@@ -41,6 +47,17 @@ namespace WireCell {
 
             virtual ~ImpactTransform();
 
+            /// Drop all cached response kernels and the plane impact
+            /// responses they hold.  Later instances remake them.
+            static void clear_cache();
+
+            /// Set how many sets of response kernel spectra are
+            /// cached, default is 4.  Each holds the spectra of all
+            /// impact groups over the padded wires and ticks and may
+            /// take tens of MB.  Zero disables caching.  The cache
+            /// and so its capacity are global to the process.
+            static void set_cache_capacity(size_t capacity);
+
             /// Return the wire's waveform.  If the response functions
             /// are just field response (ie, instantaneous current)
             /// then the waveforms are expressed as current integrated
@@ -25,8 +25,10 @@
 #include "WireCellIface/IConfigurable.h"
 #include "WireCellIface/IDFT.h"
 
+#include "WireCellAux/DftTools.h"
 #include "WireCellUtil/Waveform.h"
 
+#include <memory>
 #include <unordered_set>
 
 namespace WireCell {
@@ -48,6 +50,8 @@ namespace WireCell {
             Waveform::realseq_t m_from, m_to;
             bool m_truncate;
             IDFT::pointer m_dft;
+            // Spectra of m_from and m_to are cached across traces.
+            std::unique_ptr<Aux::DftTools::Kernel> m_kfrom, m_kto;
         };
     }  // namespace Gen
 }  // namespace WireCell
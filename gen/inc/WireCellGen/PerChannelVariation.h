@@ -23,8 +23,10 @@
 #include "WireCellIface/IChannelResponse.h"
 #include "WireCellIface/IDFT.h"
 
+#include "WireCellAux/DftTools.h"
 #include "WireCellUtil/Waveform.h"
 
+#include <memory>
 #include <unordered_set>
 
 namespace WireCell {
@@ -49,6 +51,8 @@ namespace WireCell {
             WireCell::Waveform::realseq_t m_from;
             bool m_truncate;
             IDFT::pointer m_dft;
+            // Spectra of m_from are cached across traces.
+            std::unique_ptr<Aux::DftTools::Kernel> m_kfrom;
 
         };
     }  // namespace Gen
@@ -83,15 +83,92 @@ bool Gen::BinnedDiffusion_transform::add(IDepo::pointer depo, double sigma_time,
     // cerr << "DEBUG center_pitch: "<<center_pitch/units::cm<<endl;
     // cerr << "DEBUG bin_center: "<<bin_center<<endl;
 
-    auto gd = std::make_shared<GaussianDiffusion>(depo, time_desc, pitch_desc);
-    // for (int bin = bin_beg; bin < bin_end; ++bin) {
-    //   //   if (bin == bin_beg)  m_diffs.insert(gd);
-    //   this->add(gd, bin);
-    // }
-    m_diffs.insert(gd);
+    m_charges.push_back(depo->charge());
+    m_time_descs.push_back(time_desc);
+    m_pitch_descs.push_back(pitch_desc);
     return true;
 }
 
+template <typename Visit>
+void Gen::BinnedDiffusion_transform::foreach_patch(Visit visit)
+{
+    const auto ib = m_pimpos.impact_binning();
+    DiffusionSampler sampler(m_tbins, ib, m_nsigma, m_fluctuate, m_calcstrat);
+
+    // Scratch storage grows to the largest patch and is reused.
+    std::vector<float> patch;
+    std::vector<double> weights;
+
+    const size_t ndiffs = m_charges.size();
+    for (size_t idiff = 0; idiff != ndiffs; ++idiff) {
+        auto ext = sampler.extent(m_time_descs[idiff], m_pitch_descs[idiff]);
+        if (ext.size()) {
+            patch.resize(ext.size());
+            weights.assign(ext.np, 0);
+            if (!sampler.fill(m_time_descs[idiff], m_pitch_descs[idiff], m_charges[idiff], ext, patch.data(),
+                              weights.data())) {
+                ext.np = ext.nt = 0;  // no charge survived fluctuation
+            }
+        }
+        else {
+            ext.np = ext.nt = 0;
+        }
+        visit(ext, patch.data(), weights.data());
+    }
+}
+
+void Gen::BinnedDiffusion_transform::scatter_charge(const std::vector<int>& vec_impact,
+                                                    std::vector<Array::array_xxf>& grids, int row0, int col0)
+{
+    const auto ib = m_pimpos.impact_binning();
+    const auto rb = m_pimpos.region_binning();
+    const int nimps = ib.nbins();
+
+    // map between reduced impact # to array #, missing ones give the
+    // first array as the std::map lookups in get_charge_vec() do.
+    std::map<int, int> map_redimp_vec;
+    for (size_t i = 0; i != vec_impact.size(); i++) {
+        map_redimp_vec[vec_impact[i]] = int(i);
+    }
+    auto redimp_vec = [&](int redimp) {
+        auto it = map_redimp_vec.find(redimp);
+        return it == map_redimp_vec.end() ? 0 : it->second;
+    };
+
+    // Per impact, its channel, the array taking the weighted charge
+    // and the array taking the rest.
+    std::vector<int> imp_ch(nimps, 0);
+    std::vector<int> imp_this(nimps, redimp_vec(0)), imp_next(nimps, redimp_vec(1));
+    for (int wireind = 0; wireind != rb.nbins(); wireind++) {
+        int wire_imp_no = m_pimpos.wire_impact(wireind);
+        std::pair<int, int> imps_range = m_pimpos.wire_impacts(wireind);
+        for (int imp_no = imps_range.first; imp_no != imps_range.second; imp_no++) {
+            if (imp_no < 0 || imp_no >= nimps) continue;
+            imp_ch[imp_no] = wireind;
+            imp_this[imp_no] = redimp_vec(imp_no - wire_imp_no);
+            imp_next[imp_no] = redimp_vec(imp_no - wire_imp_no + 1);
+        }
+    }
+
+    foreach_patch([&](const DiffusionSampler::Extent& ext, const float* patch, const double* qweight) {
+        for (int pbin = 0; pbin != ext.np; pbin++) {
+            const int abs_pbin = pbin + ext.poffset;
+            if (abs_pbin < 0 || abs_pbin >= nimps) continue;
+            const double weight = qweight[pbin];
+            const int row = imp_ch[abs_pbin] - row0;
+            auto& grid = grids.at(imp_this[abs_pbin]);
+            auto& next_grid = grids.at(imp_next[abs_pbin]);
+
+            for (int tbin = 0; tbin != ext.nt; tbin++) {
+                const int col = tbin + ext.toffset - col0;
+                const double charge = patch[pbin + tbin * ext.np];
+                grid(row, col) += charge * weight;
+                next_grid(row, col) += charge * (1 - weight);
+            }
+        }
+    });
+}
+
 // void Gen::BinnedDiffusion_transform::add(std::shared_ptr<GaussianDiffusion> gd, int bin)
 // {
 //     ImpactData::mutable_pointer idptr = nullptr;
@@ -157,20 +234,12 @@ void Gen::BinnedDiffusion_transform::get_charge_matrix(std::vector<Eigen::Sparse
     int min_imp = 0;
     int max_imp = ib.nbins();
 
-    for (auto diff : m_diffs) {
-        //    std::cout << diff->depo()->time() << std::endl
-        // diff->set_sampling(m_tbins, ib, m_nsigma, 0, m_calcstrat);
-        diff->set_sampling(m_tbins, ib, m_nsigma, m_fluctuate, m_calcstrat);
-        // counter ++;
-
-        const auto patch = diff->patch();
-        const auto qweight = diff->weights();
+    foreach_patch([&](const DiffusionSampler::Extent& ext, const float* patch, const double* qweight) {
+        const int poffset_bin = ext.poffset;
+        const int toffset_bin = ext.toffset;
 
-        const int poffset_bin = diff->poffset_bin();
-        const int toffset_bin = diff->toffset_bin();
-
-        const int np = patch.rows();
-        const int nt = patch.cols();
+        const int np = ext.np;
+        const int nt = ext.nt;
 
         for (int pbin = 0; pbin != np; pbin++) {
             int abs_pbin = pbin + poffset_bin;
@@ -179,7 +248,7 @@ void Gen::BinnedDiffusion_transform::get_charge_matrix(std::vector<Eigen::Sparse
 
             for (int tbin = 0; tbin != nt; tbin++) {
                 int abs_tbin = tbin + toffset_bin;
-                double charge = patch(pbin, tbin);
+                double charge = patch[pbin + tbin * np];
 
                 // std::cout << map_redimp_vec[map_imp_redimp[abs_pbin] ] << " " <<
                 // map_redimp_vec[map_imp_redimp[abs_pbin]+1] << " " << abs_tbin << " " << map_imp_ch[abs_pbin] <<
@@ -214,9 +283,8 @@ void Gen::BinnedDiffusion_transform::get_charge_matrix(std::vector<Eigen::Sparse
             }
         }
 
-        diff->clear_sampling();
         // need to figure out wire #, time #, charge, and weight ...
-    }
+    });
 
     for (auto it = vec_spmatrix.begin(); it != vec_spmatrix.end(); it++) {
         (*it)->makeCompressed();
@@ -276,20 +344,14 @@ void Gen::BinnedDiffusion_transform::get_charge_vec(
     //    m_diffs1.insert(diff);
     // }
 
-    for (auto diff : m_diffs) {
-        //    std::cout << diff->depo()->time() << std::endl
-        // diff->set_sampling(m_tbins, ib, m_nsigma, 0, m_calcstrat);
-        diff->set_sampling(m_tbins, ib, m_nsigma, m_fluctuate, m_calcstrat);
+    foreach_patch([&](const DiffusionSampler::Extent& ext, const float* patch, const double* qweight) {
         counter++;
 
-        const auto patch = diff->patch();
-        const auto qweight = diff->weights();
+        const int poffset_bin = ext.poffset;
+        const int toffset_bin = ext.toffset;
 
-        const int poffset_bin = diff->poffset_bin();
-        const int toffset_bin = diff->toffset_bin();
-
-        const int np = patch.rows();
-        const int nt = patch.cols();
+        const int np = ext.np;
+        const int nt = ext.nt;
 
         // std::cout << np << " " << nt << std::endl;
 
@@ -310,7 +372,7 @@ void Gen::BinnedDiffusion_transform::get_charge_vec(
 
             for (int tbin = 0; tbin != nt; tbin++) {
                 int abs_tbin = tbin + toffset_bin;
-                double charge = patch(pbin, tbin);
+                double charge = patch[pbin + tbin * np];
 
                 // if (map_imp_ch[abs_pbin]==1459){
                 //   std::cout << pbin+poffset_bin << " " << pbin << " " << tbin << " " << charge << " " << std::endl;
@@ -383,9 +445,8 @@ void Gen::BinnedDiffusion_transform::get_charge_vec(
             }
         }
 
-        diff->clear_sampling();
         // need to figure out wire #, time #, charge, and weight ...
-    }
+    });
 
     //
 }
@@ -413,7 +474,7 @@ void Gen::BinnedDiffusion_transform::get_charge_vec(
 //     return idptr;
 // }
 
-static std::pair<double, double> gausdesc_range(const std::vector<Gen::GausDesc> gds, double nsigma)
+static std::pair<double, double> gausdesc_range(const std::vector<Gen::GausDesc>& gds, double nsigma)
 {
     int ncount = -1;
     double vmin = 0, vmax = 0;
@@ -435,11 +496,7 @@ static std::pair<double, double> gausdesc_range(const std::vector<Gen::GausDesc>
 
 std::pair<double, double> Gen::BinnedDiffusion_transform::pitch_range(double nsigma) const
 {
-    std::vector<Gen::GausDesc> gds;
-    for (auto diff : m_diffs) {
-        gds.push_back(diff->pitch_desc());
-    }
-    return gausdesc_range(gds, nsigma);
+    return gausdesc_range(m_pitch_descs, nsigma);
 }
 
 std::pair<int, int> Gen::BinnedDiffusion_transform::impact_bin_range(double nsigma) const
@@ -451,11 +508,7 @@ std::pair<int, int> Gen::BinnedDiffusion_transform::impact_bin_range(double nsig
 
 std::pair<double, double> Gen::BinnedDiffusion_transform::time_range(double nsigma) const
 {
-    std::vector<Gen::GausDesc> gds;
-    for (auto diff : m_diffs) {
-        gds.push_back(diff->time_desc());
-    }
-    return gausdesc_range(gds, nsigma);
+    return gausdesc_range(m_time_descs, nsigma);
 }
 
 std::pair<int, int> Gen::BinnedDiffusion_transform::time_bin_range(double nsigma) const
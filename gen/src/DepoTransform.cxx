@@ -40,6 +40,7 @@
 #include "WireCellGen/DepoTransform.h"
 #include "WireCellGen/ImpactTransform.h"
 #include "WireCellGen/BinnedDiffusion_transform.h"
+#include "WireCellGen/Random.h"
 
 #include "WireCellAux/SimpleTrace.h"
 #include "WireCellAux/SimpleFrame.h"
@@ -51,6 +52,13 @@
 #include "WireCellUtil/Units.h"
 #include "WireCellUtil/Point.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
 
 
 WIRECELL_FACTORY(DepoTransform, WireCell::Gen::DepoTransform, WireCell::IDepoFramer, WireCell::IConfigurable)
@@ -60,6 +68,22 @@ using namespace std;
 using WireCell::Aux::SimpleTrace;
 using WireCell::Aux::SimpleFrame;
 
+// The ImpactTransform kernel cache is global to the process so every
+// instance must ask for the same capacity.  The first one sets it.
+static void set_kernel_cache(int capacity)
+{
+    static std::mutex mutex;
+    static int configured = -1;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (configured >= 0 and configured != capacity) {
+        THROW(ValueError() << errmsg{"DepoTransform: kernel_cache " + std::to_string(capacity) +
+                                     " conflicts with " + std::to_string(configured) +
+                                     " given to another instance"});
+    }
+    configured = capacity;
+    Gen::ImpactTransform::set_cache_capacity(capacity);
+}
+
 Gen::DepoTransform::DepoTransform()
   : Aux::Logger("DepoTransform", "gen")
   , m_start_time(0.0 * units::ns)
@@ -93,6 +117,8 @@ void Gen::DepoTransform::configure(const WireCell::Configuration& cfg)
     m_start_time = get<double>(cfg, "start_time", m_start_time);
     m_drift_speed = get<double>(cfg, "drift_speed", m_drift_speed);
     m_frame_count = get<int>(cfg, "first_frame_number", m_frame_count);
+    m_nthreads = get<int>(cfg, "nthreads", m_nthreads);
+    set_kernel_cache(std::max(0, get<int>(cfg, "kernel_cache", 4)));
 
     log->debug("tick={} us, start={} us, readin={} us, drift_speed={} mm/us",
                m_tick/units::us, m_start_time/units::us,
@@ -149,6 +175,24 @@ WireCell::Configuration Gen::DepoTransform::default_configuration() const
     // type-name for the DFT to use
     cfg["dft"] = "FftwDFT";
 
+    /// Number of threads used to simulate face/plane pairs and then
+    /// ranges of wires.  One (default) is serial and zero uses all
+    /// hardware threads.  Traces are always output in the serial
+    /// order.  If "fluctuate" is set and nthreads is not one then
+    /// each face/plane draws from its own random stream seeded from
+    /// "rng" so results do not depend on thread scheduling but differ
+    /// from those of a serial run.  These streams are only made when
+    /// "rng" is a Random and they use its configured generator.  Any
+    /// other IRandom is shared and face/plane pairs are then diffused
+    /// one at a time, drawing as a serial run does.
+    put(cfg, "nthreads", m_nthreads);
+
+    /// Number of sets of response kernel spectra kept by the
+    /// ImpactTransform cache, which is shared by all instances in
+    /// the process.  Each may take tens of MB.  Zero disables it.
+    /// All instances must give the same value.
+    put(cfg, "kernel_cache", 4);
+
     return cfg;
 }
 
@@ -165,7 +209,28 @@ bool Gen::DepoTransform::operator()(const input_pointer& in, output_pointer& out
     size_t ndepos_used=0;
 
     Binning tbins(m_readout_time / m_tick, m_start_time, m_start_time + m_readout_time);
-    ITrace::vector traces;
+
+    // Each face/plane pair is simulated independently.  The depos are
+    // collected serially as modify_depo() need not be thread safe.
+    struct PlaneTask {
+        IAnodeFace::pointer face;
+        IWirePlane::pointer plane;
+        int iplane;
+        IDepo::vector depos;
+        size_t ndepos{0};
+        IRandom::pointer rng;
+        std::unique_ptr<Gen::BinnedDiffusion_transform> bindiff;
+        std::unique_ptr<Gen::ImpactTransform> transform;
+    };
+    // Threaded planes each draw from their own Gen::Random.  Any
+    // other IRandom is shared and the planes are diffused serially.
+    std::shared_ptr<Gen::Random> own_rngs;
+    if (m_nthreads != 1) {
+        own_rngs = std::dynamic_pointer_cast<Gen::Random>(m_rng);
+    }
+    const bool shared_rng = m_rng and !own_rngs;
+
+    std::vector<PlaneTask> tasks;
     for (auto face : m_anode->faces()) {
         // Select the depos which are in this face's sensitive volume
         IDepo::vector face_depos = Aux::sensitive(*depos, face);
@@ -175,42 +240,123 @@ bool Gen::DepoTransform::operator()(const input_pointer& in, output_pointer& out
         for (auto plane : face->planes()) {
             ++iplane;
 
-            const Pimpos* pimpos = plane->pimpos();
-
-            Binning tbins(m_readout_time / m_tick, m_start_time, m_start_time + m_readout_time);
-
-            Gen::BinnedDiffusion_transform bindiff(*pimpos, tbins, m_nsigma, m_rng);
+            PlaneTask task{face, plane, iplane};
             for (auto depo : face_depos) {
-                depo = modify_depo(plane->planeid(), depo);
-                bindiff.add(depo, depo->extent_long() / m_drift_speed, depo->extent_tran());
+                task.depos.push_back(modify_depo(plane->planeid(), depo));
             }
 
-            auto& wires = plane->wires();
+            task.rng = m_rng;
+            if (own_rngs) {
+                // Same engine as the configured rng, new seeds.
+                auto rcfg = own_rngs->default_configuration();
+                Json::Value jseeds(Json::arrayValue);
+                for (int ind = 0; ind < 5; ++ind) {
+                    jseeds.append(m_rng->range(0, std::numeric_limits<int>::max()));
+                }
+                rcfg["seeds"] = jseeds;
+                auto rng = std::make_shared<Gen::Random>();
+                rng->configure(rcfg);
+                task.rng = rng;
+            }
+            tasks.push_back(std::move(task));
+        }
+    }
 
-            auto pir = m_pirs.at(iplane);
-            Gen::ImpactTransform transform(pir, m_dft, bindiff);
+    // Wire waveforms are made in ranges of wires.  A task's transform
+    // is freed once its last range is done.
+    const int nchunk = 64;
+    struct WireChunk {
+        size_t itask;
+        int first, last;
+        ITrace::vector traces;
+    };
+    std::vector<WireChunk> chunks;
+    std::vector<std::atomic<int>> nleft(tasks.size());
+    for (size_t itask = 0; itask < tasks.size(); ++itask) {
+        const int nwires = tasks[itask].plane->pimpos()->region_binning().nbins();
+        for (int first = 0; first < nwires; first += nchunk) {
+            chunks.push_back({itask, first, std::min(first + nchunk, nwires)});
+            ++nleft[itask];
+        }
+    }
 
-            const int nwires = pimpos->region_binning().nbins();
-            for (int iwire = 0; iwire < nwires; ++iwire) {
-                auto wave = transform.waveform(iwire);
+    auto make_transform = [&](size_t itask) {
+        auto& task = tasks[itask];
+        const Pimpos* pimpos = task.plane->pimpos();
 
-                auto mm = Waveform::edge(wave);
-                if (mm.first == (int) wave.size()) {  // all zero
-                    continue;
-                }
+        task.bindiff = std::make_unique<Gen::BinnedDiffusion_transform>(*pimpos, tbins, m_nsigma, task.rng);
+        for (auto depo : task.depos) {
+            task.bindiff->add(depo, depo->extent_long() / m_drift_speed, depo->extent_tran());
+        }
+        task.ndepos = task.depos.size();
+        IDepo::vector().swap(task.depos);
+
+        auto pir = m_pirs.at(task.iplane);
+        task.transform = std::make_unique<Gen::ImpactTransform>(pir, m_dft, *task.bindiff);
+    };
+
+    auto make_traces = [&](size_t ichunk) {
+        auto& chunk = chunks[ichunk];
+        auto& task = tasks[chunk.itask];
+        auto& wires = task.plane->wires();
+
+        for (int iwire = chunk.first; iwire < chunk.last; ++iwire) {
+            auto wave = task.transform->waveform(iwire);
+
+            auto mm = Waveform::edge(wave);
+            if (mm.first == (int) wave.size()) {  // all zero
+                continue;
+            }
+
+            int chid = wires[iwire]->channel();
+            int tbin = mm.first;
 
-                int chid = wires[iwire]->channel();
-                int tbin = mm.first;
+            ITrace::ChargeSequence charge(wave.begin() + mm.first, wave.begin() + mm.second);
+            auto trace = make_shared<SimpleTrace>(chid, tbin, charge);
+            chunk.traces.push_back(trace);
+        }
+
+        if (--nleft[chunk.itask] == 0) {
+            task.transform.reset();
+            task.bindiff.reset();
+        }
+    };
 
-                ITrace::ChargeSequence charge(wave.begin() + mm.first, wave.begin() + mm.second);
-                auto trace = make_shared<SimpleTrace>(chid, tbin, charge);
-                traces.push_back(trace);
+    if (m_nthreads == 1) {
+        // Serially, only one transform exists at a time.
+        for (size_t ichunk = 0; ichunk < chunks.size(); ++ichunk) {
+            if (ichunk == 0 or chunks[ichunk - 1].itask != chunks[ichunk].itask) {
+                make_transform(chunks[ichunk].itask);
             }
+            make_traces(ichunk);
+        }
+    }
+    else {
+        if (shared_rng) {
+            for (size_t itask = 0; itask < tasks.size(); ++itask) {
+                make_transform(itask);
+            }
+        }
+        else {
+            Parallel::for_each_index(tasks.size(), m_nthreads, make_transform);
+        }
+        Parallel::for_each_index(chunks.size(), m_nthreads, make_traces);
+    }
+
+    ITrace::vector traces;
+    for (size_t ichunk = 0; ichunk < chunks.size(); ++ichunk) {
+        auto& chunk = chunks[ichunk];
+        traces.insert(traces.end(), chunk.traces.begin(), chunk.traces.end());
+
+        const bool last = ichunk + 1 == chunks.size() or chunks[ichunk + 1].itask != chunk.itask;
+        if (last) {
+            const auto& task = tasks[chunk.itask];
             // fixme: use SPDLOG_LOGGER_DEBUG
             log->debug("plane={} face={} depos={} total traces={}",
-                       iplane, face->ident(), face_depos.size(), traces.size());
+                       task.iplane, task.face->ident(), task.ndepos, traces.size());
         }
     }
+    tasks.clear();
 
     auto frame = make_shared<SimpleFrame>(m_frame_count, m_start_time, traces, m_tick);
     log->debug("call={} count={} ndepos_in={} ndepos_used={}",
@@ -1,5 +1,6 @@
 #include "WireCellGen/GaussianDiffusion.h"
 
+#include <algorithm>
 #include <iostream>  // debugging
 
 using namespace WireCell;
@@ -40,19 +41,31 @@ std::vector<double> Gen::GausDesc::binint(double start, double step, int nbins)
     }
     else {
         bins.resize(nbins, 0.0);
-        std::vector<double> erfs(nbins + 1, 0.0);
-        const double sqrt2 = sqrt(2.0);
-        for (int ind = 0; ind <= nbins; ++ind) {
-            double x = (start + step * ind - center) / (sqrt2 * sigma);
-            erfs[ind] = 0.5 * std::erf(x);
-        }
+        binint(start, step, nbins, bins.data());
+    }
+    return bins;
+}
 
+void Gen::GausDesc::binint(double start, double step, int nbins, double* bins) const
+{
+    if (!sigma) {
+        if (nbins != 1) {
+            cerr << "NOT one bin for true point source: " << nbins << "\n";
+        }
         for (int ibin = 0; ibin < nbins; ++ibin) {
-            const double val = erfs[ibin + 1] - erfs[ibin];
-            bins[ibin] = val;
+            bins[ibin] = ibin ? 0 : 1;
         }
+        return;
+    }
+
+    const double sqrt2 = sqrt(2.0);
+    double erf2 = 0.5 * std::erf((start - center) / (sqrt2 * sigma));
+    for (int ibin = 0; ibin < nbins; ++ibin) {
+        const double erf1 = erf2;
+        double x = (start + step * (ibin + 1) - center) / (sqrt2 * sigma);
+        erf2 = 0.5 * std::erf(x);
+        bins[ibin] = erf2 - erf1;
     }
-    return bins;
 }
 
 // integral Normal distribution with weighting function
@@ -67,30 +80,37 @@ std::vector<double> Gen::GausDesc::weight(double start, double step, int nbins,
     }
     else {
         wt.resize(nbins, 0.0);
-        const double pi = 4.0 * atan(1);
-        double x2 = start;
-        double x1 = 0;
-        double gaus2 = exp(-0.5 * (start - center) / sigma * (start - center) / sigma);
-        double gaus1 = 0;
-        for (int ind = 0; ind < nbins; ind++) {
-            x1 = x2;
-            x2 = x1 + step;
-            double rel = (x2 - center) / sigma;
-            gaus1 = gaus2;
-            gaus2 = exp(-0.5 * rel * rel);
-
-            // weighting
-            wt[ind] =
-                -1.0 * sigma / (x1 - x2) * (gaus2 - gaus1) / sqrt(2.0 * pi) / pvec[ind] + (center - x2) / (x1 - x2);
-            /* std::cerr<<"Gaus: "<<"1 and 2 "<<gaus1<<", "<<gaus2<<std::endl; */
-            /* std::cerr<<"center, x1, x2: "<<center<<", "<<x1<<", "<<x2<<std::endl; */
-            /* std::cerr<<"Total charge: "<<pvec[ind]<<std::endl; */
-            /* std::cerr<<"weight: "<<ind<<" "<<wt[ind]<<std::endl; */
-        }
+        weight(start, step, nbins, pvec.data(), wt.data());
     }
     return wt;
 }
 
+void Gen::GausDesc::weight(double start, double step, int nbins, const double* pvec, double* wt) const
+{
+    if (!sigma) {
+        for (int ind = 0; ind < nbins; ++ind) {
+            wt[ind] = (start + step - center) / step;
+        }
+        return;
+    }
+
+    const double pi = 4.0 * atan(1);
+    double x2 = start;
+    double x1 = 0;
+    double gaus2 = exp(-0.5 * (start - center) / sigma * (start - center) / sigma);
+    double gaus1 = 0;
+    for (int ind = 0; ind < nbins; ind++) {
+        x1 = x2;
+        x2 = x1 + step;
+        double rel = (x2 - center) / sigma;
+        gaus1 = gaus2;
+        gaus2 = exp(-0.5 * rel * rel);
+
+        // weighting
+        wt[ind] = -1.0 * sigma / (x1 - x2) * (gaus2 - gaus1) / sqrt(2.0 * pi) / pvec[ind] + (center - x2) / (x1 - x2);
+    }
+}
+
 // std::pair<int,int> Gen::GausDesc::subsample_range(int nsamples, double xmin, double xmax, double nsigma) const
 // {
 //     const double sample_size = (xmax-xmin)/(nsamples-1);
@@ -121,111 +141,139 @@ void Gen::GaussianDiffusion::set_sampling(const Binning& tbin,  // overall time
         return;
     }
 
+    DiffusionSampler sampler(tbin, pbin, nsigma, fluctuate, weightstrat);
+    const auto ext = sampler.extent(m_time_desc, m_pitch_desc);
+    m_toffset_bin = ext.toffset;
+    m_poffset_bin = ext.poffset;
+    if (!ext.size()) {
+        return;
+    }
+
+    patch_t patch(ext.np, ext.nt);
+    std::vector<double> qweights(ext.np, 0.5);
+    if (!sampler.fill(m_time_desc, m_pitch_desc, m_deposition->charge(), ext, patch.data(), qweights.data())) {
+        return;
+    }
+    m_patch = patch;
+    m_qweights = qweights;
+}
+
+Gen::DiffusionSampler::DiffusionSampler(const Binning& tbin, const Binning& pbin, double nsigma,
+                                        IRandom::pointer fluctuate, unsigned int weightstrat)
+  : m_tbin(tbin)
+  , m_pbin(pbin)
+  , m_nsigma(nsigma)
+  , m_fluctuate(fluctuate)
+  , m_weightstrat(weightstrat)
+{
+}
+
+Gen::DiffusionSampler::Extent Gen::DiffusionSampler::extent(const GausDesc& time_desc,
+                                                            const GausDesc& pitch_desc) const
+{
+    Extent ext;
+
     /// Sample time dimension
-    auto tval_range = m_time_desc.sigma_range(nsigma);
-    auto tbin_range = tbin.sample_bin_range(tval_range.first, tval_range.second);
-    const size_t ntss = tbin_range.second - tbin_range.first;
-    m_toffset_bin = tbin_range.first;
-    // auto tvec =  m_time_desc.sample(tbin.center(m_toffset_bin), tbin.binsize(), ntss);
-    auto tvec = m_time_desc.binint(tbin.edge(m_toffset_bin), tbin.binsize(), ntss);
-
-    if (!ntss) {
+    auto tval_range = GausDesc(time_desc).sigma_range(m_nsigma);
+    auto tbin_range = m_tbin.sample_bin_range(tval_range.first, tval_range.second);
+    ext.toffset = tbin_range.first;
+    ext.nt = std::max(0, tbin_range.second - tbin_range.first);
+    if (!ext.nt) {
         cerr << "Gen::GaussianDiffusion: no time bins for [" << tval_range.first / units::us << ","
              << tval_range.second / units::us << "] us\n";
-        return;
+        return ext;
     }
 
     /// Sample pitch dimension.
-    auto pval_range = m_pitch_desc.sigma_range(nsigma);
-    auto pbin_range = pbin.sample_bin_range(pval_range.first, pval_range.second);
-    const size_t npss = pbin_range.second - pbin_range.first;
-    m_poffset_bin = pbin_range.first;
-    // auto pvec = m_pitch_desc.sample(pbin.center(m_poffset_bin), pbin.binsize(), npss);
-    auto pvec = m_pitch_desc.binint(pbin.edge(m_poffset_bin), pbin.binsize(), npss);
-
-    if (!npss) {
+    auto pval_range = GausDesc(pitch_desc).sigma_range(m_nsigma);
+    auto pbin_range = m_pbin.sample_bin_range(pval_range.first, pval_range.second);
+    ext.poffset = pbin_range.first;
+    ext.np = std::max(0, pbin_range.second - pbin_range.first);
+    if (!ext.np) {
         cerr << "No impact bins [" << pval_range.first / units::mm << "," << pval_range.second / units::mm << "] mm\n";
-        return;
     }
+    return ext;
+}
 
-    // weightstrat = 1;
+bool Gen::DiffusionSampler::fill(const GausDesc& time_desc, const GausDesc& pitch_desc, double charge,
+                                 const Extent& ext, float* patch, double* weights)
+{
+    const int ntss = ext.nt;
+    const int npss = ext.np;
+
+    m_tvec.resize(ntss);
+    time_desc.binint(m_tbin.edge(ext.toffset), m_tbin.binsize(), ntss, m_tvec.data());
+    m_pvec.resize(npss);
+    pitch_desc.binint(m_pbin.edge(ext.poffset), m_pbin.binsize(), npss, m_pvec.data());
 
     // make charge weights for later interpolation.
     /// fixme: for hanyu.
-    if (weightstrat == 2) {
-        auto wvec = m_pitch_desc.weight(pbin.edge(m_poffset_bin), pbin.binsize(), npss, pvec);
-        m_qweights = wvec;
+    if (m_weightstrat == 2) {
+        pitch_desc.weight(m_pbin.edge(ext.poffset), m_pbin.binsize(), npss, m_pvec.data(), weights);
     }
-    if (weightstrat == 1) {
-        m_qweights.resize(npss, 0.5);
+    if (m_weightstrat == 1) {
+        std::fill(weights, weights + npss, 0.5);
     }
 
+    // Patch element (ip, it) in column-major order.
+    auto at = [&](int ip, int it) -> float& { return patch[ip + it * npss]; };
+
     // start making the time vs impact patch of charge.
-    patch_t ret = patch_t::Zero(npss, ntss);
     double raw_sum = 0.0;
 
     // Convolve the two independent Gaussians
-    for (size_t ip = 0; ip < npss; ++ip) {
-        for (size_t it = 0; it < ntss; ++it) {
-            const double val = pvec[ip] * tvec[it];
+    for (int ip = 0; ip < npss; ++ip) {
+        for (int it = 0; it < ntss; ++it) {
+            const double val = m_pvec[ip] * m_tvec[it];
             raw_sum += val;
-            ret(ip, it) = (float) val;
+            at(ip, it) = (float) val;
         }
     }
 
     // Depo charge should be in units of "e" so negative, but
     // explicitly track sign in case positive charge is given.
-    const double depo_charge = m_deposition->charge();
-    const double charge_sign = depo_charge < 0 ? -1 : 1;
+    const double charge_sign = charge < 0 ? -1 : 1;
 
     // normalize to total charge
-    ret *= depo_charge / raw_sum;
+    const float norm = charge / raw_sum;
+    for (int ind = 0; ind < ext.size(); ++ind) {
+        patch[ind] *= norm;
+    }
+
+    if (!m_fluctuate) {
+        return true;
+    }
 
     double fluc_sum = 0;
-    if (fluctuate) {
-
-        for (size_t ip = 0; ip < npss; ++ip) {
-            for (size_t it = 0; it < ntss; ++it) {
-                const double oldval = ret(ip, it);
-                // should be a multinomial distribution, n_i follows binomial distribution
-                // but n_i, n_j has covariance -n_tot * p_i * p_j
-                // normalize later to approximate this multinomial distribution (how precise?)
-                // how precise? better than poisson and 10000 total charge corresponds to a <1% level error.
-                double number = 0.0;
-                const double relval = oldval / depo_charge;
-                if (relval >= 1.0) {
-                    number = (int) std::abs(depo_charge);
-                }
-                else {
-                    number = fluctuate->binomial((int) std::abs(depo_charge), relval);
-                }
-                // the charge should be negative -- ionization electrons
-                number *= charge_sign;
-                fluc_sum += number;
-                ret(ip, it) = number;
+    for (int ip = 0; ip < npss; ++ip) {
+        for (int it = 0; it < ntss; ++it) {
+            const double oldval = at(ip, it);
+            // should be a multinomial distribution, n_i follows binomial distribution
+            // but n_i, n_j has covariance -n_tot * p_i * p_j
+            // normalize later to approximate this multinomial distribution (how precise?)
+            // how precise? better than poisson and 10000 total charge corresponds to a <1% level error.
+            double number = 0.0;
+            const double relval = oldval / charge;
+            if (relval >= 1.0) {
+                number = (int) std::abs(charge);
             }
-        }
-        if (fluc_sum == 0) {
-            return;
-        }
-        else {
-            ret *= m_deposition->charge() / fluc_sum;
+            else {
+                number = m_fluctuate->binomial((int) std::abs(charge), relval);
+            }
+            // the charge should be negative -- ionization electrons
+            number *= charge_sign;
+            fluc_sum += number;
+            at(ip, it) = number;
         }
     }
-
-    {  // debugging
-       // double retsum=0.0;
-       // for (size_t ip = 0; ip < npss; ++ip) {
-       //    for (size_t it = 0; it < ntss; ++it) {
-       //        retsum += ret(ip,it);
-       //    }
-       //}
-       // cerr << "GaussianDiffusion: Q in electrons: depo=" << m_deposition->charge()/units::eplus
-       //      << " rawsum=" << raw_sum/units::eplus << " flucsum=" << fluc_sum/units::eplus
-       //      << " returned=" << retsum/units::eplus << endl;
+    if (fluc_sum == 0) {
+        return false;
     }
-
-    m_patch = ret;
+    const float fluc_norm = charge / fluc_sum;
+    for (int ind = 0; ind < ext.size(); ++ind) {
+        patch[ind] *= fluc_norm;
+    }
+    return true;
 }
 
 void Gen::GaussianDiffusion::clear_sampling()
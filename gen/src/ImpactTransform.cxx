@@ -6,7 +6,10 @@
 #include "WireCellUtil/FFTBestLength.h"
 #include "WireCellUtil/Exceptions.h"
 
+#include <deque>
+#include <functional>
 #include <iostream>  // debugging.
+#include <mutex>
 using namespace std;
 
 using namespace WireCell;
@@ -15,6 +18,141 @@ using WireCell::Aux::DftTools::fwd_r2c;
 using WireCell::Aux::DftTools::inv;
 using WireCell::Aux::DftTools::inv_c2r;
 
+namespace {
+    // A bounded, thread safe cache of immutable values.  Values are
+    // made outside of the lock so concurrent misses may duplicate
+    // work but all callers receive the first value stored.
+    template <typename Key, typename Value>
+    class SharedCache {
+        std::mutex m_mutex;
+        std::map<Key, std::shared_ptr<const Value>> m_entries;
+        std::deque<Key> m_order;
+        size_t m_capacity;
+
+       public:
+        SharedCache(size_t capacity)
+          : m_capacity(capacity)
+        {
+        }
+
+        std::shared_ptr<const Value> get(const Key& key, const std::function<Value()>& make)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_entries.find(key);
+                if (it != m_entries.end()) {
+                    return it->second;
+                }
+            }
+            auto value = std::make_shared<const Value>(make());
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            if (it != m_entries.end()) {
+                return it->second;
+            }
+            m_entries[key] = value;
+            m_order.push_back(key);
+            while (m_order.size() > m_capacity) {
+                m_entries.erase(m_order.front());
+                m_order.pop_front();
+            }
+            return value;
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries.clear();
+            m_order.clear();
+        }
+
+        void set_capacity(size_t capacity)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_capacity = capacity;
+            while (m_order.size() > m_capacity) {
+                m_entries.erase(m_order.front());
+                m_order.pop_front();
+            }
+        }
+    };
+
+    // Per impact group, one array of response kernels with rows for
+    // wire offsets -num_pad_wire to +num_pad_wire.
+    using real_kernels_t = std::vector<Array::array_xxf>;
+    using spec_kernels_t = std::vector<Array::array_xxc>;
+
+    // Keys hold the PIR and DFT so neither can be replaced by another
+    // at the same address while its kernels are cached.
+    using kernel_key_t = std::tuple<IPlaneImpactResponse::pointer, IDFT::pointer, int>;
+}
+
+// The real-space kernels depend only on the PIR and the spectra of
+// their truncation to a window of ticks only on the PIR and window
+// size.  They are shared across events and ImpactTransform instances.
+// Entries hold their PIR until evicted or cleared, see clear_cache().
+// Each entry of g_spec_kernels is large, see set_cache_capacity().
+static SharedCache<kernel_key_t, real_kernels_t> g_real_kernels(8);
+static SharedCache<kernel_key_t, spec_kernels_t> g_spec_kernels(4);
+static SharedCache<kernel_key_t, Waveform::compseq_t> g_long_spectra(8);
+
+static std::shared_ptr<const real_kernels_t>
+real_kernels(const IPlaneImpactResponse::pointer& pir, const IDFT::pointer& dft,
+             const std::vector<std::map<int, IImpactResponse::pointer> >& vec_map_resp, int num_pad_wire)
+{
+    return g_real_kernels.get({pir, dft, 0}, [&]() {
+        real_kernels_t kernels;
+        for (const auto& map_resp : vec_map_resp) {
+            Array::array_xxf kern = Array::array_xxf::Zero(2 * num_pad_wire + 1, pir->nbins());
+            for (int irow = 0; irow <= 2 * num_pad_wire; ++irow) {
+                auto it = map_resp.find(irow - num_pad_wire);
+                if (it == map_resp.end() or !it->second) {
+                    continue;
+                }
+                // do a inverse FFT
+                Waveform::realseq_t wave = inv_c2r(dft, it->second->spectrum());
+                const int ncols = std::min<int>(kern.cols(), wave.size());
+                for (int icol = 0; icol < ncols; ++icol) {
+                    kern(irow, icol) = wave[icol];
+                }
+            }
+            kernels.push_back(kern);
+        }
+        return kernels;
+    });
+}
+
+static std::shared_ptr<const spec_kernels_t>
+spec_kernels(const IPlaneImpactResponse::pointer& pir, const IDFT::pointer& dft,
+             const real_kernels_t& reals, int nticks)
+{
+    return g_spec_kernels.get({pir, dft, nticks}, [&]() {
+        spec_kernels_t kernels;
+        for (const auto& real : reals) {
+            // pick the first nticks ticks and do a FFT
+            Array::array_xxf reduced = Array::array_xxf::Zero(real.rows(), nticks);
+            const int ncols = std::min<int>(nticks, real.cols());
+            reduced.leftCols(ncols) = real.leftCols(ncols);
+            kernels.push_back(fwd_r2c(dft, reduced, 1));
+        }
+        return kernels;
+    });
+}
+
+// Fill the rows of resp_f_w from the kernels of one impact group.
+// Positive wire offsets fill from the first row and negative offsets
+// wrap around from the last.
+static void fill_response(Array::array_xxc& resp_f_w, const Array::array_xxc& kern, int num_pad_wire)
+{
+    const int nrows = resp_f_w.rows();
+    resp_f_w.row(0) = kern.row(num_pad_wire);
+    for (int irow = 0; irow != num_pad_wire; irow++) {
+        resp_f_w.row(irow + 1) = kern.row(num_pad_wire + irow + 1);
+        resp_f_w.row(nrows - 1 - irow) = kern.row(num_pad_wire - irow - 1);
+    }
+}
+
 
 Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
                                       const IDFT::pointer& dft,
@@ -62,22 +200,11 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
                           << std::endl;                
                 continue;
             }
-                
-            Waveform::compseq_t response_spectrum = map_resp[j - m_num_pad_wire]->spectrum();
-
         }
 
         m_vec_map_resp.push_back(map_resp);
-
-        std::vector<std::tuple<int, int, double> > vec_charge;  // ch, time, charge
-        m_vec_vec_charge.push_back(vec_charge);
     }
 
-    // now work on the charge part ...
-    // trying to sampling ...
-    m_bd.get_charge_vec(m_vec_vec_charge, m_vec_impact);
-    // std::cout << nwires << " " << nsamples << std::endl;
-
     // length and width ...
 
     //    std::cout << nwires << " " << nsamples << std::endl;
@@ -117,7 +244,18 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
     Array::array_xxc acc_data_f_w =
         Array::array_xxc::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
 
-    int num_double = (m_vec_vec_charge.size() - 1) / 2;
+    // Response kernel spectra, cached across events.
+    auto reals = real_kernels(m_pir, m_dft, m_vec_map_resp, m_num_pad_wire);
+    auto kernels = spec_kernels(m_pir, m_dft, *reals, m_end_tick - m_start_tick);
+
+    // now work on the charge part ...
+    // each diffusion is sampled once and its charge scattered
+    // directly into the time-wire array of each impact group.
+    std::vector<Array::array_xxf> q_data(
+        m_num_group, Array::array_xxf::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick));
+    m_bd.scatter_charge(m_vec_impact, q_data, m_start_ch, m_start_tick);
+
+    int num_double = (m_num_group - 1) / 2;
 
     // speed up version , first five
     for (int i = 0; i != num_double; i++) {
@@ -126,25 +264,13 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
         Array::array_xxc c_data = Array::array_xxc::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
 
         // fill normal order
-        for (size_t j = 0; j != m_vec_vec_charge.at(i).size(); j++) {
-            c_data(std::get<0>(m_vec_vec_charge.at(i).at(j)) + npad_wire - start_ch,
-                   std::get<1>(m_vec_vec_charge.at(i).at(j)) - m_start_tick) +=
-                std::get<2>(m_vec_vec_charge.at(i).at(j));
-        }
-        //    std::cout << i << " " << m_vec_vec_charge.at(i).size() << std::endl;
-        m_vec_vec_charge.at(i).clear();
-        m_vec_vec_charge.at(i).shrink_to_fit();
+        c_data.real() = q_data[i];
+        q_data[i].resize(0, 0);
 
         // fill reverse order
         int ii = num_double * 2 - i;
-        for (size_t j = 0; j != m_vec_vec_charge.at(ii).size(); j++) {
-            c_data(end_ch + npad_wire - 1 - std::get<0>(m_vec_vec_charge.at(ii).at(j)),
-                   std::get<1>(m_vec_vec_charge.at(ii).at(j)) - m_start_tick) +=
-                std::complex<float>(0, std::get<2>(m_vec_vec_charge.at(ii).at(j)));
-        }
-        //    std::cout << ii << " " << m_vec_vec_charge.at(ii).size() << std::endl;
-        m_vec_vec_charge.at(ii).clear();
-        m_vec_vec_charge.at(ii).shrink_to_fit();
+        c_data.imag() = q_data[ii].colwise().reverse();
+        q_data[ii].resize(0, 0);
 
         // Do FFT on time
         // Do FFT on wire
@@ -154,47 +280,7 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
         {
             Array::array_xxc resp_f_w =
                 Array::array_xxc::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
-            {
-                Waveform::compseq_t rs1 = m_vec_map_resp.at(i)[0]->spectrum();
-                // do a inverse FFT
-                Waveform::realseq_t rs1_t = inv_c2r(m_dft, rs1);
-                // pick the first xxx ticks
-                Waveform::realseq_t rs1_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs1_t.size())) break;
-                    rs1_reduced.at(icol) = rs1_t[icol];
-                }
-                // do a FFT
-                rs1 = fwd_r2c(m_dft, rs1_reduced);
-
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    resp_f_w(0, icol) = rs1[icol];
-                }
-            }
-
-            for (int irow = 0; irow != m_num_pad_wire; irow++) {
-                Waveform::compseq_t rs1 = m_vec_map_resp.at(i)[irow + 1]->spectrum();
-                Waveform::realseq_t rs1_t = inv_c2r(m_dft, rs1);
-                Waveform::realseq_t rs1_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs1_t.size())) break;
-                    rs1_reduced.at(icol) = rs1_t[icol];
-                }
-                rs1 = fwd_r2c(m_dft, rs1_reduced);
-                Waveform::compseq_t rs2 = m_vec_map_resp.at(i)[-irow - 1]->spectrum();
-                Waveform::realseq_t rs2_t = inv_c2r(m_dft, rs2);
-                Waveform::realseq_t rs2_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs2_t.size())) break;
-                    rs2_reduced.at(icol) = rs2_t[icol];
-                }
-                rs2 = fwd_r2c(m_dft, rs2_reduced);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    resp_f_w(irow + 1, icol) = rs1[icol];
-                    resp_f_w(end_ch - start_ch - 1 - irow + 2 * npad_wire, icol) = rs2[icol];
-                }
-            }
-            // std::cout << i << std::endl;
+            fill_response(resp_f_w, kernels->at(i), m_num_pad_wire);
 
             // Do FFT on wire for response // slight larger
             // Now becomes the f and f in both time and wire domain ...
@@ -220,21 +306,10 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
 
         Array::array_xxc data_f_w;
         {
-            Array::array_xxf data_t_w =
-                Array::array_xxf::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
-            // fill charge array in time-wire domain // slightly larger
-            for (size_t j = 0; j != m_vec_vec_charge.at(i).size(); j++) {
-                data_t_w(std::get<0>(m_vec_vec_charge.at(i).at(j)) + npad_wire - start_ch,
-                         std::get<1>(m_vec_vec_charge.at(i).at(j)) - m_start_tick) +=
-                    std::get<2>(m_vec_vec_charge.at(i).at(j));
-                // std::cout << std::get<1>(m_vec_vec_charge.at(i).at(j)) << std::endl;
-            }
-            //      std::cout << i << " " << m_vec_vec_charge.at(i).size() << std::endl;
-            m_vec_vec_charge.at(i).clear();
-            m_vec_vec_charge.at(i).shrink_to_fit();
-
+            // charge array in time-wire domain // slightly larger
             // Do FFT on time
-            data_f_w = fwd_r2c(m_dft, data_t_w, 1);
+            data_f_w = fwd_r2c(m_dft, q_data[i], 1);
+            q_data[i].resize(0, 0);
             // Do FFT on wire
             data_f_w = fwd(m_dft, data_f_w, 0);
         }
@@ -242,50 +317,8 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
         {
             Array::array_xxc resp_f_w =
                 Array::array_xxc::Zero(end_ch - start_ch + 2 * npad_wire, m_end_tick - m_start_tick);
+            fill_response(resp_f_w, kernels->at(i), m_num_pad_wire);
 
-            {
-                Waveform::compseq_t rs1 = m_vec_map_resp.at(i)[0]->spectrum();
-
-                // do a inverse FFT
-                Waveform::realseq_t rs1_t = inv_c2r(m_dft, rs1);
-                // pick the first xxx ticks
-                Waveform::realseq_t rs1_reduced(m_end_tick - m_start_tick, 0);
-                // std::cout << rs1.size() << " " << nsamples << " " << m_end_tick << " " <<  m_start_tick << std::endl;
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs1_t.size())) break;
-                    rs1_reduced.at(icol) = rs1_t[icol];
-                    //  std::cout << icol << " " << rs1_t[icol] << std::endl;
-                }
-                // do a FFT
-                rs1 = fwd_r2c(m_dft, rs1_reduced);
-
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    //   std::cout << icol << " " << rs1[icol] << " " << temp_resp_f_w(0,icol) << std::endl;
-                    resp_f_w(0, icol) = rs1[icol];
-                }
-            }
-            for (int irow = 0; irow != m_num_pad_wire; irow++) {
-                Waveform::compseq_t rs1 = m_vec_map_resp.at(i)[irow + 1]->spectrum();
-                Waveform::realseq_t rs1_t = inv_c2r(m_dft, rs1);
-                Waveform::realseq_t rs1_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs1_t.size())) break;
-                    rs1_reduced.at(icol) = rs1_t[icol];
-                }
-                rs1 = fwd_r2c(m_dft, rs1_reduced);
-                Waveform::compseq_t rs2 = m_vec_map_resp.at(i)[-irow - 1]->spectrum();
-                Waveform::realseq_t rs2_t = inv_c2r(m_dft, rs2);
-                Waveform::realseq_t rs2_reduced(m_end_tick - m_start_tick, 0);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    if (icol >= int(rs2_t.size())) break;
-                    rs2_reduced.at(icol) = rs2_t[icol];
-                }
-                rs2 = fwd_r2c(m_dft, rs2_reduced);
-                for (int icol = 0; icol != m_end_tick - m_start_tick; icol++) {
-                    resp_f_w(irow + 1, icol) = rs1[icol];
-                    resp_f_w(end_ch - start_ch - 1 - irow + 2 * npad_wire, icol) = rs2[icol];
-                }
-            }
             // Do FFT on wire for response // slight larger
             // Now becomes the f and f in both time and wire domain ...
             resp_f_w = fwd(m_dft, resp_f_w, 0);
@@ -309,6 +342,18 @@ Gen::ImpactTransform::ImpactTransform(IPlaneImpactResponse::pointer pir,
 
 Gen::ImpactTransform::~ImpactTransform() {}
 
+void Gen::ImpactTransform::clear_cache()
+{
+    g_real_kernels.clear();
+    g_spec_kernels.clear();
+    g_long_spectra.clear();
+}
+
+void Gen::ImpactTransform::set_cache_capacity(size_t capacity)
+{
+    g_spec_kernels.set_capacity(capacity);
+}
+
 Waveform::realseq_t Gen::ImpactTransform::waveform(int iwire) const
 {
     const int nsamples = m_bd.tbins().nbins();
@@ -331,12 +376,14 @@ Waveform::realseq_t Gen::ImpactTransform::waveform(int iwire) const
             //   std::cout << nlength << " " << nsamples + m_pir->closest(0)->long_aux_waveform_pad() << std::endl;
 
             wf.resize(nlength, 0);
-            Waveform::realseq_t long_resp = m_pir->closest(0)->long_aux_waveform();
-            long_resp.resize(nlength, 0);
+            auto long_spec = g_long_spectra.get({m_pir, m_dft, (int) nlength}, [&]() {
+                Waveform::realseq_t long_resp = m_pir->closest(0)->long_aux_waveform();
+                long_resp.resize(nlength, 0);
+                return fwd_r2c(m_dft, long_resp);
+            });
             Waveform::compseq_t spec = fwd_r2c(m_dft, wf);
-            Waveform::compseq_t long_spec = fwd_r2c(m_dft, long_resp);
             for (size_t i = 0; i != nlength; i++) {
-                spec.at(i) *= long_spec.at(i);
+                spec.at(i) *= long_spec->at(i);
             }
             wf = inv_c2r(m_dft, spec);
             wf.resize(nsamples, 0);
@@ -66,6 +66,9 @@ void Gen::Misconfigure::configure(const WireCell::Configuration& cfg)
 
     std::string dft_tn = get<std::string>(cfg, "dft", "FftwDFT");
     m_dft = Factory::find_tn<IDFT>(dft_tn);
+
+    m_kfrom = std::make_unique<Aux::DftTools::Kernel>(m_dft, m_from);
+    m_kto = std::make_unique<Aux::DftTools::Kernel>(m_dft, m_to);
 }
 
 bool Gen::Misconfigure::operator()(const input_pointer& in, output_pointer& out)
@@ -88,7 +91,7 @@ bool Gen::Misconfigure::operator()(const input_pointer& in, output_pointer& out)
 
         // auto wave = Waveform::replace_convolve(trace->charge(), m_to, m_from, m_truncate);
         const auto& charge = trace->charge();
-        auto wave = Aux::DftTools::replace(m_dft, charge, m_to, m_from);
+        auto wave = Aux::DftTools::replace(m_dft, charge, *m_kfrom, *m_kto);
         wave.resize(charge.size());
         out_traces[ind] = std::make_shared<SimpleTrace>(trace->channel(), trace->tbin(), wave);
     }
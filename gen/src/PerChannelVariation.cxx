@@ -69,6 +69,7 @@ void Gen::PerChannelVariation::configure(const WireCell::Configuration& cfg)
         m_nsamples = cr_bins.nbins();
         WireCell::Binning tbins(m_nsamples, cr_bins.min(), cr_bins.min() + m_nsamples * tick);
         m_from = Response::ColdElec(cfg["gain"].asDouble(), cfg["shaping"].asDouble()).generate(tbins);
+        m_kfrom = std::make_unique<Aux::DftTools::Kernel>(m_dft, m_from);
     }
 
     m_truncate = cfg["truncate"].asBool();
@@ -103,7 +104,7 @@ bool Gen::PerChannelVariation::operator()(const input_pointer& in, output_pointe
         // tch_resp.resize(m_nsamples, 0);
         // auto wave = Waveform::replace_convolve(trace->charge(), tch_resp, m_from, m_truncate);
         const auto& charge = trace->charge();
-        auto wave = Aux::DftTools::replace(m_dft, charge, tch_resp, m_from);
+        auto wave = Aux::DftTools::replace(m_dft, charge, *m_kfrom, tch_resp);
         wave.resize(charge.size());
         out_traces[ind] = std::make_shared<SimpleTrace>(chid, trace->tbin(), wave);
     }
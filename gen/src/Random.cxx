@@ -124,6 +124,7 @@ void Gen::Random::configure(const WireCell::Configuration& cfg)
         m_seeds = seeds;
     }
     auto gen = get(cfg, "generator", m_generator);
+    m_generator = gen;
     if (m_pimpl) {
         delete m_pimpl;
     }
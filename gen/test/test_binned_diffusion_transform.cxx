@@ -0,0 +1,150 @@
+/** Check that the charge which BinnedDiffusion_transform samples one
+ * diffusion at a time agrees exactly with that from the patches of
+ * individual GaussianDiffusion objects, accumulated as the original
+ * get_charge_vec() did, and that scatter_charge() puts the same
+ * charge into its grids.
+ */
+
+#include "WireCellGen/BinnedDiffusion_transform.h"
+#include "WireCellGen/GaussianDiffusion.h"
+#include "WireCellAux/SimpleDepo.h"
+#include "WireCellUtil/Testing.h"
+#include "WireCellUtil/Units.h"
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <tuple>
+
+using namespace WireCell;
+
+// (group, channel, tick) -> charge
+using charge_map_t = std::map<std::tuple<int, int, int>, double>;
+
+static charge_map_t to_map(const std::vector<std::vector<std::tuple<int, int, double> > >& vec_vec_charge)
+{
+    charge_map_t ret;
+    for (size_t group = 0; group != vec_vec_charge.size(); ++group) {
+        for (const auto& one : vec_vec_charge[group]) {
+            ret[std::make_tuple(int(group), std::get<0>(one), std::get<1>(one))] += std::get<2>(one);
+        }
+    }
+    return ret;
+}
+
+int main()
+{
+    const int nwires = 40;
+    const int nticks = 1000;
+    const double tick = 0.5 * units::us;
+    const double nsigma = 3.0;
+    Pimpos pimpos(nwires, -60 * units::mm, 60 * units::mm);
+    Binning tbins(nticks, 0, nticks * tick);
+    const auto ib = pimpos.impact_binning();
+    const auto strat = Gen::BinnedDiffusion_transform::linear;
+
+    Gen::BinnedDiffusion_transform bd(pimpos, tbins, nsigma, nullptr, strat);
+    std::vector<Gen::GaussianDiffusion> gds;
+
+    // Include depos at either edge of the plane.
+    std::vector<double> pitches;
+    for (int ind = 0; ind < 20; ++ind) {
+        pitches.push_back((-40 + 4.1 * ind) * units::mm);
+    }
+    pitches.push_back(-61 * units::mm);
+    pitches.push_back(61 * units::mm);
+
+    for (size_t ind = 0; ind < pitches.size(); ++ind) {
+        const double charge = -1000.0 * (ind + 1);
+        const double sigma_time = (0.5 + 0.1 * ind) * units::us;
+        const double sigma_pitch = (0.3 + 0.1 * ind) * units::mm;
+        auto depo = std::make_shared<Aux::SimpleDepo>((50 + 17 * ind) * units::us, Point(0, 0, pitches[ind]), charge);
+        Assert(bd.add(depo, sigma_time, sigma_pitch));
+
+        Gen::GausDesc time_desc(depo->time(), sigma_time);
+        Gen::GausDesc pitch_desc(pimpos.distance(depo->pos()), sigma_pitch);
+        gds.emplace_back(depo, time_desc, pitch_desc);
+    }
+
+    // As used by ImpactTransform.
+    std::vector<int> vec_impact;
+    for (int imp = -5; imp <= 5; ++imp) {
+        vec_impact.push_back(imp);
+    }
+    const int ngroups = vec_impact.size();
+
+    std::vector<std::vector<std::tuple<int, int, double> > > vec_vec_charge(ngroups);
+    bd.get_charge_vec(vec_vec_charge, vec_impact);
+    auto got = to_map(vec_vec_charge);
+
+    // The reference, with the original map lookups.
+    std::map<int, int> map_redimp_vec;
+    for (size_t i = 0; i != vec_impact.size(); i++) {
+        map_redimp_vec[vec_impact[i]] = int(i);
+    }
+    std::map<int, int> map_imp_ch, map_imp_redimp;
+    const auto rb = pimpos.region_binning();
+    for (int wireind = 0; wireind != rb.nbins(); wireind++) {
+        int wire_imp_no = pimpos.wire_impact(wireind);
+        auto imps_range = pimpos.wire_impacts(wireind);
+        for (int imp_no = imps_range.first; imp_no != imps_range.second; imp_no++) {
+            map_imp_ch[imp_no] = wireind;
+            map_imp_redimp[imp_no] = imp_no - wire_imp_no;
+        }
+    }
+    charge_map_t want;
+    for (auto& gd : gds) {
+        gd.set_sampling(tbins, ib, nsigma, nullptr, strat);
+        const auto& patch = gd.patch();
+        const auto weights = gd.weights();
+        for (int pbin = 0; pbin != patch.rows(); pbin++) {
+            int abs_pbin = pbin + gd.poffset_bin();
+            if (abs_pbin < 0 || abs_pbin >= ib.nbins()) continue;
+            const double weight = weights[pbin];
+            const int channel = map_imp_ch[abs_pbin];
+            const int redimp = map_imp_redimp[abs_pbin];
+            const int group = map_redimp_vec[redimp];
+            const int next_group = map_redimp_vec[redimp + 1];
+            for (int tbin = 0; tbin != patch.cols(); tbin++) {
+                const int abs_tbin = tbin + gd.toffset_bin();
+                const double charge = patch(pbin, tbin);
+                want[std::make_tuple(group, channel, abs_tbin)] += charge * weight;
+                want[std::make_tuple(next_group, channel, abs_tbin)] += charge * (1 - weight);
+            }
+        }
+        gd.clear_sampling();
+    }
+
+    std::cerr << "entries: " << got.size() << " reference: " << want.size() << "\n";
+    Assert(got == want);
+
+    // Without fluctuation, sampling again gives the same result.
+    std::vector<std::vector<std::tuple<int, int, double> > > again(ngroups);
+    bd.get_charge_vec(again, vec_impact);
+    Assert(to_map(again) == got);
+
+    // Scattering directly into grids gives the same, up to the
+    // precision of their float elements.
+    const int row0 = -1, col0 = -1;
+    std::vector<Array::array_xxf> grids(ngroups, Array::array_xxf::Zero(nwires + 2, nticks + 2));
+    bd.scatter_charge(vec_impact, grids, row0, col0);
+    double maxdiff = 0, maxq = 0;
+    for (const auto& [key, q] : want) {
+        const auto& grid = grids[std::get<0>(key)];
+        const double diff = std::abs(grid(std::get<1>(key) - row0, std::get<2>(key) - col0) - q);
+        maxdiff = std::max(maxdiff, diff);
+        maxq = std::max(maxq, std::abs(q));
+    }
+    double want_sum = 0, grid_sum = 0;
+    for (const auto& one : want) {
+        want_sum += one.second;
+    }
+    for (const auto& grid : grids) {
+        grid_sum += grid.cast<double>().sum();
+    }
+    std::cerr << "max diff: " << maxdiff << " of " << maxq << ", sums: " << grid_sum << " " << want_sum << "\n";
+    Assert(maxdiff <= 1e-5 * maxq);
+    Assert(std::abs(grid_sum - want_sum) <= 1e-5 * std::abs(want_sum));
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Check that DepoTransform makes the same frame with one thread as
+// with many when charge is not fluctuated.
+
+#include "WireCellIface/IConfigurable.h"
+#include "WireCellIface/IDepoFramer.h"
+#include "WireCellIface/IPlaneImpactResponse.h"
+
+#include "WireCellAux/SimpleDepo.h"
+#include "WireCellAux/SimpleDepoSet.h"
+
+#include "WireCellUtil/Testing.h"
+
+#include "anode_loader.h"
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    PluginManager& pm = PluginManager::instance();
+    pm.add("WireCellAux");
+
+    auto anode_tns = anode_loader("uboone");
+
+    Configuration pirs = Json::arrayValue;
+    for (int iplane = 0; iplane < 3; ++iplane) {
+        const std::string tn = String::format("PlaneImpactResponse:%d", iplane);
+        auto icfg = Factory::lookup_tn<IConfigurable>(tn);
+        auto cfg = icfg->default_configuration();
+        cfg["plane"] = iplane;
+        icfg->configure(cfg);
+        pirs.append(tn);
+    }
+
+    // Depos along a track crossing many wires of each plane.
+    IDepo::vector depos;
+    const int ndepos = 500;
+    for (int ind = 0; ind < ndepos; ++ind) {
+        const double frac = ind / (double) ndepos;
+        const Point pos(15 * units::cm, (-80 + 160 * frac) * units::cm, (100 + 600 * frac) * units::cm);
+        depos.push_back(std::make_shared<Aux::SimpleDepo>((100 + 1000 * frac) * units::us, pos, -5000.0, nullptr,
+                                                          1 * units::mm, 1 * units::mm));
+    }
+    auto depo_set = std::make_shared<Aux::SimpleDepoSet>(0, depos);
+
+    std::vector<IFrame::pointer> frames;
+    for (int nthreads : {1, 4}) {
+        const std::string tn = String::format("DepoTransform:nthreads%d", nthreads);
+        auto icfg = Factory::lookup_tn<IConfigurable>(tn);
+        auto cfg = icfg->default_configuration();
+        cfg["anode"] = anode_tns[0];
+        cfg["pirs"] = pirs;
+        cfg["fluctuate"] = false;
+        cfg["nthreads"] = nthreads;
+        icfg->configure(cfg);
+
+        auto dt = Factory::find_tn<IDepoFramer>(tn);
+        IFrame::pointer frame;
+        Assert((*dt)(depo_set, frame));
+        Assert(frame);
+        frames.push_back(frame);
+    }
+
+    auto one = frames[0]->traces();
+    auto many = frames[1]->traces();
+    std::cerr << "traces: " << one->size() << " " << many->size() << "\n";
+    Assert(one->size() > 0);
+    Assert(one->size() == many->size());
+    for (size_t ind = 0; ind < one->size(); ++ind) {
+        const auto& a = one->at(ind);
+        const auto& b = many->at(ind);
+        Assert(a->channel() == b->channel());
+        Assert(a->tbin() == b->tbin());
+        Assert(a->charge() == b->charge());
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+/** Check that ImpactTransform waveforms made with response kernels
+ * cached by earlier events equal those made with an empty cache and
+ * that clearing the cache releases the plane impact response, also
+ * when the cache is bounded to one or no entries.
+ */
+
+#include "WireCellGen/ImpactTransform.h"
+#include "WireCellGen/PlaneImpactResponse.h"
+#include "WireCellAux/SimpleDepo.h"
+#include "WireCellAux/DftTools.h"
+#include "WireCellUtil/PluginManager.h"
+#include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Testing.h"
+#include "WireCellUtil/Exceptions.h"
+#include "WireCellUtil/Units.h"
+
+#include <cmath>
+#include <iostream>
+
+using namespace WireCell;
+
+// A plane impact response with made up impact responses.
+class MockPIR : public IPlaneImpactResponse {
+    std::vector<IImpactResponse::pointer> m_irs;
+    const double m_pitch{3 * units::mm}, m_impact{0.3 * units::mm};
+    const int m_nwires{7};
+    const size_t m_nbins{128};
+
+   public:
+    MockPIR(IDFT::pointer dft, bool with_long)
+    {
+        const int nimps = m_nwires * 10 + 1;
+        for (int imp = 0; imp < nimps; ++imp) {
+            Waveform::realseq_t wave(m_nbins, 0);
+            for (int tick = 0; tick < 40; ++tick) {
+                wave[tick] = std::sin(0.3 * tick + imp) * std::exp(-0.1 * tick) * (1 + 0.01 * imp);
+            }
+            Waveform::realseq_t long_wave;
+            if (with_long) {
+                long_wave = {1.0, 0.5, 0.25, 0.125};
+            }
+            auto spec = Aux::DftTools::fwd_r2c(dft, wave);
+            m_irs.push_back(std::make_shared<Gen::ImpactResponse>(imp, spec, wave, 20, long_wave, 10));
+        }
+    }
+    virtual ~MockPIR() {}
+
+    virtual IImpactResponse::pointer closest(double relpitch) const
+    {
+        if (std::abs(relpitch) > 0.5 * m_nwires * m_pitch) {
+            THROW(ValueError() << errmsg{"relative pitch outside PIR extent"});
+        }
+        return m_irs.at(std::round(relpitch / m_impact) + m_nwires * 5);
+    }
+    virtual TwoImpactResponses bounded(double relpitch) const { return TwoImpactResponses(nullptr, nullptr); }
+    virtual double pitch_range() const { return m_nwires * m_pitch; }
+    virtual int nwires() const { return m_nwires; }
+    virtual double pitch() const { return m_pitch; }
+    virtual double impact() const { return m_impact; }
+    virtual size_t nbins() const { return m_nbins; }
+};
+
+const int nwires = 40;
+const int nticks = 128;
+
+// Return the waveforms of one event.  Events differ in their depos
+// and so in the window of ticks they span.
+static std::vector<Waveform::realseq_t> event_waveforms(IPlaneImpactResponse::pointer pir, IDFT::pointer dft,
+                                                        int event)
+{
+    Pimpos pimpos(nwires, -60 * units::mm, 60 * units::mm);
+    Binning tbins(nticks, 0, nticks * 0.5 * units::us);
+    Gen::BinnedDiffusion_transform bd(pimpos, tbins, 3.0, nullptr);
+    for (int ind = 0; ind <= event; ++ind) {
+        auto depo = std::make_shared<Aux::SimpleDepo>((10 + 5 * ind + 3 * event) * units::us,
+                                                      Point(0, 0, (-5 + 4 * ind + event) * units::mm), 1000.0);
+        bd.add(depo, (1 + 0.5 * ind) * units::us, 1 * units::mm);
+    }
+    Gen::ImpactTransform it(pir, dft, bd);
+    std::vector<Waveform::realseq_t> ret;
+    for (int iwire = 0; iwire < nwires; ++iwire) {
+        ret.push_back(it.waveform(iwire));
+    }
+    return ret;
+}
+
+int main()
+{
+    PluginManager& pm = PluginManager::instance();
+    pm.add("WireCellAux");
+    auto dft = Factory::lookup_tn<IDFT>("FftwDFT");
+
+    const int nevents = 3;
+    for (bool with_long : {false, true}) {
+        auto pir = std::make_shared<MockPIR>(dft, with_long);
+
+        Gen::ImpactTransform::clear_cache();
+        std::vector<std::vector<Waveform::realseq_t> > warm;
+        for (int event = 0; event < nevents; ++event) {
+            warm.push_back(event_waveforms(pir, dft, event));
+        }
+        Assert(pir.use_count() > 1);
+
+        for (int event = nevents - 1; event >= 0; --event) {
+            Gen::ImpactTransform::clear_cache();
+            Assert(pir.use_count() == 1);
+            auto cold = event_waveforms(pir, dft, event);
+            double sum = 0;
+            for (int iwire = 0; iwire < nwires; ++iwire) {
+                Assert(cold[iwire] == warm[event][iwire]);
+                for (auto val : cold[iwire]) {
+                    sum += std::abs(val);
+                }
+            }
+            std::cerr << "long=" << with_long << " event=" << event << " sum=" << sum << "\n";
+            Assert(sum > 0);
+        }
+        Gen::ImpactTransform::clear_cache();
+        Assert(pir.use_count() == 1);
+
+        // Evicting or not caching spectra gives the same.
+        for (size_t capacity : {0, 1}) {
+            Gen::ImpactTransform::set_cache_capacity(capacity);
+            for (int event = 0; event < nevents; ++event) {
+                Assert(event_waveforms(pir, dft, event) == warm[event]);
+            }
+        }
+        Gen::ImpactTransform::set_cache_capacity(4);
+        Gen::ImpactTransform::clear_cache();
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+/** Check that Misconfigure and PerChannelVariation replace the "from"
+ * electronics response of a trace with the "to" response and not the
+ * other way around.
+ *
+ * The input trace is a signal convolved with the "from" response.  The
+ * output must then match the same signal convolved with the "to"
+ * response.  The trace is made long enough that neither convolution
+ * is truncated.
+ */
+
+#include "WireCellGen/Misconfigure.h"
+#include "WireCellGen/PerChannelVariation.h"
+#include "WireCellAux/DftTools.h"
+#include "WireCellAux/SimpleFrame.h"
+#include "WireCellAux/SimpleTrace.h"
+#include "WireCellIface/IChannelResponse.h"
+#include "WireCellUtil/PluginManager.h"
+#include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Response.h"
+#include "WireCellUtil/Testing.h"
+#include "WireCellUtil/Units.h"
+
+#include <cmath>
+#include <iostream>
+
+using namespace WireCell;
+
+const double tick = 0.5 * units::us;
+const int nresp = 50;
+
+// A channel response which is the same cold electronics response for
+// every channel.
+class MockChannelResponse : public IChannelResponse {
+    Waveform::realseq_t m_resp;
+
+   public:
+    MockChannelResponse()
+      : m_resp(Response::ColdElec(4.7 * units::mV / units::fC, 1.1 * units::us).generate(binning()))
+    {
+    }
+    virtual ~MockChannelResponse() {}
+    virtual const Waveform::realseq_t& channel_response(int channel_ident) const { return m_resp; }
+    virtual Binning channel_response_binning() const { return binning(); }
+    static Binning binning() { return Binning(nresp, 0, nresp * tick); }
+};
+
+WIRECELL_FACTORY(MockChannelResponse, MockChannelResponse, WireCell::IChannelResponse)
+
+static Waveform::realseq_t coldelec(double gain, double shaping)
+{
+    return Response::ColdElec(gain, shaping).generate(Binning(nresp, 0, nresp * tick));
+}
+
+// Return the signal convolved with the response, kept to the signal size.
+static Waveform::realseq_t apply(const IDFT::pointer& dft, const Waveform::realseq_t& signal,
+                                 const Waveform::realseq_t& resp)
+{
+    auto wave = Aux::DftTools::convolve(dft, signal, resp);
+    wave.resize(signal.size());
+    return wave;
+}
+
+// Return the trace of the single trace frame that the filter makes
+// from the given waveform.
+static Waveform::realseq_t filter(IFrameFilter& ff, const Waveform::realseq_t& wave)
+{
+    ITrace::vector traces{std::make_shared<Aux::SimpleTrace>(1, 0, wave)};
+    IFrame::pointer in = std::make_shared<Aux::SimpleFrame>(0, 0, traces, tick);
+    IFrame::pointer out;
+    Assert(ff(in, out));
+    Assert(out);
+    Assert(out->traces()->size() == 1);
+    return out->traces()->at(0)->charge();
+}
+
+static void assert_close(const Waveform::realseq_t& got, const Waveform::realseq_t& want, const std::string& what)
+{
+    Assert(got.size() == want.size());
+    double peak = 0, maxdiff = 0;
+    for (size_t ind = 0; ind < want.size(); ++ind) {
+        peak = std::max(peak, (double) std::abs(want[ind]));
+        maxdiff = std::max(maxdiff, (double) std::abs(got[ind] - want[ind]));
+    }
+    std::cerr << what << ": peak=" << peak << " maxdiff=" << maxdiff << "\n";
+    AssertMsg(maxdiff < 1e-3 * peak, "output does not carry the \"to\" response");
+}
+
+int main(int argc, char* argv[])
+{
+    PluginManager& pm = PluginManager::instance();
+    pm.add("WireCellAux");
+    // for this test we cheat since the factory isn't in a shared library.
+    make_MockChannelResponse_factory();
+
+    auto dft = Factory::lookup_tn<IDFT>("FftwDFT");
+    Factory::lookup_tn<IChannelResponse>("MockChannelResponse");
+
+    const double from_gain = 14.0 * units::mV / units::fC, from_shaping = 2.2 * units::us;
+    const double to_gain = 4.7 * units::mV / units::fC, to_shaping = 1.1 * units::us;
+    auto from = coldelec(from_gain, from_shaping);
+    auto to = coldelec(to_gain, to_shaping);
+
+    // Some charge early in a trace of a length which is not an FFT
+    // best length.
+    Waveform::realseq_t signal(389, 0);
+    signal[10] = 1000;
+    signal[50] = 500;
+    signal[51] = 700;
+    signal[120] = -300;
+    signal[200] = 2000;
+
+    auto meas = apply(dft, signal, from);
+    auto want = apply(dft, signal, to);
+
+    {
+        Gen::Misconfigure mc;
+        auto cfg = mc.default_configuration();
+        cfg["from"]["gain"] = from_gain;
+        cfg["from"]["shaping"] = from_shaping;
+        cfg["to"]["gain"] = to_gain;
+        cfg["to"]["shaping"] = to_shaping;
+        cfg["nsamples"] = nresp;
+        cfg["tick"] = tick;
+        mc.configure(cfg);
+        assert_close(filter(mc, meas), want, "Misconfigure");
+    }
+    {
+        Gen::PerChannelVariation pcv;
+        auto cfg = pcv.default_configuration();
+        cfg["gain"] = from_gain;
+        cfg["shaping"] = from_shaping;
+        cfg["tick"] = tick;
+        cfg["per_chan_resp"] = "MockChannelResponse";
+        pcv.configure(cfg);
+        assert_close(filter(pcv, meas), want, "PerChannelVariation");
+    }
+
+    return 0;
+}
@@ -57,6 +57,19 @@ void test_named(std::string generator_name)
         rndcfg->configure(cfg);
     }
 
+    // The configuration reports the generator in use so a copy made
+    // from it, as DepoTransform does, draws the same numbers.
+    {
+        auto cfg = rndcfg->default_configuration();
+        Assert(cfg["generator"].asString() == generator_name);
+        auto copy = Factory::lookup<IRandom>(gen_random_name, "copy_" + generator_name);
+        Factory::lookup<IConfigurable>(gen_random_name, "copy_" + generator_name)->configure(cfg);
+        for (int ind = 0; ind < 5; ++ind) {
+            Assert(copy->range(0, 1000000) == rnd->range(0, 1000000));
+        }
+        rndcfg->configure(cfg);
+    }
+
     // Beware, this is evil.  Busting out the shared pointer and using
     // histify<> here is just to save some typing in this test.  It's
     // okay in this test because histify<> goes not live longer than
@@ -2,9 +2,11 @@
 #define WIRECELL_ICHANNELFILTER
 
 #include "WireCellUtil/Waveform.h"
+#include "WireCellUtil/Array.h"
 #include "WireCellUtil/IComponent.h"
 
 #include <map>
+#include <vector>
 
 namespace WireCell {
 
@@ -27,6 +29,15 @@ namespace WireCell {
          * channel mask map with any tick-level masking that may be
          * applied later.*/
         virtual Waveform::ChannelMaskMap apply(channel_signals_t& chansig) const = 0;
+
+        /** Filter in place a block of signals, one row for each of
+         * the `channels` and one column per tick.  Return a channel
+         * mask map as above.  The default applies the single channel
+         * apply() to each row.  Filters that can do better with all
+         * channels at once, such as with batched DFTs, may override
+         * this. */
+        virtual Waveform::ChannelMaskMap apply_block(const std::vector<int>& channels,
+                                                     Array::array_xxf& block) const;
     };
 
 }  // namespace WireCell
@@ -78,6 +78,24 @@ namespace WireCell {
 
         /// Return channels which are considered a'priori "misconfigured".
         virtual channel_group_t miscfg_channels() const { return channel_group_t(); }
+
+        /// All per-channel values for one channel.  The filters
+        /// point to storage held by the database which is valid
+        /// until it is next configured.
+        struct ChannelParams {
+            int channel{0};
+            double nominal_baseline{0}, gain_correction{1}, response_offset{0};
+            double min_rms_cut{0}, max_rms_cut{0};
+            int pad_window_front{0}, pad_window_back{0};
+            float decon_limit{0}, decon_lf_cutoff{0}, adc_limit{0}, decon_limit1{0};
+            float protection_factor{0}, min_adc_limit{0}, roi_min_max_ratio{0};
+            const filter_t *rcrc{nullptr}, *config{nullptr}, *noise{nullptr}, *response{nullptr};
+        };
+
+        /// Return the values for each of the given channels, in
+        /// order.  This replaces many single value calls per channel
+        /// with one.  The default uses the single value methods.
+        virtual std::vector<ChannelParams> channel_params(const channel_group_t& channels) const;
     };
 
 }  // namespace WireCell
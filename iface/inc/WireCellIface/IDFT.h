@@ -3,6 +3,7 @@
 
 #include "WireCellUtil/IComponent.h"
 #include <complex>
+#include <memory>
 
 namespace WireCell {
 
@@ -37,6 +38,21 @@ namespace WireCell {
         There is also a special rank=0 DFT on rank=2 arrays which is
         more commonly known as a "matrix transpose".
 
+        Each of the 6 has a real-valued counterpart: the "r2c" forward
+        transforms take real input and the "c2r" inverse transforms
+        give real output.  Like numpy.fft.rfft() they hold only the
+        non-negative frequency half of the Hermitian-symmetric
+        spectrum.  A transform of size n along an axis gives n/2+1
+        complex values along that axis.  The 2d forms halve the last
+        (column) dimension as does numpy.fft.rfft2().  The c2r methods
+        assume Hermitian symmetry (the imaginary parts of the zero and
+        any Nyquist frequency bins are ignored) and the "nrows" and
+        "ncols" arguments always give the shape of the real array.
+        The IDFT interface provides r2c/c2r methods implemented with
+        complex transforms and an implementation SHOULD override them
+        to save about half the work.  The r2c/c2r methods do not allow
+        the input and output arrays to be identical.
+
         Requirements on implementations:
 
         - Forward transforms SHALL NOT apply normalization.
@@ -70,6 +86,17 @@ namespace WireCell {
           point.  Functions and methods to easily convert between the
           two exist.
 
+        - Callers applying the same transform many times may ask for a
+          "plan" once and call it repeatedly.  A plan is fixed to a
+          transform type, direction and (nrows, ncols, axis) shape
+          and a 1d transform of size n is the 1b transform of shape
+          (1, n, 1).  Calling a plan SHALL NOT require locking or
+          lookup.  An inverse plan may be made with normalization
+          deferred to the caller, who may then fold the 1/n factor
+          into subsequent arithmetic.  Plans are safe to call
+          concurrently and remain valid for the lifetime of the IDFT
+          which made them.
+
         - Eigen arrays are column-wise by default and so their
           arr.data() method can not directly supply input to this
           interface.  Likewise, use of arr.transpose().data() may run
@@ -115,6 +142,28 @@ namespace WireCell {
                    int nrows, int ncols) const = 0;
 
 
+        // r2c / c2r, see comments above for the shape of the
+        // half-spectrum arrays.
+
+        virtual
+        void fwd1d_r2c(const scalar_t* in, complex_t* out, int size) const;
+        virtual
+        void inv1d_c2r(const complex_t* in, scalar_t* out, int size) const;
+
+        virtual
+        void fwd1b_r2c(const scalar_t* in, complex_t* out,
+                       int nrows, int ncols, int axis) const;
+        virtual
+        void inv1b_c2r(const complex_t* in, scalar_t* out,
+                       int nrows, int ncols, int axis) const;
+
+        virtual
+        void fwd2d_r2c(const scalar_t* in, complex_t* out,
+                       int nrows, int ncols) const;
+        virtual
+        void inv2d_c2r(const complex_t* in, scalar_t* out,
+                       int nrows, int ncols) const;
+
         // Fill "out" with the transpose of "in", may be in-place.
         // The nrows/ncols refers to the shape of the input.
         virtual
@@ -123,6 +172,39 @@ namespace WireCell {
         virtual
         void transpose(const complex_t* in, complex_t* out,
                        int nrows, int ncols) const;
+
+        // Plans, see comments above.
+
+        /// A transform of fixed shape applied as plan(in, out).  The
+        /// arrays follow the same rules as the methods.
+        template<typename InType, typename OutType>
+        class Plan {
+          public:
+            using pointer = std::shared_ptr<const Plan>;
+            virtual ~Plan() {}
+            virtual void operator()(const InType* in, OutType* out) const = 0;
+        };
+        using c2c_plan = Plan<complex_t, complex_t>;
+        using r2c_plan = Plan<scalar_t, complex_t>;
+        using c2r_plan = Plan<complex_t, scalar_t>;
+
+        // The defaults wrap the corresponding methods.  An
+        // implementation SHOULD override them to skip its per-call
+        // overhead.  When normalize is false, the inverse plans give
+        // results which are n times those of the inverse methods
+        // where n is the size along the axis.
+
+        virtual
+        c2c_plan::pointer plan_fwd1b(int nrows, int ncols, int axis) const;
+        virtual
+        c2c_plan::pointer plan_inv1b(int nrows, int ncols, int axis,
+                                     bool normalize = true) const;
+
+        virtual
+        r2c_plan::pointer plan_fwd1b_r2c(int nrows, int ncols, int axis) const;
+        virtual
+        c2r_plan::pointer plan_inv1b_c2r(int nrows, int ncols, int axis,
+                                         bool normalize = true) const;
         
      };
 }
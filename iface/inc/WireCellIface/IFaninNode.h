@@ -23,6 +23,25 @@ namespace WireCell {
         /// The calling signature:
         virtual bool operator()(const any_vector& anyin, boost::any& anyout) = 0;
 
+        typedef std::vector<Payload> payload_vector;
+
+        /// The calling signature used by the graph engines.  This
+        /// default goes through the boost::any level.
+        virtual bool operator()(const payload_vector& in, Payload& out)
+        {
+            any_vector anyin;
+            anyin.reserve(in.size());
+            for (const auto& p : in) {
+                anyin.push_back(p.any());
+            }
+            boost::any anyout;
+            bool ok = (*this)(anyin, anyout);
+            if (ok) {
+                out = std::move(anyout);
+            }
+            return ok;
+        }
+
         virtual NodeCategory category() { return faninNode; }
     };
 
@@ -41,14 +60,31 @@ namespace WireCell {
         virtual bool operator()(const any_vector& anyv, boost::any& anyout)
         {
             input_vector invec;
-            for (auto a : anyv) {
-                auto in = boost::any_cast<input_pointer>(a);
-                invec.push_back(in);
+            invec.reserve(anyv.size());
+            for (const auto& a : anyv) {
+                invec.push_back(boost::any_cast<const input_pointer&>(a));
             }
             output_pointer out;
             bool ok = (*this)(invec, out);
             if (ok) {
-                anyout = out;
+                anyout = std::move(out);
+            }
+            return ok;
+        }
+
+        /// Engines check port types at connect time so the input
+        /// pointers are taken without a type check.
+        virtual bool operator()(const payload_vector& in, Payload& out)
+        {
+            input_vector invec;
+            invec.reserve(in.size());
+            for (const auto& p : in) {
+                invec.push_back(p.get_unchecked<input_pointer>());
+            }
+            output_pointer outp;
+            bool ok = (*this)(invec, outp);
+            if (ok) {
+                out = std::move(outp);
             }
             return ok;
         }
@@ -22,6 +22,19 @@ namespace WireCell {
         /// The calling signature:
         virtual bool operator()(const boost::any& anyin, any_vector& anyout) = 0;
 
+        typedef std::vector<Payload> payload_vector;
+
+        /// The calling signature used by the graph engines.  This
+        /// default goes through the boost::any level.
+        virtual bool operator()(const Payload& in, payload_vector& out)
+        {
+            any_vector anyout;
+            bool ok = (*this)(in.any(), anyout);
+            if (!ok) return false;
+            out.assign(anyout.begin(), anyout.end());
+            return true;
+        }
+
         virtual NodeCategory category() { return fanoutNode; }
     };
 
@@ -46,7 +59,22 @@ namespace WireCell {
             const size_t mult = output_types().size();  // don't use FanoutMultiplicity
             anyv.resize(mult);
             for (size_t ind = 0; ind < mult; ++ind) {
-                anyv[ind] = outv[ind];
+                anyv[ind] = std::move(outv[ind]);
+            }
+            return true;
+        }
+
+        /// Engines check port types at connect time so the input
+        /// pointer is taken without a type check.
+        virtual bool operator()(const Payload& in, payload_vector& out)
+        {
+            output_vector outv;
+            bool ok = (*this)(in.get_unchecked<input_pointer>(), outv);
+            if (!ok) return false;
+            const size_t mult = output_types().size();  // don't use FanoutMultiplicity
+            out.resize(mult);
+            for (size_t ind = 0; ind < mult; ++ind) {
+                out[ind] = std::move(outv[ind]);
             }
             return true;
         }
@@ -19,6 +19,17 @@ namespace WireCell {
         /// The calling signature:
         virtual bool operator()(const boost::any& anyin, boost::any& anyout) = 0;
 
+        /// The calling signature used by the graph engines.  This
+        /// default goes through the boost::any level.
+        virtual bool operator()(const Payload& in, Payload& out)
+        {
+            boost::any anyout;
+            bool ok = (*this)(in.any(), anyout);
+            if (!ok) return false;
+            out = std::move(anyout);
+            return true;
+        }
+
         virtual NodeCategory category() { return functionNode; }
     };
 
@@ -42,7 +53,18 @@ namespace WireCell {
             output_pointer out;
             bool ok = (*this)(in, out);
             if (!ok) return false;
-            anyout = out;
+            anyout = std::move(out);
+            return true;
+        }
+
+        /// Engines check port types at connect time so the input
+        /// pointer is taken without a type check.
+        virtual bool operator()(const Payload& in, Payload& out)
+        {
+            output_pointer outp;
+            bool ok = (*this)(in.get_unchecked<input_pointer>(), outp);
+            if (!ok) return false;
+            out = std::move(outp);
             return true;
         }
 
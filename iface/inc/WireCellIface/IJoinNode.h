@@ -26,6 +26,25 @@ namespace WireCell {
         /// The calling signature:
         virtual bool operator()(const any_vector& anyin, boost::any& anyout) = 0;
 
+        typedef std::vector<Payload> payload_vector;
+
+        /// The calling signature used by the graph engines.  This
+        /// default goes through the boost::any level.
+        virtual bool operator()(const payload_vector& in, Payload& out)
+        {
+            any_vector anyin;
+            anyin.reserve(in.size());
+            for (const auto& p : in) {
+                anyin.push_back(p.any());
+            }
+            boost::any anyout;
+            bool ok = (*this)(anyin, anyout);
+            if (ok) {
+                out = std::move(anyout);
+            }
+            return ok;
+        }
+
         virtual NodeCategory category() { return joinNode; }
     };
 
@@ -51,7 +70,22 @@ namespace WireCell {
             output_pointer out;
             bool ok = (*this)(intup, out);
             if (ok) {
-                anyout = out;
+                anyout = std::move(out);
+            }
+            return ok;
+        }
+
+        /// Engines check port types at connect time so the input
+        /// pointers are taken without a type check.
+        virtual bool operator()(const payload_vector& in, Payload& out)
+        {
+            input_helper_type ih;
+            auto intup = ih.from_payload(in);
+
+            output_pointer outp;
+            bool ok = (*this)(intup, outp);
+            if (ok) {
+                out = std::move(outp);
             }
             return ok;
         }
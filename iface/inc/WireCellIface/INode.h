@@ -3,6 +3,7 @@
 #define WIRECELL_INODE
 
 #include "WireCellUtil/IComponent.h"
+#include "WireCellUtil/Payload.h"
 
 #include <boost/any.hpp>
 
@@ -43,14 +44,16 @@ namespace WireCell {
 
         // Subclasses may override to provide the number of instances
         // that can run concurrently.  Default is 1.  Return 0 for
-        // unlimited.  It is expected that NO node has concurency
-        // other than unity for two reasons: 1) The node itself must
-        // not have mutable data which tends not to be possible.  2)
-        // Concurent running of the same node violates fairly
-        // pervasive ordering assumptions for downstreadm nodes.  If
-        // you think your node should run concurrently with itself,
-        // test carefully with full graphs and with TbbFlow given more
-        // than one thread.  See #121 for some more details.
+        // unlimited.  A node returning other than unity must not have
+        // mutable data (or must protect it) as its operator() may be
+        // called from multiple threads at once.  TbbFlow restores the
+        // order of output of such nodes with sequence numbers so that
+        // downstream nodes see data in the order of the input.  Only
+        // the function, queuedout, sink, join, fanin and fanout
+        // categories honor this.  If you think your node should run
+        // concurrently with itself, test carefully with full graphs
+        // and with TbbFlow given more than one thread.  See #121 for
+        // some more details.
         virtual int concurrency() { return 1; }
 
         // Return string representations of the C++ types this node takes as input.
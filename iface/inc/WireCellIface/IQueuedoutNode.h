@@ -22,6 +22,21 @@ namespace WireCell {
         /// The calling signature:
         virtual bool operator()(const boost::any& anyin, queuedany& out) = 0;
 
+        typedef std::deque<Payload> payload_queue;
+
+        /// The calling signature used by the graph engines.  This
+        /// default goes through the boost::any level.
+        virtual bool operator()(const Payload& in, payload_queue& out)
+        {
+            queuedany outanyq;
+            bool ok = (*this)(in.any(), outanyq);
+            if (!ok) return false;
+            for (auto& o : outanyq) {
+                out.push_back(std::move(o));
+            }
+            return true;
+        }
+
         virtual NodeCategory category() { return queuedoutNode; }
     };
 
@@ -44,8 +59,21 @@ namespace WireCell {
             output_queue outq;
             bool ok = (*this)(in, outq);
             if (!ok) return false;
-            for (auto o : outq) {  // transfer typed to any
-                outanyq.push_back(o);
+            for (auto& o : outq) {  // transfer typed to any
+                outanyq.push_back(std::move(o));
+            }
+            return true;
+        }
+
+        /// Engines check port types at connect time so the input
+        /// pointer is taken without a type check.
+        virtual bool operator()(const Payload& in, payload_queue& outq)
+        {
+            output_queue typedq;
+            bool ok = (*this)(in.get_unchecked<input_pointer>(), typedq);
+            if (!ok) return false;
+            for (auto& o : typedq) {
+                outq.push_back(std::move(o));
             }
             return true;
         }
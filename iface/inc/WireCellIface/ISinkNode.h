@@ -19,6 +19,10 @@ namespace WireCell {
         virtual NodeCategory category() { return sinkNode; }
 
         virtual bool operator()(const boost::any& in) = 0;
+
+        /// The calling signature used by the graph engines.  This
+        /// default goes through the boost::any level.
+        virtual bool operator()(const Payload& in) { return (*this)(in.any()); }
     };
 
     template <typename InputType>
@@ -36,6 +40,10 @@ namespace WireCell {
             return (*this)(in);
         }
 
+        /// Engines check port types at connect time so the input
+        /// pointer is taken without a type check.
+        virtual bool operator()(const Payload& in) { return (*this)(in.get_unchecked<input_pointer>()); }
+
         virtual std::string signature() { return typeid(signature_type).name(); }
 
         /// The calling signature:
@@ -19,6 +19,23 @@ namespace WireCell {
         virtual NodeCategory category() { return sourceNode; }
 
         virtual bool operator()(boost::any& anyout) = 0;
+
+        /// The calling signature used by the graph engines.  This
+        /// default goes through the boost::any level.
+        virtual bool operator()(Payload& out)
+        {
+            boost::any anyout;
+            bool ok = (*this)(anyout);
+            if (!ok) return false;
+            out = std::move(anyout);
+            return true;
+        }
+
+        /// Return true if this source itself skips the events which
+        /// are not in the Shard of this process (see "wire-cell
+        /// --workers").  A source which is not sharded() produces
+        /// all of its output in every worker process.
+        virtual bool sharded() const { return false; }
     };
 
     template <typename OutputType>
@@ -43,11 +60,20 @@ namespace WireCell {
             output_pointer out;
             bool ok = (*this)(out);
             if (!ok) return false;
-            anyout = out;
+            anyout = std::move(out);
 
             return true;
         }
 
+        virtual bool operator()(Payload& out)
+        {
+            output_pointer outp;
+            bool ok = (*this)(outp);
+            if (!ok) return false;
+            out = std::move(outp);
+            return true;
+        }
+
         /// The calling signature:
         virtual bool operator()(output_pointer& out) = 0;
 
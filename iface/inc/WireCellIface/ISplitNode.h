@@ -26,6 +26,19 @@ namespace WireCell {
         /// The calling signature:
         virtual bool operator()(const boost::any& anyin, any_vector& anyout) = 0;
 
+        typedef std::vector<Payload> payload_vector;
+
+        /// The calling signature used by the graph engines.  This
+        /// default goes through the boost::any level.
+        virtual bool operator()(const Payload& in, payload_vector& out)
+        {
+            any_vector anyout;
+            bool ok = (*this)(in.any(), anyout);
+            if (!ok) return false;
+            out.assign(anyout.begin(), anyout.end());
+            return true;
+        }
+
         virtual NodeCategory category() { return splitNode; }
     };
 
@@ -57,6 +70,20 @@ namespace WireCell {
             return ok;
         }
 
+        /// Engines check port types at connect time so the input
+        /// pointer is taken without a type check.
+        virtual bool operator()(const Payload& in, payload_vector& out)
+        {
+            output_tuple_type outtup;
+            output_helper_type oh;
+
+            bool ok = (*this)(in.get_unchecked<input_pointer>(), outtup);
+            if (ok) {
+                out = oh.as_payload(outtup);
+            }
+            return ok;
+        }
+
         virtual bool operator()(const input_pointer& in, output_tuple_type& out) = 0;
 
         // Return the names of the types this node takes as input.
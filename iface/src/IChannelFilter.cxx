@@ -0,0 +1,34 @@
+#include "WireCellIface/IChannelFilter.h"
+#include "WireCellUtil/Exceptions.h"
+
+using namespace WireCell;
+
+Waveform::ChannelMaskMap IChannelFilter::apply_block(const std::vector<int>& channels,
+                                                     Array::array_xxf& block) const
+{
+    const int nrows = block.rows();
+    const int ncols = block.cols();
+    if (nrows != (int) channels.size()) {
+        THROW(ValueError() << errmsg{"IChannelFilter: block rows do not match number of channels"});
+    }
+
+    Waveform::ChannelMaskMap ret;
+    std::map<std::string, std::string> same_names;
+    signal_t signal(ncols);
+    for (int irow = 0; irow < nrows; ++irow) {
+        for (int icol = 0; icol < ncols; ++icol) {
+            signal[icol] = block(irow, icol);
+        }
+
+        auto masks = apply(channels[irow], signal);
+        Waveform::merge(ret, masks, same_names);
+
+        if ((int) signal.size() != ncols) {
+            THROW(ValueError() << errmsg{"IChannelFilter: filter changed the signal length"});
+        }
+        for (int icol = 0; icol < ncols; ++icol) {
+            block(irow, icol) = signal[icol];
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,33 @@
+#include "WireCellIface/IChannelNoiseDatabase.h"
+
+using namespace WireCell;
+
+std::vector<IChannelNoiseDatabase::ChannelParams>
+IChannelNoiseDatabase::channel_params(const channel_group_t& channels) const
+{
+    std::vector<ChannelParams> ret(channels.size());
+    for (size_t ind = 0; ind < channels.size(); ++ind) {
+        const int ch = channels[ind];
+        auto& cp = ret[ind];
+        cp.channel = ch;
+        cp.nominal_baseline = nominal_baseline(ch);
+        cp.gain_correction = gain_correction(ch);
+        cp.response_offset = response_offset(ch);
+        cp.min_rms_cut = min_rms_cut(ch);
+        cp.max_rms_cut = max_rms_cut(ch);
+        cp.pad_window_front = pad_window_front(ch);
+        cp.pad_window_back = pad_window_back(ch);
+        cp.decon_limit = coherent_nf_decon_limit(ch);
+        cp.decon_lf_cutoff = coherent_nf_decon_lf_cutoff(ch);
+        cp.adc_limit = coherent_nf_adc_limit(ch);
+        cp.decon_limit1 = coherent_nf_decon_limit1(ch);
+        cp.protection_factor = coherent_nf_protection_factor(ch);
+        cp.min_adc_limit = coherent_nf_min_adc_limit(ch);
+        cp.roi_min_max_ratio = coherent_nf_roi_min_max_ratio(ch);
+        cp.rcrc = &rcrc(ch);
+        cp.config = &config(ch);
+        cp.noise = &noise(ch);
+        cp.response = &response(ch);
+    }
+    return ret;
+}
@@ -1,5 +1,7 @@
 #include "WireCellIface/IDFT.h"
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 #include <utility>              // std::swap since c++11
 
@@ -42,6 +44,93 @@ void IDFT::inv1b(const complex_t* in, complex_t* out,
     }
 }
 
+// Default r2c/c2r implementations in terms of the complex transforms.
+// They cost as much as the complex transforms and implementations
+// should override them with native real transforms.
+
+void IDFT::fwd1d_r2c(const scalar_t* in, complex_t* out, int size) const
+{
+    std::vector<complex_t> tmp(in, in + size);
+    fwd1d(tmp.data(), tmp.data(), size);
+    std::copy(tmp.begin(), tmp.begin() + size/2 + 1, out);
+}
+
+// Fill the full spectrum of given size from its non-negative half.
+static void hermitian_full(const IDFT::complex_t* half, IDFT::complex_t* full, int size)
+{
+    const int nhalf = size/2 + 1;
+    std::copy(half, half + nhalf, full);
+    full[0] = std::real(full[0]);
+    if (size % 2 == 0) {
+        full[size/2] = std::real(full[size/2]);
+    }
+    for (int ind = nhalf; ind < size; ++ind) {
+        full[ind] = std::conj(half[size - ind]);
+    }
+}
+
+void IDFT::inv1d_c2r(const complex_t* in, scalar_t* out, int size) const
+{
+    std::vector<complex_t> tmp(size);
+    hermitian_full(in, tmp.data(), size);
+    inv1d(tmp.data(), tmp.data(), size);
+    for (int ind=0; ind<size; ++ind) {
+        out[ind] = std::real(tmp[ind]);
+    }
+}
+
+void IDFT::fwd1b_r2c(const scalar_t* in, complex_t* out,
+                     int nrows, int ncols, int axis) const
+{
+    if (axis) {
+        const int nhalf = ncols/2 + 1;
+        for (int irow=0; irow<nrows; ++irow) {
+            fwd1d_r2c(in+irow*ncols, out+irow*nhalf, ncols);
+        }
+        return;
+    }
+    const int nhalf = nrows/2 + 1;
+    std::vector<scalar_t> tin(nrows*ncols);
+    std::vector<complex_t> tout(ncols*nhalf);
+    this->transpose(in, tin.data(), nrows, ncols);
+    this->fwd1b_r2c(tin.data(), tout.data(), ncols, nrows, 1);
+    this->transpose(tout.data(), out, ncols, nhalf);
+}
+
+void IDFT::inv1b_c2r(const complex_t* in, scalar_t* out,
+                     int nrows, int ncols, int axis) const
+{
+    if (axis) {
+        const int nhalf = ncols/2 + 1;
+        for (int irow=0; irow<nrows; ++irow) {
+            inv1d_c2r(in+irow*nhalf, out+irow*ncols, ncols);
+        }
+        return;
+    }
+    const int nhalf = nrows/2 + 1;
+    std::vector<complex_t> tin(nhalf*ncols);
+    std::vector<scalar_t> tout(ncols*nrows);
+    this->transpose(in, tin.data(), nhalf, ncols);
+    this->inv1b_c2r(tin.data(), tout.data(), ncols, nrows, 1);
+    this->transpose(tout.data(), out, ncols, nrows);
+}
+
+void IDFT::fwd2d_r2c(const scalar_t* in, complex_t* out,
+                     int nrows, int ncols) const
+{
+    this->fwd1b_r2c(in, out, nrows, ncols, 1);
+    this->fwd1b(out, out, nrows, ncols/2 + 1, 0);
+}
+
+void IDFT::inv2d_c2r(const complex_t* in, scalar_t* out,
+                     int nrows, int ncols) const
+{
+    const int nhalf = ncols/2 + 1;
+    std::vector<complex_t> tmp(in, in + nrows*nhalf);
+    this->inv1b(tmp.data(), tmp.data(), nrows, nhalf, 0);
+    this->inv1b_c2r(tmp.data(), out, nrows, ncols, 1);
+}
+
 // Trivial default transpose.  Implementations, please override if you
 // can offer something faster.
 
@@ -93,3 +182,72 @@ void IDFT::transpose(const IDFT::complex_t* in, IDFT::complex_t* out,
 {
     transpose_type(in, out, nrows, ncols);
 }
+
+
+// Default plans simply call the corresponding method.
+
+template<typename InType, typename OutType>
+class MethodPlan : public IDFT::Plan<InType, OutType> {
+  public:
+    using method_t = std::function<void(const InType*, OutType*)>;
+
+    // A non-unity scale is applied to the nout output values.
+    MethodPlan(method_t method, size_t nout, float scale)
+      : m_method(method), m_nout(nout), m_scale(scale) {}
+    virtual ~MethodPlan() {}
+
+    virtual void operator()(const InType* in, OutType* out) const {
+        m_method(in, out);
+        if (m_scale == 1.0) {
+            return;
+        }
+        for (size_t ind=0; ind<m_nout; ++ind) {
+            out[ind] *= m_scale;
+        }
+    }
+  private:
+    method_t m_method;
+    size_t m_nout;
+    float m_scale;
+};
+
+// Undo the 1/n normalization of an inverse method.
+static float denormalize(int nrows, int ncols, int axis, bool normalize)
+{
+    if (normalize) {
+        return 1.0;
+    }
+    return axis ? ncols : nrows;
+}
+
+IDFT::c2c_plan::pointer IDFT::plan_fwd1b(int nrows, int ncols, int axis) const
+{
+    return std::make_shared<MethodPlan<complex_t, complex_t>>(
+        [this, nrows, ncols, axis](const complex_t* in, complex_t* out) {
+            this->fwd1b(in, out, nrows, ncols, axis);
+        }, nrows*ncols, 1.0);
+}
+
+IDFT::c2c_plan::pointer IDFT::plan_inv1b(int nrows, int ncols, int axis, bool normalize) const
+{
+    return std::make_shared<MethodPlan<complex_t, complex_t>>(
+        [this, nrows, ncols, axis](const complex_t* in, complex_t* out) {
+            this->inv1b(in, out, nrows, ncols, axis);
+        }, nrows*ncols, denormalize(nrows, ncols, axis, normalize));
+}
+
+IDFT::r2c_plan::pointer IDFT::plan_fwd1b_r2c(int nrows, int ncols, int axis) const
+{
+    return std::make_shared<MethodPlan<scalar_t, complex_t>>(
+        [this, nrows, ncols, axis](const scalar_t* in, complex_t* out) {
+            this->fwd1b_r2c(in, out, nrows, ncols, axis);
+        }, 0, 1.0);
+}
+
+IDFT::c2r_plan::pointer IDFT::plan_inv1b_c2r(int nrows, int ncols, int axis, bool normalize) const
+{
+    return std::make_shared<MethodPlan<complex_t, scalar_t>>(
+        [this, nrows, ncols, axis](const complex_t* in, scalar_t* out) {
+            this->inv1b_c2r(in, out, nrows, ncols, axis);
+        }, nrows*ncols, denormalize(nrows, ncols, axis, normalize));
+}
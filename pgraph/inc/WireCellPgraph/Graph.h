@@ -25,6 +25,7 @@
 #include "WireCellPgraph/Node.h"
 #include "WireCellUtil/Logging.h"
 #include "WireCellUtil/ExecMon.h"
+#include "WireCellUtil/TraceEvents.h"
 
 #include <vector>
 #include <unordered_set>
@@ -42,21 +43,44 @@ namespace WireCell {
 
             // Connect two nodes by their given ports.  Return false
             // if they are incompatible.  new nodes will be implicitly
-            // added to the graph.
-            bool connect(Node* tail, Node* head, size_t tpind = 0, size_t hpind = 0);
+            // added to the graph.  A nonzero capacity bounds the
+            // number of data the edge holds: the tail node will not be
+            // called while the edge is full.
+            bool connect(Node* tail, Node* head, size_t tpind = 0, size_t hpind = 0,
+                         size_t capacity = 0);
 
             // return a topological sort of the graph as per Kahn algorithm.
             std::vector<Node*> sort_kahn();
 
-            // Excute the graph until nodes stop delivering
+            // Excute the graph until nodes stop delivering.  Return
+            // false, after warning, if any edge still holds data.
             bool execute();
 
+            // Excute the graph until nodes stop delivering using a
+            // pool of nthreads worker threads.  A node is dispatched
+            // only when it is not already running and none of the
+            // nodes with which it shares an edge are running.  This
+            // lets independent branches (and non-adjacent stages of a
+            // pipeline) run concurrently while keeping each edge
+            // single-producer/single-consumer and data order on it
+            // intact.  Only the node that ran and its neighbors are
+            // reconsidered after each call.  A node with an output
+            // edge holding data is not dispatched unless the consumer
+            // on that edge is stalled so that sources do not run
+            // ahead and fill memory.  With nthreads < 2 this is the same as
+            // execute().  Any exception thrown by a node is rethrown
+            // after all workers have stopped.  The return value is as
+            // for execute().
+            bool execute_threaded(size_t nthreads);
+
             // Excute parents of node or if any parent is not ready,
             // recursively call this method on parent.  Return number
             // of nodes executed.
             int execute_upstream(Node* node);
 
-            // All internal calling of nodes goes through here.
+            // All internal calling of nodes goes through here.  A node
+            // with any full output port is not called and false is
+            // returned.
             bool call_node(Node* node);
 
             // Return false if any node is not connected.
@@ -65,6 +89,11 @@ namespace WireCell {
             // Print out cumulated CPU time for executing each node
             void print_timers(bool include_execmon=false) const;
 
+            // Record each node call which does something to the
+            // tracer.  Set after all nodes are connected.  A null
+            // tracer turns off tracing.
+            void set_tracer(std::shared_ptr<TraceEvents> tracer);
+
            private:
             std::vector<std::pair<Node*, Node*> > m_edges;
             std::unordered_set<Node*> m_nodes;
@@ -73,6 +102,15 @@ namespace WireCell {
             Log::logptr_t l_timer;
             std::unordered_map<Node*, double> m_nodes_timer;
             ExecMon m_em;
+
+            // Tracing, per node name and count of calls doing something.
+            std::shared_ptr<TraceEvents> m_tracer;
+            std::unordered_map<Node*, std::pair<std::string, long> > m_traced;
+
+            bool call_node_traced(Node* node);
+
+            // Return false and warn for each edge still holding data.
+            bool drained();
         };
     }  // namespace Pgraph
 }  // namespace WireCell
@@ -19,6 +19,10 @@ namespace WireCell {
             // Concrete node must return some instance identifier.
             virtual std::string ident() = 0;
 
+            // Concrete node may return a short name, eg for use in a
+            // trace.  Default is the ident().
+            virtual std::string name() { return ident(); }
+
             Port& iport(size_t ind = 0) { return port(Port::input, ind); }
             Port& oport(size_t ind = 0) { return port(Port::output, ind); }
 
@@ -50,6 +50,38 @@
     none, 1 is default and gives summary of time, 2 also includes ExecMon
     tracing.
 
+    An "nthreads" sets the number of worker threads used to execute the
+    graph.  The default of 0 (or 1) gives the original single-threaded,
+    low-memory execution.  Larger values dispatch ready nodes to a pool
+    of threads so that independent branches of the graph (eg, one per
+    APA) run concurrently.  A node is never called concurrently with
+    itself nor with any node with which it shares an edge.
+
+    An edge may be given a "capacity" attribute to bound the number of
+    data it holds.  A node is not called while any of its output edges
+    is full which keeps producers from running far ahead of consumers.
+    A single call may still overfill an edge (eg, a queuedout node).
+    A top level "capacity" sets the default for all edges.  The default
+    of 0 means unbounded.  Too small capacities on edges of graphs
+    which split and later rejoin may stop execution early.
+
+    A "trace" may name a file to which a timeline of all node calls
+    which did something is written in Chrome trace event JSON format
+    (view with chrome://tracing or https://ui.perfetto.dev/).  Each
+    event holds the start and duration, thread index, the count of
+    prior such calls of the node and the depths of its input and
+    output queues just before the call.  Default is empty, no trace.
+
+    Setting "fuse_chains" true replaces each linear chain of function
+    nodes with a single graph node which calls them in turn.  A chain
+    link is an edge between two function nodes where the tail has no
+    other output edge and the head no other input edge.  Fusing saves
+    graph scheduling and keeps each datum with one thread from the
+    start to the end of the chain.  However, with "nthreads" the
+    stages of a fused chain no longer run concurrently, and timers and
+    trace report the chain as one node.  Capacities of edges inside a
+    chain are ignored.  Default is false.
+
  */
 
 #ifndef WIRECELL_PGRAPH_PGRAPHER
@@ -60,6 +92,9 @@
 #include "WireCellAux/Logger.h"
 #include "WireCellPgraph/Graph.h"
 
+#include <memory>
+#include <vector>
+
 namespace WireCell::Pgraph {
 
     class Pgrapher : public Aux::Logger,
@@ -80,6 +115,11 @@ namespace WireCell::Pgraph {
       private:
         Graph m_graph;
         int m_verbosity{1};
+        int m_nthreads{0};
+        int m_capacity{0};
+        std::string m_trace{""};
+        bool m_fuse_chains{false};
+        std::vector<std::unique_ptr<Node>> m_fused;
     };
 
 }  // namespace WireCell::Pgraph
@@ -2,8 +2,7 @@
 #define WIRECELL_PGRAPH_PORT
 
 #include "WireCellUtil/Exceptions.h"
-
-#include <boost/any.hpp>
+#include "WireCellUtil/Payload.h"
 
 #include <string>
 #include <vector>
@@ -13,8 +12,10 @@
 namespace WireCell {
     namespace Pgraph {
 
-        // The type of data passed in the graph.
-        typedef boost::any Data;
+        // The type of data passed in the graph.  Node wrappers take
+        // it without a type check as Graph::connect() checks port
+        // signatures.
+        typedef WireCell::Payload Data;
         // A buffer of data.  It is a std::deque instead of a
         // std::queue so that it may be iterated as well as pushed
         // back into.  Like a British queue, one enters it from the
@@ -36,8 +37,10 @@ namespace WireCell {
             bool isoutput() const;
             Edge edge() const;
 
-            // Connect an edge, returning any previous one.
-            Edge plug(Edge edge);
+            // Connect an edge, returning any previous one.  A
+            // nonzero capacity bounds the number of data the edge
+            // should hold, see full().
+            Edge plug(Edge edge, size_t capacity = 0);
 
             // return edge queue size or 0 if no edge has been plugged
             size_t size() const;
@@ -45,13 +48,27 @@ namespace WireCell {
             // Return true if queue is empty or no edge has been plugged.
             bool empty() const;
 
+            // Return the edge capacity, 0 means unbounded.
+            size_t capacity() const;
+
+            // Return true if the edge has a capacity and holds at
+            // least that many data.  The graph will not call a node
+            // with any full output port.  Note, a single call may
+            // still put more than one datum and so overfill an edge.
+            bool full() const;
+
             // Get the next data.  By default this pops the data off
-            // the queue.  To "peek" at the data, pas false.
+            // the queue.  To "peek" at the data, pas false.  Popped
+            // data is moved out of the queue, peeked data is copied.
             Data get(bool pop = true);
 
             // Put the data onto the queue.
             void put(Data& data);
 
+            // Move the data onto the queue, avoiding a copy of the
+            // held value.
+            void put(Data&& data);
+
             // Get back the associated Node.
             Node* node();
             const Node* node() const;
@@ -66,6 +83,7 @@ namespace WireCell {
             Type m_type;
             std::string m_name, m_sig;
             Edge m_edge;
+            size_t m_capacity{0};
         };
 
         typedef std::vector<Port> PortList;
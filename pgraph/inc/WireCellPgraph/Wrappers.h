@@ -15,6 +15,7 @@
 #include "WireCellIface/IFanoutNode.h"
 #include "WireCellIface/IFaninNode.h"
 #include "WireCellIface/IHydraNode.h"
+#include "WireCellIface/INamed.h"
 
 #include "WireCellUtil/Type.h"
 
@@ -27,7 +28,7 @@ namespace WireCell {
 
         // Node wrappers are constructed with just an INode::pointer
         // and adapt it to Pgraph::Node.  They operate at the
-        // boost::any level and the I*BaseNode INode level.  They are
+        // Payload level and the I*BaseNode INode level.  They are
         // not meant to be constructed directly but through the
         // type-erasing Pgraph::Factory.  Their operator() must return
         // false if their underlying node can not be called or if that
@@ -72,6 +73,16 @@ namespace WireCell {
                 return ss.str();
             }
 
+            virtual std::string name()
+            {
+                std::string ret = WireCell::type(*(m_wcnode.get()));
+                auto inamed = std::dynamic_pointer_cast<INamed>(m_wcnode);
+                if (inamed and !inamed->get_name().empty()) {
+                    ret += ":" + inamed->get_name();
+                }
+                return ret;
+            }
+
            private:
             INode::pointer m_wcnode;
         };
@@ -96,12 +107,12 @@ namespace WireCell {
                     return false;  // don't call me if I've got existing output waiting
                 }
 
-                boost::any obj;
+                Data obj;
                 m_ok = (*m_wcnode)(obj);
                 if (!m_ok) {
                     return false;
                 }
-                oport().put(obj);
+                oport().put(std::move(obj));
                 return true;
             }
         };
@@ -149,13 +160,93 @@ namespace WireCell {
                 if (ip.empty()) {
                     return false;  // don't call me if there is nothing to give me.
                 }
-                boost::any out;
+                Data out;
                 auto in = ip.get();
                 bool ok = (*m_wcnode)(in, out);
                 if (!ok) {
                     return false;
                 }
-                op.put(out);
+                op.put(std::move(out));
+                return true;
+            }
+        };
+
+        // A linear chain of function nodes called in turn as one
+        // node.  Data passes from one node of the chain to the next
+        // without going through an edge.  See Pgrapher "fuse_chains".
+        class FusedFunction : public Pgraph::Node {
+            std::vector<IFunctionNodeBase::pointer> m_wcnodes;
+
+           public:
+            FusedFunction(const std::vector<INode::pointer>& wcnodes)
+            {
+                if (wcnodes.empty()) {
+                    THROW(ValueError() << errmsg{"Pgraph::FusedFunction got no nodes"});
+                }
+                for (auto wcnode : wcnodes) {
+                    auto fnode = std::dynamic_pointer_cast<IFunctionNodeBase>(wcnode);
+                    if (!fnode) {
+                        THROW(ValueError() << errmsg{"Pgraph::FusedFunction got non-function node"});
+                    }
+                    if (!m_wcnodes.empty() and m_wcnodes.back()->output_types() != fnode->input_types()) {
+                        THROW(ValueError() << errmsg{"Pgraph::FusedFunction got mismatched types"});
+                    }
+                    m_wcnodes.push_back(fnode);
+                }
+
+                using Pgraph::Port;
+                m_ports[Port::input].push_back(Port(this, Port::input, m_wcnodes.front()->input_types()[0]));
+                m_ports[Port::output].push_back(Port(this, Port::output, m_wcnodes.back()->output_types()[0]));
+            }
+            virtual ~FusedFunction() {}
+
+            virtual std::string ident()
+            {
+                std::stringstream ss;
+                ss << "<Node fused:[";
+                for (auto wcnode : m_wcnodes) {
+                    ss << " " << WireCell::type(*(wcnode.get()));
+                }
+                ss << " ]>";
+                return ss.str();
+            }
+
+            virtual std::string name()
+            {
+                std::string ret;
+                for (auto wcnode : m_wcnodes) {
+                    if (!ret.empty()) {
+                        ret += "+";
+                    }
+                    ret += WireCell::type(*(wcnode.get()));
+                    auto inamed = std::dynamic_pointer_cast<INamed>(wcnode);
+                    if (inamed and !inamed->get_name().empty()) {
+                        ret += ":" + inamed->get_name();
+                    }
+                }
+                return ret;
+            }
+
+            virtual bool operator()()
+            {
+                Port& op = oport();
+                if (op.size()) {
+                    return false;  // don't call me if I've got existing output waiting
+                }
+                Port& ip = iport();
+                if (ip.empty()) {
+                    return false;  // don't call me if there is nothing to give me.
+                }
+                Data data = ip.get();
+                for (auto wcnode : m_wcnodes) {
+                    Data out;
+                    bool ok = (*wcnode)(data, out);
+                    if (!ok) {
+                        return false;
+                    }
+                    data = std::move(out);
+                }
+                op.put(std::move(data));
                 return true;
             }
         };
@@ -176,12 +267,12 @@ namespace WireCell {
                 if (ip.empty()) {
                     return false;
                 }
-                IQueuedoutNodeBase::queuedany outv;
+                IQueuedoutNodeBase::payload_queue outv;
                 auto in = ip.get();
                 bool ok = (*m_wcnode)(in, outv);
                 if (!ok) return false;
-                for (auto out : outv) {
-                    oport().put(out);
+                for (auto& out : outv) {
+                    oport().put(std::move(out));
                 }
                 return true;
             }
@@ -191,7 +282,7 @@ namespace WireCell {
         class JoinFanin : public PortedNode {
            public:
             typedef INodeBaseType inode_type;
-            typedef typename INodeBaseType::any_vector any_vector;
+            typedef typename INodeBaseType::payload_vector payload_vector;
             typedef typename INodeBaseType::pointer pointer;
 
             JoinFanin(INode::pointer wcnode)
@@ -214,16 +305,16 @@ namespace WireCell {
                         return false;
                     }
                 }
-                any_vector inv(nin);
+                payload_vector inv(nin);
                 for (size_t ind = 0; ind < nin; ++ind) {
                     inv[ind] = iports[ind].get();
                 }
-                boost::any out;
+                Data out;
                 bool ok = (*m_wcnode)(inv, out);
                 if (!ok) {
                     return false;
                 }
-                op.put(out);
+                op.put(std::move(out));
                 return true;
             }
 
@@ -237,7 +328,7 @@ namespace WireCell {
         class SplitFanout : public PortedNode {
            public:
             typedef INodeBaseType inode_type;
-            typedef typename INodeBaseType::any_vector any_vector;
+            typedef typename INodeBaseType::payload_vector payload_vector;
             typedef typename INodeBaseType::pointer pointer;
 
             SplitFanout(INode::pointer wcnode)
@@ -268,14 +359,14 @@ namespace WireCell {
 
                 auto in = ip.get();
 
-                any_vector outv(nout);
+                payload_vector outv(nout);
                 bool ok = (*m_wcnode)(in, outv);
                 if (!ok) {
                     return false;
                 }
                 // std::cerr << "SplitFanout: " << nout << " " << outv.size() << std::endl;
                 for (size_t ind = 0; ind < nout; ++ind) {
-                    oports[ind].put(outv[ind]);
+                    oports[ind].put(std::move(outv[ind]));
                 }
                 return true;
             }
@@ -334,7 +425,9 @@ namespace WireCell {
                     if (edge->empty()) {
                         continue;
                     }
-                    inqv[ind].insert(inqv[ind].begin(), edge->begin(), edge->end());
+                    for (const auto& data : *edge) {
+                        inqv[ind].push_back(data.any());
+                    }
                 }
 
                 auto& oports = output_ports();
@@ -365,7 +458,9 @@ namespace WireCell {
                 // 5) send out output any queue vectors
                 for (size_t ind = 0; ind < nout; ++ind) {
                     Edge edge = oports[ind].edge();
-                    edge->insert(edge->end(), outqv[ind].begin(), outqv[ind].end());
+                    for (auto& out : outqv[ind]) {
+                        edge->push_back(std::move(out));
+                    }
                 }
 
                 return true;
@@ -5,6 +5,13 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <ctime>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <boost/algorithm/string.hpp>
 
 using WireCell::demangle;
@@ -19,7 +26,7 @@ Graph::Graph()
 
 void Graph::add_node(Node* node) { m_nodes.insert(node); }
 
-bool Graph::connect(Node* tail, Node* head, size_t tpind, size_t hpind)
+bool Graph::connect(Node* tail, Node* head, size_t tpind, size_t hpind, size_t capacity)
 {
     Port& tport = tail->output_ports()[tpind];
     Port& hport = head->input_ports()[hpind];
@@ -32,8 +39,8 @@ bool Graph::connect(Node* tail, Node* head, size_t tpind, size_t hpind)
     m_edges.push_back(std::make_pair(tail, head));
     Edge edge = std::make_shared<Queue>();
 
-    tport.plug(edge);
-    hport.plug(edge);
+    tport.plug(edge, capacity);
+    hport.plug(edge, capacity);
 
     add_node(tail);
     add_node(head);
@@ -42,8 +49,8 @@ bool Graph::connect(Node* tail, Node* head, size_t tpind, size_t hpind)
     m_edges_backward[head].push_back(tail);
 
     // was at in TRACE macro, maybe deserves a bit more prominence 
-    l->debug("connect {}:({}:{}) -> {}({}:{})", tail->ident(), demangle(tport.signature()), tpind,
-             head->ident(), demangle(hport.signature()), hpind);
+    l->debug("connect {}:({}:{}) -> {}({}:{}) capacity:{}", tail->ident(), demangle(tport.signature()), tpind,
+             head->ident(), demangle(hport.signature()), hpind, capacity);
 
     return true;
 }
@@ -130,18 +137,230 @@ bool Graph::execute()
         }
 
         if (!did_something) {
-            return true;  // it's okay to do nothing.
+            return drained();  // it's okay to do nothing.
         }
     }
     return true;  // shouldn't reach
 }
 
+// Return true if the node has no input ports or at least one input
+// port holding data.  No node can do anything otherwise.
+static bool maybe_ready(Node* node)
+{
+    auto& iports = node->input_ports();
+    if (iports.empty()) {
+        return true;
+    }
+    for (auto& ip : iports) {
+        if (!ip.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A node with an output edge holding this many data is not
+// dispatched by execute_threaded() unless the consumer on that edge
+// is stalled.
+static const size_t max_backlog = 1;
+
+bool Graph::execute_threaded(size_t nthreads)
+{
+    if (nthreads < 2) {
+        return execute();
+    }
+
+    auto nodes = sort_kahn();
+    const size_t nnodes = nodes.size();
+    l->debug("executing with {} nodes on {} threads", nnodes, nthreads);
+
+    std::unordered_map<Node*, size_t> index;
+    for (size_t ind = 0; ind < nnodes; ++ind) {
+        index[nodes[ind]] = ind;
+        m_nodes_timer[nodes[ind]] = 0.0;
+    }
+
+    // Nodes sharing an edge with a node must not run concurrently
+    // with it.
+    std::vector<std::vector<size_t> > neighbors(nnodes), consumers(nnodes);
+    for (auto th : m_edges) {
+        const size_t t = index[th.first], h = index[th.second];
+        neighbors[t].push_back(h);
+        neighbors[h].push_back(t);
+        consumers[t].push_back(h);
+    }
+
+    // Each output port of a node with the consumer on its edge.
+    std::unordered_map<Queue*, size_t> edge_head;
+    for (size_t ind = 0; ind < nnodes; ++ind) {
+        for (auto& ip : nodes[ind]->input_ports()) {
+            edge_head[ip.edge().get()] = ind;
+        }
+    }
+    std::vector<std::vector<std::pair<const Port*, size_t> > > outputs(nnodes);
+    for (size_t ind = 0; ind < nnodes; ++ind) {
+        for (const auto& op : nodes[ind]->output_ports()) {
+            auto it = edge_head.find(op.edge().get());
+            if (it != edge_head.end()) {
+                outputs[ind].emplace_back(&op, it->second);
+            }
+        }
+    }
+
+    // Nodes to (re)consider, most downstream first as does execute().
+    std::set<size_t, std::greater<size_t> > pending;
+    for (size_t ind = 0; ind < nnodes; ++ind) {
+        pending.insert(ind);
+    }
+    std::vector<bool> running(nnodes, false);
+    // A node is stalled if its last call did nothing and no producer
+    // has run since.
+    std::vector<bool> stalled(nnodes, false);
+    size_t nrunning = 0;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    auto runnable = [&](size_t ind) {
+        if (running[ind]) {
+            return false;
+        }
+        for (size_t other : neighbors[ind]) {
+            if (running[other]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Sources and other producers must not run ahead of their
+    // consumers and fill memory.  A backlog on an edge is allowed to
+    // grow only if its consumer is stalled, eg waiting on another
+    // input.  A consumer with nothing on its edge from this node is
+    // waiting on it and does not hold it back.
+    auto held_back = [&](size_t ind) {
+        for (const auto& [port, other] : outputs[ind]) {
+            if (port->size() >= max_backlog and !stalled[other]) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!error) {
+            size_t ind = nnodes;
+            for (auto it = pending.begin(); it != pending.end();) {
+                if (!runnable(*it)) {
+                    ++it;
+                    continue;
+                }
+                // No neighbor runs so reading edge sizes is safe.  A
+                // held back node is reconsidered when a consumer
+                // runs or stalls.
+                if (!maybe_ready(nodes[*it]) or held_back(*it)) {
+                    it = pending.erase(it);
+                    continue;
+                }
+                ind = *it;
+                pending.erase(it);
+                break;
+            }
+            if (ind == nnodes) {
+                if (!nrunning) {
+                    break;      // nothing left to do
+                }
+                cond.wait(lock);
+                continue;
+            }
+
+            running[ind] = true;
+            ++nrunning;
+            Node* node = nodes[ind];
+            lock.unlock();
+
+            bool ok = false;
+            std::exception_ptr caught;
+            auto start = std::chrono::steady_clock::now();
+            try {
+                ok = call_node(node);
+            }
+            catch (...) {
+                caught = std::current_exception();
+            }
+            std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+
+            lock.lock();
+            running[ind] = false;
+            --nrunning;
+            m_nodes_timer[node] += dt.count();
+            if (caught) {
+                if (!error) {
+                    error = caught;
+                }
+            }
+            else if (ok) {
+                m_em(format("called %d: %s", ind, node->ident()));
+                SPDLOG_LOGGER_TRACE(l, "ran node {}: {}", ind, node->ident());
+                stalled[ind] = false;
+                for (size_t other : consumers[ind]) {
+                    stalled[other] = false;
+                }
+                pending.insert(ind);
+                pending.insert(neighbors[ind].begin(), neighbors[ind].end());
+            }
+            else if (!stalled[ind]) {
+                stalled[ind] = true;
+                pending.insert(neighbors[ind].begin(), neighbors[ind].end());
+            }
+            cond.notify_all();
+        }
+        cond.notify_all();
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t ind = 0; ind < nthreads; ++ind) {
+        workers.emplace_back(worker);
+    }
+    for (auto& one : workers) {
+        one.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return drained();
+}
+
+bool Graph::drained()
+{
+    bool okay = true;
+    for (auto node : m_nodes) {
+        for (const auto& ip : node->input_ports()) {
+            if (ip.empty()) {
+                continue;
+            }
+            okay = false;
+            l->warn("{} data left undelivered on {} of {}", ip.size(), ip.ident(), node->ident());
+        }
+    }
+    return okay;
+}
+
 bool Graph::call_node(Node* node)
 {
     if (!node) {
         l->error("graph call: got nullptr node");
         return false;
     }
+    for (const auto& op : node->output_ports()) {
+        if (op.full()) {
+            return false;  // wait for downstream to make room
+        }
+    }
+    if (m_tracer) {
+        return call_node_traced(node);
+    }
     bool ok = (*node)();
     // this can be very noisy but useful to uncomment to understand
     // the graph execution order.
@@ -151,6 +370,51 @@ bool Graph::call_node(Node* node)
     return ok;
 }
 
+void Graph::set_tracer(std::shared_ptr<TraceEvents> tracer)
+{
+    m_tracer = tracer;
+    m_traced.clear();
+    if (!m_tracer) {
+        return;
+    }
+    // Fill now so that call_node() from multiple threads only
+    // modifies existing entries.
+    for (auto node : m_nodes) {
+        m_traced[node] = std::make_pair(node->name(), 0);
+    }
+}
+
+// Call node, recording a trace event if it does something.
+bool Graph::call_node_traced(Node* node)
+{
+    TraceEvents::Event ev;
+    for (const auto& ip : node->input_ports()) {
+        ev.iqueue.push_back(ip.size());
+    }
+    for (const auto& op : node->output_ports()) {
+        ev.oqueue.push_back(op.size());
+    }
+    ev.start = TraceEvents::clock_t::now();
+    bool ok = (*node)();
+    ev.stop = TraceEvents::clock_t::now();
+    if (!ok) {
+        return false;
+    }
+    auto it = m_traced.find(node);
+    if (it == m_traced.end()) {
+        ev.name = node->name();
+    }
+    else {
+        ev.name = it->second.first;
+        ev.seqno = it->second.second++;
+    }
+    ev.cat = "pgraph";
+    ev.tid = TraceEvents::thread_index();
+    m_tracer->add(std::move(ev));
+    SPDLOG_LOGGER_TRACE(l, "graph call [{}] called: {}", ok, node->ident());
+    return true;
+}
+
 bool Graph::connected()
 {
     bool okay = true;
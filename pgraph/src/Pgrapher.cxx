@@ -1,11 +1,16 @@
 #include "WireCellPgraph/Pgrapher.h"
 #include "WireCellPgraph/Factory.h"
+#include "WireCellPgraph/Wrappers.h"
 #include "WireCellIface/INode.h"
 #include "WireCellUtil/NamedFactory.h"
 
+#include <map>
+#include <set>
+
 WIRECELL_FACTORY(Pgrapher, WireCell::Pgraph::Pgrapher, WireCell::IApplication, WireCell::IConfigurable)
 
 using WireCell::get;
+using WireCell::TraceEvents;
 using namespace WireCell::Pgraph;
 
 WireCell::Configuration Pgrapher::default_configuration() const
@@ -13,6 +18,11 @@ WireCell::Configuration Pgrapher::default_configuration() const
     Configuration cfg;
 
     cfg["edges"] = Json::arrayValue;
+    cfg["verbosity"] = m_verbosity;
+    cfg["nthreads"] = m_nthreads;
+    cfg["capacity"] = m_capacity;
+    cfg["trace"] = m_trace;
+    cfg["fuse_chains"] = m_fuse_chains;
     return cfg;
 }
 
@@ -46,20 +56,115 @@ std::string edge_to_string(WireCell::Configuration tail,
     return port_to_string(tail) + " -> " + port_to_string(head);
 }
 
+namespace {
+    struct Connection {
+        std::pair<WireCell::INode::pointer, int> tail, head;
+        int capacity;
+        WireCell::Configuration jedge;
+    };
+}
+
+// Return chains of two or more function nodes linked by edges which
+// are the only output of their tail and only input of their head.
+static std::vector<std::vector<WireCell::INode::pointer>>
+find_chains(const std::vector<Connection>& conns)
+{
+    using WireCell::INode;
+    std::map<INode::pointer, size_t> nout, nin;
+    for (const auto& conn : conns) {
+        ++nout[conn.tail.first];
+        ++nin[conn.head.first];
+    }
+
+    std::map<INode::pointer, INode::pointer> next;
+    std::set<INode::pointer> linked_head;
+    for (const auto& conn : conns) {
+        auto tail = conn.tail.first;
+        auto head = conn.head.first;
+        if (tail->category() != INode::functionNode or head->category() != INode::functionNode) {
+            continue;
+        }
+        if (nout[tail] != 1 or nin[head] != 1) {
+            continue;
+        }
+        next[tail] = head;
+        linked_head.insert(head);
+    }
+
+    std::vector<std::vector<INode::pointer>> chains;
+    for (const auto& [first, second] : next) {
+        if (linked_head.count(first)) {
+            continue;  // not the start of a chain
+        }
+        std::vector<INode::pointer> chain{first};
+        for (auto nit = next.find(first); nit != next.end(); nit = next.find(nit->second)) {
+            chain.push_back(nit->second);
+        }
+        chains.push_back(chain);
+    }
+    return chains;
+}
+
 void Pgrapher::configure(const WireCell::Configuration& cfg)
 
 {
     m_verbosity = get(cfg, "verbosity", m_verbosity);
+    m_nthreads = get(cfg, "nthreads", m_nthreads);
+    if (m_nthreads < 0) {
+        raise<ValueError>("nthreads must be non-negative, got %d", m_nthreads);
+    }
 
-    Pgraph::Factory fac;
-    log->debug("connecting: {} edges", cfg["edges"].size());
+    m_trace = get(cfg, "trace", m_trace);
+    m_capacity = get(cfg, "capacity", m_capacity);
+    if (m_capacity < 0) {
+        raise<ValueError>("capacity must be non-negative, got %d", m_capacity);
+    }
+
+    m_fuse_chains = get(cfg, "fuse_chains", m_fuse_chains);
+
+    std::vector<Connection> conns;
     for (auto jedge : cfg["edges"]) {
-        auto tail = get_node(jedge["tail"]);
-        auto head = get_node(jedge["head"]);
+        const int capacity = get(jedge, "capacity", m_capacity);
+        if (capacity < 0) {
+            raise<ValueError>("edge capacity must be non-negative for edge %s",
+                              edge_to_string(jedge["tail"], jedge["head"]));
+        }
+        conns.push_back({get_node(jedge["tail"]), get_node(jedge["head"]), capacity, jedge});
+    }
+
+    // Members of fused chains map to their fused node.
+    std::map<INode::pointer, Node*> fused;
+    if (m_fuse_chains) {
+        for (const auto& chain : find_chains(conns)) {
+            m_fused.emplace_back(std::make_unique<FusedFunction>(chain));
+            for (auto wcnode : chain) {
+                fused[wcnode] = m_fused.back().get();
+            }
+            log->debug("fused chain of {} function nodes: {}", chain.size(), m_fused.back()->name());
+        }
+    }
+
+    Pgraph::Factory fac;
+    auto wrap = [&](INode::pointer wcnode) -> Node* {
+        auto fit = fused.find(wcnode);
+        if (fit == fused.end()) {
+            return fac(wcnode);
+        }
+        return fit->second;
+    };
 
+    log->debug("connecting: {} edges", conns.size());
+    for (const auto& conn : conns) {
+        const auto& jedge = conn.jedge;
         SPDLOG_LOGGER_TRACE(log, "connecting: {}", jedge);
 
-        bool ok = m_graph.connect(fac(tail.first), fac(head.first), tail.second, head.second);
+        Node* tail = wrap(conn.tail.first);
+        Node* head = wrap(conn.head.first);
+        if (tail == head) {
+            continue;  // inside a fused chain
+        }
+
+        bool ok = m_graph.connect(tail, head, conn.tail.second, conn.head.second, conn.capacity);
         if (!ok) {
             log->critical("failed to connect edge: {}", jedge);
             raise<ValueError>("failed to connect edge %s", edge_to_string(jedge["tail"], jedge["head"]));
@@ -73,9 +178,25 @@ void Pgrapher::configure(const WireCell::Configuration& cfg)
 
 void Pgrapher::execute()
 {
-    log->debug("executing graph");
-    m_graph.execute();
-    log->debug("graph execution complete");
+    std::shared_ptr<TraceEvents> tracer;
+    if (!m_trace.empty()) {
+        tracer = std::make_shared<TraceEvents>();
+        m_graph.set_tracer(tracer);
+    }
+
+    log->debug("executing graph with {} threads", m_nthreads);
+    if (m_graph.execute_threaded(m_nthreads)) {
+        log->debug("graph execution complete");
+    }
+    else {
+        log->warn("graph execution complete with data left on edges");
+    }
+
+    if (tracer) {
+        log->debug("writing {} trace events to {}", tracer->size(), m_trace);
+        tracer->write(m_trace);
+        m_graph.set_tracer(nullptr);
+    }
     if (m_verbosity) {
         m_graph.print_timers(m_verbosity == 2);
     }
@@ -24,10 +24,11 @@ bool Port::isoutput() const { return m_type == Port::output; }
 Edge Port::edge() const { return m_edge; }
 
 // Connect an edge, returning any previous one.
-Edge Port::plug(Edge edge)
+Edge Port::plug(Edge edge, size_t capacity)
 {
     Edge ret = m_edge;
     m_edge = edge;
+    m_capacity = capacity;
     return ret;
 }
 
@@ -49,6 +50,16 @@ bool Port::empty() const
     return false;
 }
 
+size_t Port::capacity() const { return m_capacity; }
+
+bool Port::full() const
+{
+    if (!m_edge or !m_capacity) {
+        return false;
+    }
+    return m_edge->size() >= m_capacity;
+}
+
 // Get the next data.  By default this pops the data off
 // the queue.  To "peek" at the data, pas false.
 Data Port::get(bool pop)
@@ -62,10 +73,11 @@ Data Port::get(bool pop)
     if (m_edge->empty()) {
         THROW(RuntimeError() << errmsg{"edge is empty"});
     }
-    Data ret = m_edge->front();
-    if (pop) {
-        m_edge->pop_front();
+    if (!pop) {
+        return m_edge->front();
     }
+    Data ret = std::move(m_edge->front());
+    m_edge->pop_front();
     return ret;
 }
 
@@ -81,6 +93,17 @@ void Port::put(Data& data)
     m_edge->push_back(data);
 }
 
+void Port::put(Data&& data)
+{
+    if (isinput()) {
+        THROW(RuntimeError() << errmsg{"can not put to input port"});
+    }
+    if (!m_edge) {
+        THROW(RuntimeError() << errmsg{"port has no edge"});
+    }
+    m_edge->push_back(std::move(data));
+}
+
 const std::string& Port::name() const { return m_name; }
 const std::string& Port::signature() const { return m_sig; }
 
@@ -0,0 +1,110 @@
+/** Exercise edge capacity in Pgraph::Graph.  A node must not be called
+ * while its output edge is full.
+ */
+
+#include "WireCellPgraph/Graph.h"
+#include "WireCellUtil/Testing.h"
+
+
+#include <iostream>
+#include <vector>
+
+using namespace WireCell;
+
+class IntNode : public Pgraph::Node {
+   public:
+    IntNode(const std::string& name, size_t nin, size_t nout)
+      : m_name(name)
+    {
+        using Pgraph::Port;
+        for (size_t ind = 0; ind < nin; ++ind) {
+            m_ports[Port::input].push_back(Port(this, Port::input, "int"));
+        }
+        for (size_t ind = 0; ind < nout; ++ind) {
+            m_ports[Port::output].push_back(Port(this, Port::output, "int"));
+        }
+    }
+    virtual std::string ident() { return m_name; }
+
+   private:
+    std::string m_name;
+};
+
+// A source which puts regardless of how much output is waiting.
+class Source : public IntNode {
+    int m_num{0}, m_end;
+
+   public:
+    int ncalls{0};
+    Source(int end)
+      : IntNode("src", 0, 1)
+      , m_end(end)
+    {
+    }
+    virtual bool operator()()
+    {
+        ++ncalls;
+        if (m_num >= m_end) {
+            return false;
+        }
+        Pgraph::Data d = m_num++;
+        oport().put(d);
+        return true;
+    }
+};
+
+class Sink : public IntNode {
+   public:
+    std::vector<int> got;
+    Sink()
+      : IntNode("dst", 1, 0)
+    {
+    }
+    virtual bool operator()()
+    {
+        if (iport().empty()) {
+            return false;
+        }
+        got.push_back(iport().get().get<int>());
+        return true;
+    }
+};
+
+int main()
+{
+    const size_t capacity = 3;
+    const int ndata = 10;
+
+    Source src(ndata);
+    Sink dst;
+    Pgraph::Graph graph;
+    graph.connect(&src, &dst, 0, 0, capacity);
+
+    Assert(src.oport().capacity() == capacity);
+    Assert(dst.iport().capacity() == capacity);
+
+    for (size_t ind = 0; ind < capacity; ++ind) {
+        Assert(graph.call_node(&src));
+    }
+    Assert(src.oport().full());
+    Assert(src.oport().size() == capacity);
+
+    // Full edge means source is not even called.
+    const int ncalls = src.ncalls;
+    Assert(!graph.call_node(&src));
+    Assert(src.ncalls == ncalls);
+
+    // Consuming makes room.
+    Assert(graph.call_node(&dst));
+    Assert(!src.oport().full());
+    Assert(graph.call_node(&src));
+    Assert(src.oport().full());
+
+    graph.execute();
+    std::cerr << "sink got " << dst.got.size() << std::endl;
+    Assert(dst.got.size() == (size_t) ndata);
+    for (int ind = 0; ind < ndata; ++ind) {
+        Assert(dst.got[ind] == ind);
+    }
+    return 0;
+}
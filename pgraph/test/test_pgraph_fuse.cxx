@@ -0,0 +1,120 @@
+/** Exercise a fused chain of function nodes in Pgraph::Graph.
+ */
+
+#include "WireCellPgraph/Factory.h"
+#include "WireCellPgraph/Wrappers.h"
+#include "WireCellUtil/Testing.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace WireCell;
+
+const int nints = 10;
+
+class IntSource : public ISourceNode<int> {
+    int m_count{0};
+
+   public:
+    virtual ~IntSource() {}
+    virtual bool operator()(output_pointer& out)
+    {
+        if (m_count > nints) {
+            return false;
+        }
+        if (m_count == nints) {  // EOS
+            ++m_count;
+            out = nullptr;
+            return true;
+        }
+        out = std::make_shared<int>(m_count++);
+        return true;
+    }
+};
+
+class IntAdd : public IFunctionNode<int, int> {
+    int m_add;
+
+   public:
+    int ncalls{0};
+    IntAdd(int add)
+      : m_add(add)
+    {
+    }
+    virtual ~IntAdd() {}
+    virtual bool operator()(const input_pointer& in, output_pointer& out)
+    {
+        ++ncalls;
+        if (!in) {
+            out = nullptr;
+            return true;
+        }
+        out = std::make_shared<int>(*in + m_add);
+        return true;
+    }
+};
+
+class IntSink : public ISinkNode<int> {
+   public:
+    std::vector<int> got;
+    int neos{0};
+    virtual ~IntSink() {}
+    virtual bool operator()(const input_pointer& in)
+    {
+        if (!in) {
+            ++neos;
+            return true;
+        }
+        got.push_back(*in);
+        return true;
+    }
+};
+
+int main()
+{
+    auto src = std::make_shared<IntSource>();
+    auto sink = std::make_shared<IntSink>();
+    std::vector<std::shared_ptr<IntAdd>> adds;
+    std::vector<INode::pointer> chain;
+    for (int ind = 1; ind <= 3; ++ind) {
+        adds.push_back(std::make_shared<IntAdd>(ind));
+        chain.push_back(adds.back());
+    }
+
+    Pgraph::Factory fac;
+    Pgraph::FusedFunction fused(chain);
+    std::cerr << fused.ident() << "\n" << fused.name() << "\n";
+
+    Pgraph::Graph graph;
+    Assert(graph.connect(fac(src), &fused));
+    Assert(graph.connect(&fused, fac(sink)));
+    Assert(graph.connected());
+    graph.execute();
+
+    for (auto add : adds) {
+        Assert(add->ncalls == nints + 1);
+    }
+    Assert(sink->neos == 1);
+    Assert(sink->got.size() == (size_t) nints);
+    for (int ind = 0; ind < nints; ++ind) {
+        Assert(sink->got[ind] == ind + 6);
+    }
+
+    // Adjacent nodes must agree on type.
+    struct FloatPass : public IFunctionNode<float, float> {
+        virtual bool operator()(const input_pointer& in, output_pointer& out)
+        {
+            out = in;
+            return true;
+        }
+    };
+    bool caught = false;
+    try {
+        Pgraph::FusedFunction bad({adds[0], std::make_shared<FloatPass>()});
+    }
+    catch (ValueError& err) {
+        caught = true;
+    }
+    Assert(caught);
+    return 0;
+}
@@ -0,0 +1,290 @@
+/** Exercise Pgraph::Graph::execute_threaded() on a graph with several
+ * independent pipelines and check that every sink receives all of its
+ * data and in order, that sources do not run ahead of their consumers
+ * and that data left on edges is reported.
+ */
+
+#include "WireCellPgraph/Graph.h"
+#include "WireCellUtil/Testing.h"
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace WireCell;
+
+class IntNode : public Pgraph::Node {
+   public:
+    IntNode(const std::string& name, size_t nin, size_t nout)
+      : m_name(name)
+    {
+        using Pgraph::Port;
+        for (size_t ind = 0; ind < nin; ++ind) {
+            m_ports[Port::input].push_back(Port(this, Port::input, "int"));
+        }
+        for (size_t ind = 0; ind < nout; ++ind) {
+            m_ports[Port::output].push_back(Port(this, Port::output, "int"));
+        }
+    }
+    virtual std::string ident() { return m_name; }
+
+   protected:
+    // Detect any concurrent call on this node.
+    struct Guard {
+        std::atomic<int>& busy;
+        Guard(std::atomic<int>& b)
+          : busy(b)
+        {
+            const int nbusy = ++busy;
+            AssertMsg(nbusy == 1, "concurrent call on node");
+        }
+        ~Guard() { --busy; }
+    };
+    std::atomic<int> m_busy{0};
+
+   private:
+    std::string m_name;
+};
+
+class Source : public IntNode {
+    int m_num, m_end;
+
+   public:
+    // Largest number of data waiting on the output when called.
+    size_t maxq{0};
+
+    Source(const std::string& name, int beg, int end)
+      : IntNode(name, 0, 1)
+      , m_num(beg)
+      , m_end(end)
+    {
+    }
+    virtual bool operator()()
+    {
+        Guard g(m_busy);
+        if (m_num >= m_end) {
+            return false;
+        }
+        maxq = std::max(maxq, oport().size());
+        Pgraph::Data d = m_num++;
+        oport().put(d);
+        return true;
+    }
+};
+
+class Func : public IntNode {
+   public:
+    Func(const std::string& name)
+      : IntNode(name, 1, 1)
+    {
+    }
+    virtual bool operator()()
+    {
+        Guard g(m_busy);
+        if (iport().empty()) {
+            return false;
+        }
+        Pgraph::Data d = iport().get();
+        // pretend to do some work
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        oport().put(d);
+        return true;
+    }
+};
+
+// Sum one datum from each of two inputs.
+class Join : public IntNode {
+   public:
+    Join(const std::string& name)
+      : IntNode(name, 2, 1)
+    {
+    }
+    virtual bool operator()()
+    {
+        Guard g(m_busy);
+        auto& iports = input_ports();
+        if (iports[0].empty() or iports[1].empty()) {
+            return false;
+        }
+        int sum = iports[0].get().get<int>() + iports[1].get().get<int>();
+        Pgraph::Data d = sum;
+        oport().put(d);
+        return true;
+    }
+};
+
+// Copy each input to both outputs.
+class Fanout : public IntNode {
+   public:
+    Fanout(const std::string& name)
+      : IntNode(name, 1, 2)
+    {
+    }
+    virtual bool operator()()
+    {
+        Guard g(m_busy);
+        if (iport().empty()) {
+            return false;
+        }
+        Pgraph::Data d = iport().get();
+        for (auto& op : output_ports()) {
+            op.put(d);
+        }
+        return true;
+    }
+};
+
+// Hold inputs until there are two, then output both.
+class Buffer : public IntNode {
+    std::vector<Pgraph::Data> m_held;
+
+   public:
+    Buffer(const std::string& name)
+      : IntNode(name, 1, 1)
+    {
+    }
+    virtual bool operator()()
+    {
+        Guard g(m_busy);
+        if (iport().empty()) {
+            return false;
+        }
+        m_held.push_back(iport().get());
+        if (m_held.size() == 2) {
+            for (auto& d : m_held) {
+                oport().put(d);
+            }
+            m_held.clear();
+        }
+        return true;
+    }
+};
+
+class Sink : public IntNode {
+   public:
+    std::vector<int> got;
+    // Stop taking data after this many.
+    size_t limit;
+    Sink(const std::string& name, size_t limit = -1)
+      : IntNode(name, 1, 0)
+      , limit(limit)
+    {
+    }
+    virtual bool operator()()
+    {
+        Guard g(m_busy);
+        if (iport().empty() or got.size() >= limit) {
+            return false;
+        }
+        got.push_back(iport().get().get<int>());
+        return true;
+    }
+};
+
+// Two sources joined into one sink, possibly stopping early.
+static bool run_join(int ndata, size_t limit, size_t nthreads)
+{
+    Source a("a", 0, ndata), b("b", 0, ndata);
+    Join join("join");
+    Sink sink("sink", limit);
+    Pgraph::Graph graph;
+    graph.connect(&a, &join, 0, 0);
+    graph.connect(&b, &join, 0, 1);
+    graph.connect(&join, &sink);
+    Assert(graph.connected());
+
+    bool ok = nthreads ? graph.execute_threaded(nthreads) : graph.execute();
+    std::cerr << "join to " << limit << " on " << nthreads << " threads got " << sink.got.size() << std::endl;
+    AssertMsg(sink.got.size() == std::min((size_t) ndata, limit), "lost data");
+    for (size_t ind = 0; ind < sink.got.size(); ++ind) {
+        AssertMsg(sink.got[ind] == 2 * (int) ind, "data out of order");
+    }
+    return ok;
+}
+
+// One source fanned out to a join directly and through a buffer.  The
+// buffer, idle with an empty input, must not hold back the fanout
+// while the join waits on the buffer.
+static bool run_fanout_buffer(int ndata, size_t nthreads)
+{
+    Source src("src", 0, ndata);
+    Fanout fanout("fanout");
+    Buffer buffer("buffer");
+    Join join("join");
+    Sink sink("sink");
+    Pgraph::Graph graph;
+    graph.connect(&src, &fanout);
+    graph.connect(&fanout, &join, 0, 0);
+    graph.connect(&fanout, &buffer, 1, 0);
+    graph.connect(&buffer, &join, 0, 1);
+    graph.connect(&join, &sink);
+    Assert(graph.connected());
+
+    bool ok = nthreads ? graph.execute_threaded(nthreads) : graph.execute();
+    std::cerr << "fanout buffer on " << nthreads << " threads got " << sink.got.size() << std::endl;
+    AssertMsg(sink.got.size() == (size_t) ndata, "lost data");
+    for (size_t ind = 0; ind < sink.got.size(); ++ind) {
+        AssertMsg(sink.got[ind] == 2 * (int) ind, "data out of order");
+    }
+    return ok;
+}
+
+int main()
+{
+    const int nchains = 4, nstages = 3, ndata = 100;
+
+    Pgraph::Graph graph;
+    std::vector<Source*> sources;
+    std::vector<Sink*> sinks;
+    std::vector<Pgraph::Node*> owned;
+    for (int ichain = 0; ichain < nchains; ++ichain) {
+        std::stringstream ss;
+        ss << "chain" << ichain;
+        auto src = new Source(ss.str() + "src", ichain * ndata, (ichain + 1) * ndata);
+        sources.push_back(src);
+        Pgraph::Node* last = src;
+        owned.push_back(last);
+        for (int istage = 0; istage < nstages; ++istage) {
+            auto func = new Func(ss.str() + "fun");
+            owned.push_back(func);
+            graph.connect(last, func);
+            last = func;
+        }
+        auto sink = new Sink(ss.str() + "dst");
+        owned.push_back(sink);
+        sinks.push_back(sink);
+        graph.connect(last, sink);
+    }
+    Assert(graph.connected());
+
+    Assert(graph.execute_threaded(4));
+
+    for (int ichain = 0; ichain < nchains; ++ichain) {
+        const auto& got = sinks[ichain]->got;
+        std::cerr << "chain " << ichain << " got " << got.size()
+                  << " source backlog " << sources[ichain]->maxq << std::endl;
+        AssertMsg(got.size() == (size_t) ndata, "lost data");
+        for (int ind = 0; ind < ndata; ++ind) {
+            AssertMsg(got[ind] == ichain * ndata + ind, "data out of order");
+        }
+        AssertMsg(sources[ichain]->maxq == 0, "source ran ahead");
+    }
+
+    for (auto node : owned) {
+        delete node;
+    }
+
+    // A join waiting on one input must not block the other.  Data
+    // left on edges is reported.
+    for (size_t nthreads : {0, 4}) {
+        Assert(run_join(ndata, -1, nthreads));
+        Assert(!run_join(ndata, ndata / 2, nthreads));
+        Assert(run_fanout_buffer(10, nthreads));
+    }
+    return 0;
+}
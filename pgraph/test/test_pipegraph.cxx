@@ -92,7 +92,7 @@ class Sink : public IdNode {
         if (iport().empty()) {
             return false;
         }
-        int d = boost::any_cast<int>(iport().get());
+        int d = iport().get().get<int>();
         msg("sink: ") << d << std::endl;
         return true;
     }
@@ -124,7 +124,7 @@ class Njoin : public IdNode {
                 continue;
             }
             Pgraph::Data d = p.get();
-            int n = boost::any_cast<int>(d);
+            int n = d.get<int>();
             o << n << " ";
             outv.push_back(d);
         }
@@ -158,7 +158,7 @@ class SplitQueueBuffer : public IdNode {
             if (iport().empty()) {
                 return false;
             }
-            m_buf = boost::any_cast<Pgraph::Queue>(iport().get());
+            m_buf = iport().get().get<Pgraph::Queue>();
         }
         if (m_buf.empty()) {
             return false;
@@ -185,7 +185,7 @@ class Nfan : public IdNode {
             return false;
         }
         auto obj = iport().get();
-        int d = boost::any_cast<int>(obj);
+        int d = obj.get<int>();
         msg("nfan: ") << d << std::endl;
         for (auto p : output_ports()) {
             p.put(obj);
@@ -205,7 +205,7 @@ class Func : public IdNode {
             return false;
         }
         Pgraph::Data out = iport().get();
-        int d = boost::any_cast<int>(out);
+        int d = out.get<int>();
         msg("func: ") << d << std::endl;
         oport().put(out);
         return true;
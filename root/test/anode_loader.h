@@ -78,8 +78,8 @@ std::vector<std::string> anode_loader(std::string detector)
             icfg->configure(cfg);
         }
         {
-            // If FftwDFT grows to be an IConfigurable, this needs to
-            // change to suit.
+            // FftwDFT is an IConfigurable but its defaults need no
+            // configure() call.
             Factory::lookup<IDFT>("FftwDFT"); 
         }
 
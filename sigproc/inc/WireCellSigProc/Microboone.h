@@ -117,9 +117,29 @@ namespace WireCell {
                 /** Filter in place a group of signals together. */
                 virtual WireCell::Waveform::ChannelMaskMap apply(channel_signals_t& chansig) const;
 
+                /** Filter in place a block of channels with one DFT
+                 * each way for the whole block. */
+                virtual WireCell::Waveform::ChannelMaskMap apply_block(const std::vector<int>& channels,
+                                                                       Array::array_xxf& block) const;
+
                private:
                 Diagnostics::Chirp m_check_chirp;      // fixme, these should be done via service interfaces
                 Diagnostics::Partial m_check_partial;  // at least need to expose them to configuration
+
+                // What is learned about a channel before its DFT.
+                struct ChannelState {
+                    WireCell::Waveform::BinRange chirped_bins;
+                    bool is_chirp{false};
+                    bool is_partial{false};
+                };
+                // The parts of apply() before, between and after the DFTs.
+                typedef IChannelNoiseDatabase::ChannelParams params_t;
+                void pre_dft(const params_t& cp, signal_t& signal, ChannelState& state,
+                             WireCell::Waveform::ChannelMaskMap& ret) const;
+                void filter_spectrum(const params_t& cp, WireCell::Waveform::compseq_t& spectrum,
+                                     ChannelState& state) const;
+                void post_dft(const params_t& cp, signal_t& signal, const ChannelState& state,
+                              WireCell::Waveform::ChannelMaskMap& ret) const;
             };
 
             class OneChannelStatus : public WireCell::IChannelFilter, public WireCell::IConfigurable {
@@ -66,6 +66,8 @@ namespace WireCell {
             virtual channel_group_t bad_channels() const { return m_bad_channels; }
             virtual channel_group_t miscfg_channels() const { return m_miscfg_channels; }
 
+            virtual std::vector<ChannelParams> channel_params(const channel_group_t& channels) const;
+
            protected:
             // Allow subclasses some access so that they may leverage
             // all the configuration code this class provides while
@@ -120,23 +122,16 @@ namespace WireCell {
                 ChannelInfo();
             };
 
-            // std::vector<ChannelInfo> m_db;
-            // std::unordered_map<int, ChannelInfo*> m_db;
-            std::unordered_map<int, ChannelInfo> m_db;
-
-            const ChannelInfo& dbget(int ch) const
-            {
-                auto it = m_db.find(ch);
-                if (it == m_db.end()) {
-                    // it = m_db.find(defch);
-                    // return *(it->second);
-                    // m_db.insert(std::make_pair(ch, new ChannelInfo));
-                    // return *(m_db[ch]);
-                    THROW(KeyError() << errmsg{String::format("no db info for channel %d", ch)});
-                }
-                return it->second;
-                // return m_db.at(ch);
-            }
+            // The entries are held densely in channel ident order.
+            // Spectra are shared between entries.
+            std::vector<ChannelInfo> m_db;
+            // Index into m_db for each channel ident starting from
+            // m_chmin or -1 if the ident is not in the anode.
+            std::vector<int> m_dbind;
+            int m_chmin{0};
+
+            // Same as get_ci() for const access.
+            const ChannelInfo& dbget(int ch) const { return const_cast<OmniChannelNoiseDB*>(this)->get_ci(ch); }
 
             std::vector<channel_group_t> m_channel_groups;
             channel_group_t m_bad_channels;
@@ -154,6 +149,7 @@ namespace WireCell {
             shared_filter_t parse_response(Json::Value jreconfig);
             // ChannelInfo* make_ci(int chid, Json::Value jci);
             void update_channels(Json::Value cfg);
+            // Return the entry for the channel, throw KeyError if none.
             ChannelInfo& get_ci(int chid);
 
             // Reuse the same filter spectra for matching input parameters.
@@ -54,6 +54,8 @@ namespace WireCell {
             }
             void set_grouped_filters(std::vector<WireCell::IChannelFilter::pointer> filters) { m_grouped = filters; }
             void set_channel_noisedb(WireCell::IChannelNoiseDatabase::pointer ndb) { m_noisedb = ndb; }
+            void set_nthreads(int nthreads) { m_nthreads = nthreads; }
+            void set_batch_channels(int nbatch) { m_batch_channels = nbatch; }
 
            private:
             // number of time ticks in the waveforms processed.  Set to 0 and first input trace sets it.
@@ -64,6 +66,14 @@ namespace WireCell {
 
             std::map<std::string, std::string> m_maskmap;
 
+            // Number of threads used to apply filters across channels
+            // and channel groups.  One runs serially.
+            int m_nthreads{1};
+
+            // If positive, channel filters are applied to blocks of up
+            // to this many channels at a time with apply_block().
+            int m_batch_channels{0};
+
             size_t m_count{0};
         };
 
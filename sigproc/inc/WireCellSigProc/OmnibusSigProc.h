@@ -13,7 +13,10 @@
 #include "WireCellUtil/Array.h"
 
 
+#include <functional>
 #include <list>
+#include <map>
+#include <mutex>
 
 namespace WireCell {
     namespace SigProc {
@@ -47,6 +50,7 @@ namespace WireCell {
 
             // for debugging, check current state of working data
             void check_data(int plane, const std::string& loglabel);
+            void check_data(const Array::array_xxf& arr, int plane, const std::string& loglabel);
 
             // Copy elements from m_r_data, mess with them, and store
             // result into traces.  Update indices.  Fixme: best if we
@@ -73,6 +77,20 @@ namespace WireCell {
             // initialize the overall response function ...
             void init_overall_response(IFrame::pointer frame);
 
+            // initialize the ch-by-ch electronics response correction
+            void init_channel_correction();
+
+            // Return the product of the IFilterWaveform "type:name"
+            // filters sampled at nbins.  Each product is made once
+            // and reused for later planes and frames.
+            const Waveform::realseq_t& filter_spectrum(const std::vector<std::string>& filter_tns, int nbins);
+
+            // Call func(plane) for each of m_process_planes in plane
+            // order, or concurrently, one thread per plane, if
+            // m_parallel_planes.  Returns after all calls finish and
+            // rethrows the first exception in plane order.
+            void for_each_plane(const std::function<void(int)>& func);
+
             void restore_baseline(WireCell::Array::array_xxf& arr);
 	    void rebase_waveform(WireCell::Array::array_xxf& arr, const int& nbins);
             // This little struct is used to map between WCT channel idents
@@ -195,9 +213,33 @@ namespace WireCell {
             Array::array_xxf m_r_data[3];
             Array::array_xxc m_c_data[3];
 
+            // Per-plane scratch arrays.  These and the working arrays
+            // above are kept across frames so that steady state
+            // processing reuses their storage instead of reallocating.
+            // Each is only touched by the thread processing its plane.
+            struct Workspace {
+                Array::array_xxf r_padded;    // padded real-space data
+                Array::array_xxc c_filtered;  // filtered spectrum
+                Array::array_xxf r_tight;     // the "tighter" ROI decon
+            };
+            Workspace m_work[3];
+
             // average overall responses
             std::vector<Waveform::realseq_t> overall_resp[3];
 
+            // Per-plane 2D spectra of the overall responses and the
+            // ch-by-ch electronics response correction (empty if not
+            // used).  These are remade only when the frame shape
+            // below changes and are otherwise only read.
+            Array::array_xxc m_resp_spectrum[3];
+            Array::array_xxc m_chan_correction[3];
+            int m_resp_nticks{0};
+            double m_resp_period{0};
+
+            // Cache for filter_spectrum() keyed by size and filters.
+            std::map<std::string, Waveform::realseq_t> m_filter_spectra;
+            std::mutex m_filter_mutex;
+
             // tag name for traces
             std::string m_wiener_tag{"wiener"};
 //            std::string m_wiener_threshold_tag;
@@ -233,6 +275,9 @@ namespace WireCell {
             // samples.
             bool m_sparse{false};
 
+            // If true, the per-plane stages process planes concurrently.
+            bool m_parallel_planes{false};
+
             size_t m_count{0};
             int m_verbose{0};
 
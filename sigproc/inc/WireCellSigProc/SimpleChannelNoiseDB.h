@@ -143,8 +143,12 @@ namespace WireCell {
             shared_filter_t m_default_filter;
             shared_filter_t m_default_response;
 
-            mutable std::unordered_map<int, int> m_ch2ind;
+            // Index of a channel into the per-channel vectors.  The
+            // const lookup gives -1 for a channel with no values set so
+            // that concurrent readers do not modify the map.
+            std::unordered_map<int, int> m_ch2ind;
             int chind(int ch) const;
+            int add_chind(int ch);
 
             const IChannelNoiseDatabase::filter_t& get_filter(int channel, const filter_vector_t& fv) const;
 
@@ -1,5 +1,7 @@
 #include "WireCellSigProc/Derivations.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 using namespace WireCell::SigProc;
@@ -19,50 +21,100 @@ std::pair<double, double> Derivations::CalcRMS(const WireCell::Waveform::realseq
     return temp;
 }
 
+// Same as Waveform::median_binned() but on a bare array and with the
+// histogram provided by the caller so that it may be reused.
+static float median_binned(const float* vals, const int nvals, std::vector<int>& hist)
+{
+    const auto mm = std::minmax_element(vals, vals + nvals);
+    const float vmin = *mm.first;
+    const float vmax = *mm.second;
+    const float binsize = (vmax - vmin) / nvals;
+    if (binsize == 0) {
+        return vmin;
+    }
+    hist.assign(nvals, 0);
+    for (int ind = 0; ind < nvals; ++ind) {
+        int bin = int(std::round((vals[ind] - vmin) / binsize));
+        bin = std::max(0, bin);
+        bin = std::min(nvals - 1, bin);
+        ++hist[bin];
+    }
+
+    const int imed = nvals / 2;
+    int count = 0;
+    for (int ind = 0; ind < nvals; ++ind) {
+        count += hist[ind];
+        if (count > imed) {
+            return vmin + ind * binsize;
+        }
+    }
+    return vmin + (vmax - vmin) * 0.5;
+}
+
 WireCell::Waveform::realseq_t Derivations::CalcMedian(const WireCell::IChannelFilter::channel_signals_t& chansig)
 {
     float max_rms = 0;
     float count_max_rms = 0;
     const int nchannel = chansig.size();
     const int nbins = (chansig.begin()->second).size();
-    // float content[nchannel][nbins];
-    std::vector<float> content(nchannel * nbins, 0.0);  // 2D array [channel*nbins + bin]
 
-    int start_ch = 0;
-    for (auto it : chansig) {
-        // const int ch = it.first;
-        WireCell::IChannelFilter::signal_t& signal = it.second;
+    std::vector<const float*> signals;
+    std::vector<int> sizes;
+    signals.reserve(nchannel);
+    sizes.reserve(nchannel);
+    for (const auto& it : chansig) {
+        const WireCell::IChannelFilter::signal_t& signal = it.second;
         std::pair<double, double> temp = WireCell::Waveform::mean_rms(signal);
 
         if (temp.second > 0) {
             max_rms += temp.second;
             count_max_rms++;
         }
-
-        for (int i = 0; i != nbins; i++) {
-            content[start_ch * nbins + i] = signal.at(i);
-        }
-        start_ch++;
+        signals.push_back(signal.data());
+        sizes.push_back(signal.size());
     }
 
     if (count_max_rms > 0) {
         max_rms /= count_max_rms;
     }
 
+    // Channels are gathered a tile of ticks at a time into a
+    // tick-major buffer so each tick's values are contiguous.  Ticks
+    // past the end of a shorter channel are taken as zero, which the
+    // selection below excludes.
+    const int ntile = 64;
+    std::vector<float> tile(ntile * nchannel);
+    std::vector<float> selected(nchannel);
+    std::vector<int> hist;
+
     WireCell::Waveform::realseq_t medians(nbins);
-    for (int ibin = 0; ibin != nbins; ibin++) {
-        WireCell::Waveform::realseq_t temp;
+    for (int tbin = 0; tbin < nbins; tbin += ntile) {
+        const int tsize = std::min(ntile, nbins - tbin);
         for (int ich = 0; ich != nchannel; ich++) {
-            const float cont = content.at(ich * nbins + ibin);
-            if (fabs(cont) < 5 * max_rms && fabs(cont) > 0.001) {
-                temp.push_back(cont);
+            const float* sig = signals[ich] + tbin;
+            const int nsig = std::max(0, std::min(tsize, sizes[ich] - tbin));
+            for (int ind = 0; ind != nsig; ++ind) {
+                tile[ind * nchannel + ich] = sig[ind];
+            }
+            for (int ind = nsig; ind < tsize; ++ind) {
+                tile[ind * nchannel + ich] = 0;
             }
         }
-        if (temp.size() > 0) {
-            medians.at(ibin) = WireCell::Waveform::median_binned(temp);
-        }
-        else {
-            medians.at(ibin) = 0;
+        for (int ind = 0; ind != tsize; ++ind) {
+            const float* row = tile.data() + ind * nchannel;
+            int nselected = 0;
+            for (int ich = 0; ich != nchannel; ich++) {
+                const float cont = row[ich];
+                if (fabs(cont) < 5 * max_rms && fabs(cont) > 0.001) {
+                    selected[nselected++] = cont;
+                }
+            }
+            if (nselected > 0) {
+                medians[tbin + ind] = median_binned(selected.data(), nselected, hist);
+            }
+            else {
+                medians[tbin + ind] = 0;
+            }
         }
     }
 
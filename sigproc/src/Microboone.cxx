@@ -9,6 +9,7 @@
 
 #include "WireCellUtil/NamedFactory.h"
 
+#include <atomic>
 #include <cmath>
 #include <complex>
 #include <iostream>
@@ -899,22 +900,18 @@ Microboone::OneChannelNoise::OneChannelNoise(const std::string& anode, const std
 }
 Microboone::OneChannelNoise::~OneChannelNoise() {}
 
-WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, signal_t& signal) const
+void Microboone::OneChannelNoise::pre_dft(const params_t& cp, signal_t& signal, ChannelState& state,
+                                          WireCell::Waveform::ChannelMaskMap& ret) const
 {
-    WireCell::Waveform::ChannelMaskMap ret;
-
-    // sanity check data/config match.
-    const size_t nsiglen = signal.size();
-    int nmismatchlen = 0;
-    static bool warn_once{true};
+    const int ch = cp.channel;
 
     // fixme: some channels are just bad can should be skipped.
 
     // get signal with nominal baseline correction
-    float baseline = m_noisedb->nominal_baseline(ch);
+    float baseline = cp.nominal_baseline;
 
     // get signal with nominal gain correction
-    float gc = m_noisedb->gain_correction(ch);
+    float gc = cp.gain_correction;
     WireCell::Waveform::increase(signal, baseline * (-1));
 
     auto signal_gc = signal;  // copy, need to keep original signal
@@ -925,9 +922,9 @@ WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, si
     //           << std::endl;;
 
     // determine if chirping
-    WireCell::Waveform::BinRange chirped_bins;
-    bool is_chirp = m_check_chirp(signal_gc, chirped_bins.first, chirped_bins.second);
-    if (is_chirp) {
+    WireCell::Waveform::BinRange& chirped_bins = state.chirped_bins;
+    state.is_chirp = m_check_chirp(signal_gc, chirped_bins.first, chirped_bins.second);
+    if (state.is_chirp) {
         ret["chirp"][ch].push_back(chirped_bins);
 
         auto wpid = m_anode->resolve(ch);
@@ -940,15 +937,23 @@ WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, si
             }
         }
     }
+}
+
+void Microboone::OneChannelNoise::filter_spectrum(const params_t& cp, WireCell::Waveform::compseq_t& spectrum,
+                                                  ChannelState& state) const
+{
+    // sanity check data/config match.
+    const size_t nsiglen = spectrum.size();
+    int nmismatchlen = 0;
+    static std::atomic<bool> warn_once{true};
 
-    auto spectrum = fwd_r2c(m_dft, signal);
     // std::cerr << "OneChannelNoise: "<<ch<<" dft spectral sum="<<Waveform::sum(spectrum)<<"\n";
 
-    bool is_partial = m_check_partial(spectrum);  // Xin's "IS_RC()"
+    state.is_partial = m_check_partial(spectrum);  // Xin's "IS_RC()"
 
     int nspec = 0;  // just catch any non-zero
-    if (!is_partial) {
-        auto const& spec_old = m_noisedb->rcrc(ch);
+    if (!state.is_partial) {
+        auto const& spec_old = *cp.rcrc;
         auto spec = spec_old.size() == spectrum.size() ? spec_old :
                 Waveform::resample(spec_old, {0,spec_old.size()}, spectrum.size(), {0,spectrum.size()});
         WireCell::Waveform::shrink(spectrum, spec);
@@ -960,7 +965,7 @@ WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, si
     }
 
     {
-        auto const& spec = m_noisedb->config(ch);
+        auto const& spec = *cp.config;
         WireCell::Waveform::scale(spectrum, spec);
 
         if (nsiglen != spec.size()) {
@@ -970,7 +975,7 @@ WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, si
     }
 
     {
-        auto const& spec = m_noisedb->noise(ch);
+        auto const& spec = *cp.noise;
         WireCell::Waveform::scale(spectrum, spec);
 
         if (nsiglen != spec.size()) {
@@ -979,16 +984,21 @@ WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, si
         }
     }
 
-    if (warn_once && nmismatchlen) {
+    // Channels may be filtered concurrently.
+    if (nmismatchlen && warn_once.exchange(false)) {
         std::cerr << "OneChannelNoise: WARNING: " << nmismatchlen << " config/data mismatches. "
                   << "#spec=" << nspec << ", #wave=" << nsiglen << ".\n"
                   << "\tResults may be suspect.  Only one warning given but there may be many suppressed, one per channel" << std::endl;
-        warn_once = false;
     }
 
     // remove the DC component
     spectrum.front() = 0;
-    signal = inv_c2r(m_dft, spectrum);
+}
+
+void Microboone::OneChannelNoise::post_dft(const params_t& cp, signal_t& signal, const ChannelState& state,
+                                           WireCell::Waveform::ChannelMaskMap& ret) const
+{
+    const int ch = cp.channel;
 
     // std::cerr << "OneChannelNoise: "<<ch<<" after dft: sigsum="<<Waveform::sum(signal)<<"\n";
 
@@ -1000,7 +1010,7 @@ WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, si
             temp_signal.at(i) = temp.first;
         }
     }
-    baseline = WireCell::Waveform::median_binned(temp_signal);
+    float baseline = WireCell::Waveform::median_binned(temp_signal);
     // correct baseline
     WireCell::Waveform::increase(signal, baseline * (-1));
 
@@ -1008,13 +1018,13 @@ WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, si
     //*** specific and are basically copy-pasted from the prototype
 
     // Now do adaptive baseline for the chirping channels
-    if (is_chirp) {
-        Microboone::Chirp_raise_baseline(signal, chirped_bins.first, chirped_bins.second);
+    if (state.is_chirp) {
+        Microboone::Chirp_raise_baseline(signal, state.chirped_bins.first, state.chirped_bins.second);
         Microboone::SignalFilter(signal);
         Microboone::RawAdapativeBaselineAlg(signal);
     }
     // Now do the adaptive baseline for the bad RC channels
-    if (is_partial) {
+    if (state.is_partial) {
         // add something
         WireCell::Waveform::BinRange temp_chirped_bins;
         temp_chirped_bins.first = 0;
@@ -1036,8 +1046,8 @@ WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, si
     Microboone::SignalFilter(signal);
 
     //
-    const float min_rms = m_noisedb->min_rms_cut(ch);
-    const float max_rms = m_noisedb->max_rms_cut(ch);
+    const float min_rms = cp.min_rms_cut;
+    const float max_rms = cp.max_rms_cut;
 
     // std::cerr << "OneChannelNoise: "<<ch<< " RMS:["<<min_rms<<","<<max_rms<<"] sigsum="<<Waveform::sum(signal)<<"\n";
 
@@ -1051,14 +1061,79 @@ WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, si
         //           <<", is_partial="<<is_partial
         //           <<", baseline="<<baseline<<std::endl;
 
-        chirped_bins.first = 0;
-        chirped_bins.second = signal.size();
-        ret["noisy"][ch].push_back(chirped_bins);
+        WireCell::Waveform::BinRange noisy_bins;
+        noisy_bins.first = 0;
+        noisy_bins.second = signal.size();
+        ret["noisy"][ch].push_back(noisy_bins);
 
         if (ret.find("lf_noisy") != ret.end()) {
             if (ret["lf_noisy"].find(ch) != ret["lf_noisy"].end()) ret["lf_noisy"].erase(ch);
         }
     }
+}
+
+WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply(int ch, signal_t& signal) const
+{
+    WireCell::Waveform::ChannelMaskMap ret;
+    ChannelState state;
+
+    // Only what this filter uses, from the single value methods.
+    // The bulk channel_params() is kept for apply_block().
+    params_t cp;
+    cp.channel = ch;
+    cp.nominal_baseline = m_noisedb->nominal_baseline(ch);
+    cp.gain_correction = m_noisedb->gain_correction(ch);
+    cp.min_rms_cut = m_noisedb->min_rms_cut(ch);
+    cp.max_rms_cut = m_noisedb->max_rms_cut(ch);
+    cp.rcrc = &m_noisedb->rcrc(ch);
+    cp.config = &m_noisedb->config(ch);
+    cp.noise = &m_noisedb->noise(ch);
+
+    pre_dft(cp, signal, state, ret);
+
+    auto spectrum = fwd_r2c(m_dft, signal);
+    filter_spectrum(cp, spectrum, state);
+    signal = inv_c2r(m_dft, spectrum);
+
+    post_dft(cp, signal, state, ret);
+
+    return ret;
+}
+
+WireCell::Waveform::ChannelMaskMap Microboone::OneChannelNoise::apply_block(const std::vector<int>& channels,
+                                                                            WireCell::Array::array_xxf& block) const
+{
+    const int nrows = block.rows();
+    const int ncols = block.cols();
+    if (nrows != (int) channels.size()) {
+        THROW(ValueError() << errmsg{"OneChannelNoise: block rows do not match number of channels"});
+    }
+
+    WireCell::Waveform::ChannelMaskMap ret;
+    std::vector<ChannelState> states(nrows);
+    const auto params = m_noisedb->channel_params(channels);
+
+    signal_t signal(ncols);
+    for (int irow = 0; irow < nrows; ++irow) {
+        Eigen::Map<Eigen::ArrayXXf>(signal.data(), 1, ncols) = block.row(irow);
+        pre_dft(params[irow], signal, states[irow], ret);
+        block.row(irow) = Eigen::Map<Eigen::ArrayXXf>(signal.data(), 1, ncols);
+    }
+
+    auto spectra = fwd_r2c(m_dft, block, 1);
+    WireCell::Waveform::compseq_t spectrum(ncols);
+    for (int irow = 0; irow < nrows; ++irow) {
+        Eigen::Map<Eigen::ArrayXXcf>(spectrum.data(), 1, ncols) = spectra.row(irow);
+        filter_spectrum(params[irow], spectrum, states[irow]);
+        spectra.row(irow) = Eigen::Map<Eigen::ArrayXXcf>(spectrum.data(), 1, ncols);
+    }
+    inv_c2r(m_dft, spectra, block, 1);
+
+    for (int irow = 0; irow < nrows; ++irow) {
+        Eigen::Map<Eigen::ArrayXXf>(signal.data(), 1, ncols) = block.row(irow);
+        post_dft(params[irow], signal, states[irow], ret);
+        block.row(irow) = Eigen::Map<Eigen::ArrayXXf>(signal.data(), 1, ncols);
+    }
 
     return ret;
 }
@@ -3,6 +3,7 @@
 #include "WireCellUtil/Response.h"
 #include "WireCellUtil/NamedFactory.h"
 
+#include <algorithm>
 #include <cmath>
 
 WIRECELL_FACTORY(OmniChannelNoiseDB, WireCell::SigProc::OmniChannelNoiseDB, WireCell::IChannelNoiseDatabase,
@@ -286,8 +287,8 @@ void OmniChannelNoiseDB::set_misconfigured(const std::vector<int>& channels, dou
 {
     if (reset) {
         auto def = default_filter();
-        for (auto& it : m_db) {
-            it.second.config = def;
+        for (auto& ci : m_db) {
+            ci.config = def;
         }
     }
     auto val = get_reconfig(from_gain, from_shaping, to_gain, to_shaping);
@@ -356,12 +357,11 @@ OmniChannelNoiseDB::shared_filter_t OmniChannelNoiseDB::parse_response(Json::Val
 
 OmniChannelNoiseDB::ChannelInfo& OmniChannelNoiseDB::get_ci(int chid)
 {
-    auto it = m_db.find(chid);
-    if (it == m_db.end()) {
+    const size_t ind = chid - m_chmin;
+    if (ind >= m_dbind.size() or m_dbind[ind] < 0) {
         THROW(KeyError() << errmsg{String::format("no db info for channel %d", chid)});
     }
-    return it->second;
-    // return m_db.at(chid);
+    return m_db[m_dbind[ind]];
 }
 
 // template <typename Type>
@@ -596,9 +596,18 @@ void OmniChannelNoiseDB::configure(const WireCell::Configuration& cfg)
     //    delete it->second;
     // }
     // m_db.clear();
-    for (auto ch : m_anode->channels()) {
-        // m_db.insert(std::make_pair(ch, new ChannelInfo));
-        m_db[ch] = ChannelInfo();
+    auto chans = m_anode->channels();
+    std::sort(chans.begin(), chans.end());
+    chans.erase(std::unique(chans.begin(), chans.end()), chans.end());
+    m_db.assign(chans.size(), ChannelInfo());
+    m_dbind.clear();
+    m_chmin = chans.empty() ? 0 : chans.front();
+    if (!chans.empty()) {
+        m_dbind.assign(chans.back() - m_chmin + 1, -1);
+    }
+    for (size_t ind = 0; ind < chans.size(); ++ind) {
+        m_db[ind].chid = chans[ind];
+        m_dbind[chans[ind] - m_chmin] = ind;
     }
 
     m_channel_groups.clear();
@@ -658,7 +667,7 @@ float OmniChannelNoiseDB::coherent_nf_roi_min_max_ratio(int channel) const { ret
 
 const IChannelNoiseDatabase::filter_t& OmniChannelNoiseDB::rcrc(int channel) const
 {
-    auto filt = dbget(channel).rcrc;
+    const auto& filt = dbget(channel).rcrc;
     if (filt) {
         return *filt;
     }
@@ -668,7 +677,7 @@ const IChannelNoiseDatabase::filter_t& OmniChannelNoiseDB::rcrc(int channel) con
 
 const IChannelNoiseDatabase::filter_t& OmniChannelNoiseDB::config(int channel) const
 {
-    auto filt = dbget(channel).config;
+    const auto& filt = dbget(channel).config;
     if (filt) {
         return *filt;
     }
@@ -678,7 +687,7 @@ const IChannelNoiseDatabase::filter_t& OmniChannelNoiseDB::config(int channel) c
 
 const IChannelNoiseDatabase::filter_t& OmniChannelNoiseDB::noise(int channel) const
 {
-    auto filt = dbget(channel).noise;
+    const auto& filt = dbget(channel).noise;
     if (filt) {
         return *filt;
     }
@@ -688,7 +697,7 @@ const IChannelNoiseDatabase::filter_t& OmniChannelNoiseDB::noise(int channel) co
 
 const IChannelNoiseDatabase::filter_t& OmniChannelNoiseDB::response(int channel) const
 {
-    auto filt = dbget(channel).response;
+    const auto& filt = dbget(channel).response;
     if (filt) {
         return *filt;
     }
@@ -696,6 +705,39 @@ const IChannelNoiseDatabase::filter_t& OmniChannelNoiseDB::response(int channel)
     return dummy;
 }
 
+std::vector<IChannelNoiseDatabase::ChannelParams>
+OmniChannelNoiseDB::channel_params(const channel_group_t& channels) const
+{
+    static filter_t dummy;
+    auto fptr = [](const shared_filter_t& filt) -> const filter_t* { return filt ? filt.get() : &dummy; };
+
+    std::vector<ChannelParams> ret(channels.size());
+    for (size_t ind = 0; ind < channels.size(); ++ind) {
+        const auto& ci = dbget(channels[ind]);
+        auto& cp = ret[ind];
+        cp.channel = channels[ind];
+        cp.nominal_baseline = ci.nominal_baseline;
+        cp.gain_correction = ci.gain_correction;
+        cp.response_offset = ci.response_offset;
+        cp.min_rms_cut = ci.min_rms_cut;
+        cp.max_rms_cut = ci.max_rms_cut;
+        cp.pad_window_front = ci.pad_window_front;
+        cp.pad_window_back = ci.pad_window_back;
+        cp.decon_limit = ci.decon_limit;
+        cp.decon_lf_cutoff = ci.decon_lf_cutoff;
+        cp.adc_limit = ci.adc_limit;
+        cp.decon_limit1 = ci.decon_limit1;
+        cp.protection_factor = ci.protection_factor;
+        cp.min_adc_limit = ci.min_adc_limit;
+        cp.roi_min_max_ratio = ci.roi_min_max_ratio;
+        cp.rcrc = fptr(ci.rcrc);
+        cp.config = fptr(ci.config);
+        cp.noise = fptr(ci.noise);
+        cp.response = fptr(ci.response);
+    }
+    return ret;
+}
+
 // Local Variables:
 // mode: c++
 // c-basic-offset: 4
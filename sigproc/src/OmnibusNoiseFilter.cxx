@@ -8,11 +8,14 @@
 #include "WireCellAux/SimpleTrace.h"
 
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Parallel.h"
 // #include "WireCellUtil/ExecMon.h" // debugging
 
 #include "WireCellAux/FrameTools.h"
 
+#include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 
 WIRECELL_FACTORY(OmnibusNoiseFilter,
                  WireCell::SigProc::OmnibusNoiseFilter,
@@ -71,6 +74,9 @@ void OmnibusNoiseFilter::configure(const WireCell::Configuration& cfg)
 
     m_intag = get(cfg, "intraces", m_intag);
     m_outtag = get(cfg, "outtraces", m_outtag);
+
+    m_nthreads = get(cfg, "nthreads", m_nthreads);
+    m_batch_channels = get(cfg, "batch_channels", m_batch_channels);
 }
 
 WireCell::Configuration OmnibusNoiseFilter::default_configuration() const
@@ -91,6 +97,17 @@ WireCell::Configuration OmnibusNoiseFilter::default_configuration() const
     // The tags for input and output traces
     cfg["intraces"] = m_intag;
     cfg["outtraces"] = m_outtag;
+
+    // Number of threads used to apply the channel filters and the
+    // grouped filters.  The output does not depend on this number.
+    // Zero uses one thread per hardware core.
+    cfg["nthreads"] = m_nthreads;
+
+    // If positive, apply the channel filters to blocks of up to this
+    // many channels, one channel per row.  Filters which implement
+    // IChannelFilter::apply_block() may then transform a whole block
+    // at once.  Blocks are spread over the threads.
+    cfg["batch_channels"] = m_batch_channels;
     return cfg;
 }
 
@@ -144,14 +161,28 @@ bool OmnibusNoiseFilter::operator()(const input_pointer& inframe, output_pointer
 
     int nchanged_samples = 0;
 
+    // Filters may run concurrently.  Each fills its own masks which
+    // are merged in a fixed order after so the output does not depend
+    // on the number of threads.
+    using masks_t = std::vector<Waveform::ChannelMaskMap>;
+    auto merge_masks = [&](std::vector<masks_t>& all_masks) {
+        for (auto& masks : all_masks) {
+            for (auto& one : masks) {
+                Waveform::merge(cmm, one, m_maskmap);
+            }
+        }
+    };
+
     // Collect our working area indexed by channel.
     std::unordered_map<int, Aux::SimpleTrace*> bychan;
+    std::vector<Aux::SimpleTrace*> inorder;
     for (auto trace : traces) {
         int ch = trace->channel();
 
         // make working area directly in simple trace to avoid memory fragmentation
         auto signal = new Aux::SimpleTrace(ch, 0, m_nticks);
         bychan[ch] = signal;
+        inorder.push_back(signal);
 
         // if good
         if (find(bad_channels.begin(), bad_channels.end(), ch) == bad_channels.end()) {
@@ -165,54 +196,104 @@ bool OmnibusNoiseFilter::operator()(const input_pointer& inframe, output_pointer
                 nchanged_samples += std::abs((int) m_nticks - (int) ncharges);
             }
         }
-
-        int filt_count = 0;
-        for (auto filter : m_perchan) {
-            auto masks = filter->apply(ch, signal->charge());
-
-            // fixme: probably should assure these masks do not lead to out-of-bounds...
-
-            Waveform::merge(cmm, masks, m_maskmap);
-            ++filt_count;
-        }
     }
     traces.clear();  // done with our copy of vector of shared pointers
 
+    if (m_batch_channels > 0) {
+        const size_t nbatch = m_batch_channels;
+        const size_t nblocks = (inorder.size() + nbatch - 1) / nbatch;
+        std::vector<masks_t> all_masks(nblocks);
+        Parallel::for_each_index(nblocks, m_nthreads, [&](size_t iblock) {
+            const size_t first = iblock * nbatch;
+            const size_t nrows = std::min(nbatch, inorder.size() - first);
+            std::vector<int> channels(nrows);
+            Array::array_xxf block(nrows, m_nticks);
+            for (size_t irow = 0; irow < nrows; ++irow) {
+                auto signal = inorder[first + irow];
+                channels[irow] = signal->channel();
+                block.row(irow) = Eigen::Map<const Eigen::ArrayXXf>(signal->charge().data(), 1, m_nticks);
+            }
+            for (auto filter : m_perchan) {
+                all_masks[iblock].push_back(filter->apply_block(channels, block));
+            }
+            for (size_t irow = 0; irow < nrows; ++irow) {
+                auto& charge = inorder[first + irow]->charge();
+                Eigen::Map<Eigen::ArrayXXf>(charge.data(), 1, m_nticks) = block.row(irow);
+            }
+        });
+        merge_masks(all_masks);
+    }
+    else {
+        std::vector<masks_t> all_masks(inorder.size());
+        Parallel::for_each_index(inorder.size(), m_nthreads, [&](size_t ind) {
+            auto signal = inorder[ind];
+            for (auto filter : m_perchan) {
+                // fixme: probably should assure these masks do not lead to out-of-bounds...
+                all_masks[ind].push_back(filter->apply(signal->channel(), signal->charge()));
+            }
+        });
+        merge_masks(all_masks);
+    }
+
     if (nchanged_samples) {
         log->warn("warning, truncated or extended {} samples", nchanged_samples);
     }
 
-    int group_counter = 0;
+    // Only groups with all channels present are filtered.
+    const auto all_groups = m_noisedb->coherent_channels();
+    std::vector<const IChannelNoiseDatabase::channel_group_t*> groups;
+    bool overlapping = false;
     int nunknownchans = 0;
-    for (auto group : m_noisedb->coherent_channels()) {
-        ++group_counter;
-
-        int flag = 1;
-
-        IChannelFilter::channel_signals_t chgrp;
-        for (auto ch : group) {  // fix me: check if we don't actually have this channel
-                                 // std::cout << group_counter << " " << ch << " " << std::endl;
-            if (bychan.find(ch) == bychan.end()) {
-                ++nunknownchans;
-                flag = 0;
+    {
+        std::unordered_set<int> seen;
+        for (const auto& group : all_groups) {
+            int flag = 1;
+            for (auto ch : group) {  // fix me: check if we don't actually have this channel
+                if (bychan.find(ch) == bychan.end()) {
+                    ++nunknownchans;
+                    flag = 0;
+                }
             }
-            else {
-                chgrp[ch] = bychan[ch]->charge();  // copy...
+            if (flag == 0) continue;
+
+            for (auto ch : group) {
+                if (!seen.insert(ch).second) {
+                    overlapping = true;
+                }
             }
+            groups.push_back(&group);
         }
+    }
+    if (overlapping and m_nthreads != 1) {
+        log->warn("coherent channel groups overlap, applying grouped filters serially");
+    }
 
-        if (flag == 0) continue;
+    {
+        std::vector<masks_t> all_masks(groups.size());
+        auto apply_group = [&](size_t ind) {
+            IChannelFilter::channel_signals_t chgrp;
+            for (auto ch : *groups[ind]) {
+                chgrp[ch] = bychan.at(ch)->charge();  // copy...
+            }
 
-        for (auto filter : m_grouped) {
-            auto masks = filter->apply(chgrp);
+            for (auto filter : m_grouped) {
+                all_masks[ind].push_back(filter->apply(chgrp));
+            }
 
-            Waveform::merge(cmm, masks, m_maskmap);
+            for (auto cs : chgrp) {
+                // cs.second; // copy
+                bychan.at(cs.first)->charge().assign(cs.second.begin(), cs.second.end());
+            }
+        };
+        if (overlapping) {
+            for (size_t ind = 0; ind < groups.size(); ++ind) {
+                apply_group(ind);
+            }
         }
-
-        for (auto cs : chgrp) {
-            // cs.second; // copy
-            bychan[cs.first]->charge().assign(cs.second.begin(), cs.second.end());
+        else {
+            Parallel::for_each_index(groups.size(), m_nthreads, apply_group);
         }
+        merge_masks(all_masks);
     }
 
     if (nunknownchans) {
@@ -220,14 +301,19 @@ bool OmnibusNoiseFilter::operator()(const input_pointer& inframe, output_pointer
     }
 
     // run status
-    for (auto& it : bychan) {
-        const int ch = it.first;
-        IChannelFilter::signal_t& signal = it.second->charge();
-        for (auto filter : m_perchan_status) {
-            auto masks = filter->apply(ch, signal);
-
-            Waveform::merge(cmm, masks, m_maskmap);
+    {
+        std::vector<Aux::SimpleTrace*> bychan_order;
+        for (auto& it : bychan) {
+            bychan_order.push_back(it.second);
         }
+        std::vector<masks_t> all_masks(bychan_order.size());
+        Parallel::for_each_index(bychan_order.size(), m_nthreads, [&](size_t ind) {
+            auto trace = bychan_order[ind];
+            for (auto filter : m_perchan_status) {
+                all_masks[ind].push_back(filter->apply(trace->channel(), trace->charge()));
+            }
+        });
+        merge_masks(all_masks);
     }
 
     ITrace::vector itraces;
@@ -17,6 +17,7 @@
 #include "WireCellUtil/Exceptions.h"
 #include "WireCellUtil/String.h"
 #include "WireCellUtil/FFTBestLength.h"
+#include "WireCellUtil/Parallel.h"
 #include "WireCellUtil/Waveform.h"
 
 #include "WireCellUtil/NamedFactory.h"
@@ -34,6 +35,38 @@ using WireCell::Aux::DftTools::fwd_r2c;
 using WireCell::Aux::DftTools::inv;
 using WireCell::Aux::DftTools::inv_c2r;
 
+namespace {
+    // Traces saved while processing one plane.  Index lists are
+    // local to "traces" and keyed by the frame-level list they
+    // extend.
+    struct PlaneTraces {
+        ITrace::vector traces;
+        IFrame::trace_summary_t thresholds;
+        std::map<IFrame::trace_list_t*, IFrame::trace_list_t> indices;
+
+        IFrame::trace_list_t& operator[](IFrame::trace_list_t& frame_indices)
+        {
+            return indices[&frame_indices];
+        }
+
+        // Append to the frame-level traces and index lists and reset.
+        void merge(ITrace::vector& itraces, IFrame::trace_summary_t& frame_thresholds)
+        {
+            const size_t offset = itraces.size();
+            itraces.insert(itraces.end(), traces.begin(), traces.end());
+            for (auto& [frame_indices, local] : indices) {
+                for (auto ind : local) {
+                    frame_indices->push_back(ind + offset);
+                }
+            }
+            frame_thresholds.insert(frame_thresholds.end(), thresholds.begin(), thresholds.end());
+            traces.clear();
+            thresholds.clear();
+            indices.clear();
+        }
+    };
+}
+
 OmnibusSigProc::OmnibusSigProc(    )
   : Aux::Logger("OmnibusSigProc", "sigproc")
 {
@@ -62,6 +95,7 @@ void OmnibusSigProc::configure(const WireCell::Configuration& config)
     std::string dft_tn = get<std::string>(config, "dft", "FftwDFT");
     m_dft = Factory::find_tn<IDFT>(dft_tn);
     m_verbose = get(config, "verbose", 0);
+    m_parallel_planes = get(config, "parallel_planes", m_parallel_planes);
 
     // m_nticks = get(config,"nticks",m_nticks);
     if (!config["nticks"].isNull()) {
@@ -159,6 +193,10 @@ void OmnibusSigProc::configure(const WireCell::Configuration& config)
 
     m_isWrapped = get<bool>(config, "isWrapped", m_isWrapped);
 
+    // Configuration may change any cached spectra.
+    m_resp_nticks = 0;
+    m_filter_spectra.clear();
+
     // this throws if not found
     m_anode = Factory::find_tn<IAnodePlane>(m_anode_tn);
 
@@ -222,6 +260,7 @@ WireCell::Configuration OmnibusSigProc::default_configuration() const
     cfg["anode"] = m_anode_tn;
     cfg["dft"] = "FftwDFT";     // type-name for the DFT to use
     cfg["verbose"] = 0;         // larger is more more logging 
+    cfg["parallel_planes"] = m_parallel_planes; // process planes concurrently
     cfg["ftoffset"] = m_fine_time_offset;
     cfg["ctoffset"] = m_coarse_time_offset;
     // cfg["nticks"] = m_nticks;
@@ -303,19 +342,22 @@ WireCell::Configuration OmnibusSigProc::default_configuration() const
 
 void OmnibusSigProc::load_data(const input_pointer& in, int plane)
 {
-    m_r_data[plane] = Array::array_xxf::Zero(m_fft_nwires[plane], m_fft_nticks);
+    auto& r_padded = m_work[plane].r_padded;
+    r_padded.resize(m_fft_nwires[plane], m_fft_nticks);
+    r_padded.setZero();
 
     auto traces = in->traces();
 
-    auto& bad = m_wanmm["bad"];
+    // Planes may load concurrently so only read the shared maps.
+    const auto& bad = m_wanmm.at("bad");
     int nbad = 0;
 
     for (auto trace : *traces.get()) {
-        int wct_channel_ident = trace->channel();
-        OspChan och = m_channel_map[wct_channel_ident];
-        if (plane != och.plane) {
+        auto chit = m_channel_map.find(trace->channel());
+        if (chit == m_channel_map.end() or plane != chit->second.plane) {
             continue;  // we'll catch it in another call to load_data
         }
+        const OspChan& och = chit->second;
 
         // fixme: this code uses tbin() but other places in this file will barf if tbin!=0.
         int tbin = trace->tbin();
@@ -323,7 +365,7 @@ void OmnibusSigProc::load_data(const input_pointer& in, int plane)
         const int ntbins = std::min((int) charges.size(), m_nticks);
         for (int qind = 0; qind < ntbins; ++qind) {
             const float q = charges[qind];
-            m_r_data[plane](och.wire + m_pad_nwires[plane], tbin + qind) = q;
+            r_padded(och.wire + m_pad_nwires[plane], tbin + qind) = q;
         }
 
         // ensure dead channels are indeed dead ...
@@ -336,19 +378,34 @@ void OmnibusSigProc::load_data(const input_pointer& in, int plane)
         for (auto const& br : binranges) {
             ++nbad;
             for (int i = br.first; i != br.second; ++i) {
-                m_r_data[plane](och.wire + m_pad_nwires[plane], i) = 0;
+                r_padded(och.wire + m_pad_nwires[plane], i) = 0;
             }
         }
     }
     //rebase for this plane
     if (std::find(m_rebase_planes.begin(), m_rebase_planes.end(), plane) != m_rebase_planes.end()) {
         log->debug("rebase_waveform for plane {} with m_rebase_nbins = {}", plane, m_rebase_nbins);
-        rebase_waveform(m_r_data[plane],m_rebase_nbins);
+        rebase_waveform(r_padded, m_rebase_nbins);
     }
 
     log->debug("call={} load plane index: {}, ntraces={}, input bad regions: {}",
                m_count, plane, traces->size(), nbad);
-    check_data(plane, "load data");
+    check_data(r_padded, plane, "load data");
+}
+
+void OmnibusSigProc::for_each_plane(const std::function<void(int)>& func)
+{
+    std::vector<int> planes;
+    for (int iplane = 0; iplane != 3; ++iplane) {
+        auto it = std::find(m_process_planes.begin(), m_process_planes.end(), iplane);
+        if (it != m_process_planes.end()) {
+            planes.push_back(iplane);
+        }
+    }
+
+    // One thread per plane, or all on this one.
+    const int nthreads = m_parallel_planes ? planes.size() : 1;
+    Parallel::for_each_index(planes.size(), nthreads, [&](size_t ind) { func(planes[ind]); });
 }
 
 // used in sparsifying below.  Could use C++17 lambdas....
@@ -356,12 +413,14 @@ static bool ispositive(float x) { return x > 0.0; }
 static bool isZero(float x) { return x == 0.0; }
 
 void OmnibusSigProc::check_data(int iplane, const std::string& loglabel)
+{
+    check_data(m_r_data[iplane], iplane, loglabel);
+}
+
+void OmnibusSigProc::check_data(const Array::array_xxf& arr, int iplane, const std::string& loglabel)
 {
     if (!m_verbose) { return; }
 
-    std::stringstream ss;
-    auto& arr = m_r_data[iplane];
-    
     log->debug("data: plane={}, sum={}, mean={}, min={}, max={} \"{}\"",
                iplane,
                arr.sum(), arr.mean(), arr.minCoeff(), arr.maxCoeff(), 
@@ -381,6 +440,7 @@ void OmnibusSigProc::save_data(
     // reuse this temporary vector to hold charge for a channel.
     ITrace::ChargeSequence charge(m_nticks, 0.0);
 
+    const size_t nbefore = indices.size();
     double qloss = 0.0;
     double qtot = 0.0;
     for (auto och : m_channel_range[plane]) {  // ordered by osp channel
@@ -405,7 +465,7 @@ void OmnibusSigProc::save_data(
             }
         }
         {
-            auto& bad = m_wanmm["bad"];
+            const auto& bad = m_wanmm.at("bad");
             auto badit = bad.find(och.channel);
             if (badit != bad.end()) {
                 for (auto bad : badit->second) {
@@ -456,17 +516,17 @@ void OmnibusSigProc::save_data(
         }
     }
 
-    // debug
-    if (indices.empty()) {
+    // debug.  The indices are local to the plane until merged into
+    // the frame, where their frame indices are logged.
+    const size_t nsaved = indices.size() - nbefore;
+    if (!nsaved) {
         log->debug("call={} {} save plane index: {} empty",
                    m_count, loglabel, plane);
     }
     else {
         log->debug("call={} save plane index: {}, Qtot={} Qloss={}, "
-                   "{} indices spanning [{},{}] \"{}\"",
-                   m_count, plane, qtot, qloss,
-                   indices.size(), indices.front(), indices.back(),
-                   loglabel);
+                   "{} traces \"{}\"",
+                   m_count, plane, qtot, qloss, nsaved, loglabel);
     }
     check_data(plane, loglabel + " after save");
 }
@@ -511,7 +571,7 @@ void OmnibusSigProc::save_roi(ITrace::vector& itraces, IFrame::trace_list_t& ind
         }
 
         {
-            auto& bad = m_wanmm["bad"];
+            const auto& bad = m_wanmm.at("bad");
             auto badit = bad.find(och.channel);
             if (badit != bad.end()) {
                 for (auto bad : badit->second) {
@@ -594,7 +654,7 @@ void OmnibusSigProc::save_ext_roi(ITrace::vector& itraces, IFrame::trace_list_t&
         }
 
         {
-            auto& bad = m_wanmm["bad"];
+            const auto& bad = m_wanmm.at("bad");
             auto badit = bad.find(och.channel);
             if (badit != bad.end()) {
                 for (auto bad : badit->second) {
@@ -662,7 +722,7 @@ void OmnibusSigProc::save_mproi(ITrace::vector& itraces, IFrame::trace_list_t& i
         }
 
         {
-            auto& bad = m_wanmm["bad"];
+            const auto& bad = m_wanmm.at("bad");
             auto badit = bad.find(och.channel);
             if (badit != bad.end()) {
                 for (auto bad : badit->second) {
@@ -733,6 +793,13 @@ void OmnibusSigProc::init_overall_response(IFrame::pointer frame)
         m_pad_nticks = m_fft_nticks - m_nticks;
     }
 
+    // The responses depend only on configuration and frame shape.
+    if (m_fft_nticks == m_resp_nticks and m_period == m_resp_period) {
+        return;
+    }
+    log->debug("call={} init response spectra for nticks={} period={}",
+               m_count, m_fft_nticks, m_period);
+
     // Fixme: this should be moved into configure()
     auto ifr = Factory::find_tn<IFieldResponse>(m_field_response);
     // Get full, "fine-grained" field responses defined at impact
@@ -861,7 +928,97 @@ void OmnibusSigProc::init_overall_response(IFrame::pointer frame)
         // calculated the wire shift ...
         m_wire_shift[iplane] = (int(overall_resp[iplane].size()) - 1) / 2;
 
+        // 2D spectrum of the response as used in decon_2D_init().
+        Array::array_xxf r_resp = Array::array_xxf::Zero(m_fft_nwires[iplane], m_fft_nticks);
+        for (size_t i = 0; i != overall_resp[iplane].size(); i++) {
+            for (int j = 0; j != m_fft_nticks; j++) {
+                r_resp(i, j) = overall_resp[iplane].at(i).at(j);
+            }
+        }
+        // do first round FFT on the resposne on time
+        m_resp_spectrum[iplane] = fwd_r2c(m_dft, r_resp, 1);
+        // do second round FFT on the response on wire
+        m_resp_spectrum[iplane] = fwd(m_dft, m_resp_spectrum[iplane], 0);
+
     }  //  loop over plane
+
+    init_channel_correction();
+
+    m_resp_nticks = m_fft_nticks;
+    m_resp_period = m_period;
+}
+
+void OmnibusSigProc::init_channel_correction()
+{
+    for (int iplane = 0; iplane < 3; ++iplane) {
+        m_chan_correction[iplane].resize(0, 0);
+    }
+    if (m_per_chan_resp.empty()) {
+        return;
+    }
+
+    auto cr = Factory::find_tn<IChannelResponse>(m_per_chan_resp);
+    auto cr_bins = cr->channel_response_binning();
+    if (cr_bins.binsize() != m_period) {
+        log->critical("call={} init_channel_correction: channel response size mismatch", m_count);
+        THROW(ValueError() << errmsg{"OmnibusSigProc::init_channel_correction: channel response size mismatch"});
+    }
+
+    WireCell::Binning tbins(m_fft_nticks, cr_bins.min(), cr_bins.min() + m_fft_nticks * m_period);
+
+    auto ewave = (*m_elecresponse).waveform_samples(tbins);
+    const WireCell::Waveform::compseq_t elec = fwd_r2c(m_dft, ewave);
+
+    for (int iplane = 0; iplane < 3; ++iplane) {
+        auto& corr = m_chan_correction[iplane];
+        corr = Array::array_xxc::Ones(m_fft_nwires[iplane], m_fft_nticks);
+
+        for (auto och : m_channel_range[iplane]) {
+            // const auto& ch_resp = cr->channel_response(och.ident);
+            Waveform::realseq_t tch_resp = cr->channel_response(och.ident);
+            tch_resp.resize(m_fft_nticks, 0);
+            const WireCell::Waveform::compseq_t ch_elec = fwd_r2c(m_dft, tch_resp);
+
+            const int irow = och.wire + m_pad_nwires[iplane];
+            for (int icol = 0; icol != m_fft_nticks; icol++) {
+                const auto four = ch_elec.at(icol);
+                if (std::abs(four) != 0) {
+                    corr(irow, icol) = elec.at(icol) / four;
+                }
+                else {
+                    corr(irow, icol) = 0;
+                }
+            }
+        }
+    }
+}
+
+const Waveform::realseq_t& OmnibusSigProc::filter_spectrum(const std::vector<std::string>& filter_tns, int nbins)
+{
+    std::string key = std::to_string(nbins);
+    for (const auto& tn : filter_tns) {
+        key += " " + tn;
+    }
+
+    std::lock_guard<std::mutex> lock(m_filter_mutex);
+    auto it = m_filter_spectra.find(key);
+    if (it != m_filter_spectra.end()) {
+        return it->second;
+    }
+
+    Waveform::realseq_t spec;
+    for (const auto& tn : filter_tns) {
+        auto filt = Factory::find_tn<IFilterWaveform>(tn);
+        if (spec.empty()) {
+            spec = filt->filter_waveform(nbins);
+            continue;
+        }
+        const auto temp_filter = filt->filter_waveform(nbins);
+        for (size_t i = 0; i != spec.size(); i++) {
+            spec.at(i) *= temp_filter.at(i);
+        }
+    }
+    return m_filter_spectra[key] = spec;
 }
 
 void OmnibusSigProc::restore_baseline(Array::array_xxf& arr)
@@ -943,110 +1100,66 @@ void OmnibusSigProc::rebase_waveform(Array::array_xxf& arr,const int& n_bins)
 
 void OmnibusSigProc::decon_2D_init(int plane)
 {
+    auto& r_padded = m_work[plane].r_padded;
+    auto& c_data = m_c_data[plane];
+
     // data part ...
     // first round of FFT on time
-    m_c_data[plane] = fwd_r2c(m_dft, m_r_data[plane], 1);
+    fwd_r2c(m_dft, r_padded, c_data, 1);
 
     // now apply the ch-by-ch response ...
     if (!m_per_chan_resp.empty()) {
         log->debug("call={} applying ch-by-ch electronics response correction", m_count);
-        auto cr = Factory::find_tn<IChannelResponse>(m_per_chan_resp);
-        auto cr_bins = cr->channel_response_binning();
-        if (cr_bins.binsize() != m_period) {
-            log->critical("call={} decon_2D_init: channel response size mismatch", m_count);
-            THROW(ValueError() << errmsg{"OmnibusSigProc::decon_2D_init: channel response size mismatch"});
-        }
-
-        WireCell::Binning tbins(m_fft_nticks, cr_bins.min(), cr_bins.min() + m_fft_nticks * m_period);
-
-        auto ewave = (*m_elecresponse).waveform_samples(tbins);
-        const WireCell::Waveform::compseq_t elec = fwd_r2c(m_dft, ewave);
-
-        for (auto och : m_channel_range[plane]) {
-            // const auto& ch_resp = cr->channel_response(och.ident);
-            Waveform::realseq_t tch_resp = cr->channel_response(och.ident);
-            tch_resp.resize(m_fft_nticks, 0);
-            const WireCell::Waveform::compseq_t ch_elec = fwd_r2c(m_dft, tch_resp);
-
-            const int irow = och.wire + m_pad_nwires[plane];
-            for (int icol = 0; icol != m_c_data[plane].cols(); icol++) {
-                const auto four = ch_elec.at(icol);
-                if (std::abs(four) != 0) {
-                    m_c_data[plane](irow, icol) *= elec.at(icol) / four;
-                }
-                else {
-                    m_c_data[plane](irow, icol) = 0;
-                }
-            }
-        }
+        c_data *= m_chan_correction[plane];
     }
 
     // second round of FFT on wire
-    m_c_data[plane] = fwd(m_dft, m_c_data[plane], 0);
-
-    // response part ...
-    Array::array_xxf r_resp = Array::array_xxf::Zero(m_r_data[plane].rows(), m_fft_nticks);
-    for (size_t i = 0; i != overall_resp[plane].size(); i++) {
-        for (int j = 0; j != m_fft_nticks; j++) {
-            r_resp(i, j) = overall_resp[plane].at(i).at(j);
-        }
-    }
-
-    // do first round FFT on the resposne on time
-    Array::array_xxc c_resp = fwd_r2c(m_dft, r_resp, 1);
-    // do second round FFT on the response on wire
-    c_resp = fwd(m_dft, c_resp, 0);
+    fwd(m_dft, c_data, c_data, 0);
 
     // make ratio to the response and apply wire filter
-    m_c_data[plane] = m_c_data[plane] / c_resp;
+    c_data /= m_resp_spectrum[plane];
 
     // apply software filter on wire
-    const std::vector<std::string> filter_names{"Wire_ind", "Wire_ind", "Wire_col"};
-    Waveform::realseq_t wire_filter_wf;
-    auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", filter_names[plane]);
-    wire_filter_wf = ncr1->filter_waveform(m_c_data[plane].rows());
-    for (int irow = 0; irow < m_c_data[plane].rows(); ++irow) {
-        for (int icol = 0; icol < m_c_data[plane].cols(); ++icol) {
-            float val = abs(m_c_data[plane](irow, icol));
+    const std::vector<std::string> filter_names{"HfFilter:Wire_ind", "HfFilter:Wire_ind", "HfFilter:Wire_col"};
+    const auto& wire_filter_wf = filter_spectrum({filter_names[plane]}, c_data.rows());
+    for (int irow = 0; irow < c_data.rows(); ++irow) {
+        for (int icol = 0; icol < c_data.cols(); ++icol) {
+            float val = abs(c_data(irow, icol));
             if (std::isnan(val)) {
-                m_c_data[plane](irow, icol) = -0.0;
+                c_data(irow, icol) = -0.0;
             }
             if (std::isinf(val)) {
-                m_c_data[plane](irow, icol) = 0.0;
+                c_data(irow, icol) = 0.0;
             }
-            m_c_data[plane](irow, icol) *= wire_filter_wf.at(irow);
+            c_data(irow, icol) *= wire_filter_wf.at(irow);
         }
     }
 
     // do the first round of inverse FFT on wire
-    m_c_data[plane] = inv(m_dft, m_c_data[plane], 0);
+    inv(m_dft, c_data, c_data, 0);
 
     // do the second round of inverse FFT on time
-    m_r_data[plane] = inv_c2r(m_dft, m_c_data[plane], 1);
+    inv_c2r(m_dft, c_data, r_padded, 1);
+
+    // Storage is column-wise so each column is a contiguous waveform
+    // across wires and the columns are contiguous in time.  The
+    // shifts are thus done in place by rotating.
+    const int nrows = r_padded.rows();
+    const int ncols = r_padded.cols();
+    float* data = r_padded.data();
 
     // do the shift in wire
-    const int nrows = m_r_data[plane].rows();
-    const int ncols = m_r_data[plane].cols();
-    {
-        Array::array_xxf arr1(m_wire_shift[plane], ncols);
-        arr1 = m_r_data[plane].block(nrows - m_wire_shift[plane], 0, m_wire_shift[plane], ncols);
-        Array::array_xxf arr2(nrows - m_wire_shift[plane], ncols);
-        arr2 = m_r_data[plane].block(0, 0, nrows - m_wire_shift[plane], ncols);
-        m_r_data[plane].block(0, 0, m_wire_shift[plane], ncols) = arr1;
-        m_r_data[plane].block(m_wire_shift[plane], 0, nrows - m_wire_shift[plane], ncols) = arr2;
+    for (int icol = 0; icol < ncols; ++icol) {
+        float* col = data + icol * nrows;
+        std::rotate(col, col + nrows - m_wire_shift[plane], col + nrows);
     }
 
     // do the shift in time
     int time_shift = (m_coarse_time_offset + m_intrinsic_time_offset) / m_period;
     if (time_shift > 0) {
-        Array::array_xxf arr1(nrows, ncols - time_shift);
-        arr1 = m_r_data[plane].block(0, 0, nrows, ncols - time_shift);
-        Array::array_xxf arr2(nrows, time_shift);
-        arr2 = m_r_data[plane].block(0, ncols - time_shift, nrows, time_shift);
-        m_r_data[plane].block(0, 0, nrows, time_shift) = arr2;
-        m_r_data[plane].block(0, time_shift, nrows, ncols - time_shift) = arr1;
+        std::rotate(data, data + (ncols - time_shift) * nrows, data + ncols * nrows);
     }
-    m_c_data[plane] = fwd_r2c(m_dft, m_r_data[plane], 1);
+    fwd_r2c(m_dft, r_padded, c_data, 1);
 
 }
 
@@ -1054,13 +1167,12 @@ void OmnibusSigProc::decon_2D_ROI_refine(int plane)
 {
     // apply software filter on time
 
-    const std::vector<std::string> filter_names{"Wiener_tight_U", "Wiener_tight_V", "Wiener_tight_W"};
-    Waveform::realseq_t roi_hf_filter_wf;
-
-    auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", filter_names[plane]);
-    roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+    const std::vector<std::string> filter_names{"HfFilter:Wiener_tight_U", "HfFilter:Wiener_tight_V",
+                                                "HfFilter:Wiener_tight_W"};
+    const auto& roi_hf_filter_wf = filter_spectrum({filter_names[plane]}, m_c_data[plane].cols());
 
-    Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
+    auto& c_data_afterfilter = m_work[plane].c_filtered;
+    c_data_afterfilter.resize(m_c_data[plane].rows(), m_c_data[plane].cols());
     for (int irow = 0; irow < m_c_data[plane].rows(); ++irow) {
         for (int icol = 0; icol < m_c_data[plane].cols(); ++icol) {
             c_data_afterfilter(irow, icol) = m_c_data[plane](irow, icol) * roi_hf_filter_wf.at(icol);
@@ -1068,7 +1180,8 @@ void OmnibusSigProc::decon_2D_ROI_refine(int plane)
     }
 
     // do the second round of inverse FFT on wire
-    Array::array_xxf tm_r_data = inv_c2r(m_dft, c_data_afterfilter, 1);
+    auto& tm_r_data = m_work[plane].r_padded;
+    inv_c2r(m_dft, c_data_afterfilter, tm_r_data, 1);
 
     m_r_data[plane] = tm_r_data.block(m_pad_nwires[plane], 0, m_nwires[plane], m_nticks);
     restore_baseline(m_r_data[plane]);
@@ -1078,31 +1191,16 @@ void OmnibusSigProc::decon_2D_tightROI(int plane)
 {
     // apply software filter on time
 
-    Waveform::realseq_t roi_hf_filter_wf;
-    if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tight_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-        for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-            roi_hf_filter_wf.at(i) *= temp_filter.at(i);
-        }
-    }
-    else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tight_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-        for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-            roi_hf_filter_wf.at(i) *= temp_filter.at(i);
-        }
-    }
-    else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+    const std::vector<std::string> filter_names{"HfFilter:Wiener_tight_U", "HfFilter:Wiener_tight_V",
+                                                "HfFilter:Wiener_tight_W"};
+    std::vector<std::string> filter_tns{filter_names[plane]};
+    if (plane != 2) {
+        filter_tns.push_back("LfFilter:ROI_tight_lf");
     }
+    const auto& roi_hf_filter_wf = filter_spectrum(filter_tns, m_c_data[plane].cols());
 
-    Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
+    auto& c_data_afterfilter = m_work[plane].c_filtered;
+    c_data_afterfilter.resize(m_c_data[plane].rows(), m_c_data[plane].cols());
     for (int irow = 0; irow < m_c_data[plane].rows(); ++irow) {
         for (int icol = 0; icol < m_c_data[plane].cols(); ++icol) {
             c_data_afterfilter(irow, icol) = m_c_data[plane](irow, icol) * roi_hf_filter_wf.at(icol);
@@ -1110,7 +1208,8 @@ void OmnibusSigProc::decon_2D_tightROI(int plane)
     }
 
     // do the second round of inverse FFT on wire
-    Array::array_xxf tm_r_data = inv_c2r(m_dft, c_data_afterfilter, 1);
+    auto& tm_r_data = m_work[plane].r_padded;
+    inv_c2r(m_dft, c_data_afterfilter, tm_r_data, 1);
 
     m_r_data[plane] = tm_r_data.block(m_pad_nwires[plane], 0, m_nwires[plane], m_nticks);
     restore_baseline(m_r_data[plane]);
@@ -1121,31 +1220,16 @@ void OmnibusSigProc::decon_2D_tighterROI(int plane)
 {
     // apply software filter on time
 
-    Waveform::realseq_t roi_hf_filter_wf;
-    if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tighter_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-        for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-            roi_hf_filter_wf.at(i) *= temp_filter.at(i);
-        }
-    }
-    else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tighter_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-        for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-            roi_hf_filter_wf.at(i) *= temp_filter.at(i);
-        }
-    }
-    else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+    const std::vector<std::string> filter_names{"HfFilter:Wiener_tight_U", "HfFilter:Wiener_tight_V",
+                                                "HfFilter:Wiener_tight_W"};
+    std::vector<std::string> filter_tns{filter_names[plane]};
+    if (plane != 2) {
+        filter_tns.push_back("LfFilter:ROI_tighter_lf");
     }
+    const auto& roi_hf_filter_wf = filter_spectrum(filter_tns, m_c_data[plane].cols());
 
-    Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
+    auto& c_data_afterfilter = m_work[plane].c_filtered;
+    c_data_afterfilter.resize(m_c_data[plane].rows(), m_c_data[plane].cols());
     for (int irow = 0; irow < m_c_data[plane].rows(); ++irow) {
         for (int icol = 0; icol < m_c_data[plane].cols(); ++icol) {
             c_data_afterfilter(irow, icol) = m_c_data[plane](irow, icol) * roi_hf_filter_wf.at(icol);
@@ -1153,7 +1237,8 @@ void OmnibusSigProc::decon_2D_tighterROI(int plane)
     }
 
     // do the second round of inverse FFT on wire
-    Array::array_xxf tm_r_data = inv_c2r(m_dft, c_data_afterfilter, 1);
+    auto& tm_r_data = m_work[plane].r_padded;
+    inv_c2r(m_dft, c_data_afterfilter, tm_r_data, 1);
 
     m_r_data[plane] = tm_r_data.block(m_pad_nwires[plane], 0, m_nwires[plane], m_nticks);
     restore_baseline(m_r_data[plane]);
@@ -1167,63 +1252,24 @@ void OmnibusSigProc::decon_2D_looseROI(int plane)
 
     // apply software filter on time
 
-    Waveform::realseq_t roi_hf_filter_wf;
-    Waveform::realseq_t roi_hf_filter_wf1;
-    Waveform::realseq_t roi_hf_filter_wf2;
-    if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        roi_hf_filter_wf1 = roi_hf_filter_wf;
-        {
-            auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_loose_lf");
-            auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-            for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-                roi_hf_filter_wf.at(i) *= temp_filter.at(i);
-            }
-        }
-        {
-            auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tight_lf");
-            auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-            for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-                roi_hf_filter_wf1.at(i) *= temp_filter.at(i);
-            }
-        }
-    }
-    else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        roi_hf_filter_wf1 = roi_hf_filter_wf;
-        {
-            auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_loose_lf");
-            auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-            for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-                roi_hf_filter_wf.at(i) *= temp_filter.at(i);
-            }
-        }
-        {
-            auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_tight_lf");
-            auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-            for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-                roi_hf_filter_wf1.at(i) *= temp_filter.at(i);
-            }
-        }
-    }
-    else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-    }
+    const std::vector<std::string> filter_names{"HfFilter:Wiener_tight_U", "HfFilter:Wiener_tight_V",
+                                                "HfFilter:Wiener_tight_W"};
+    const auto& roi_hf_filter_wf =
+        filter_spectrum({filter_names[plane], "LfFilter:ROI_loose_lf"}, m_c_data[plane].cols());
+    const auto& roi_hf_filter_wf1 =
+        filter_spectrum({filter_names[plane], "LfFilter:ROI_tight_lf"}, m_c_data[plane].cols());
 
     const int n_lfn_nn = 2;
     const int n_bad_nn = plane ? 1 : 2;
 
-    Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
+    auto& c_data_afterfilter = m_work[plane].c_filtered;
+    c_data_afterfilter.resize(m_c_data[plane].rows(), m_c_data[plane].cols());
     for (auto och : m_channel_range[plane]) {
         const int irow = och.wire;
 
-        roi_hf_filter_wf2 = roi_hf_filter_wf;
-        if (masked_neighbors("bad", och, n_bad_nn) or masked_neighbors("lf_noisy", och, n_lfn_nn)) {
-            roi_hf_filter_wf2 = roi_hf_filter_wf1;
-        }
+        const auto& roi_hf_filter_wf2 =
+            (masked_neighbors("bad", och, n_bad_nn) or masked_neighbors("lf_noisy", och, n_lfn_nn))
+            ? roi_hf_filter_wf1 : roi_hf_filter_wf;
 
         for (int icol = 0; icol < m_c_data[plane].cols(); ++icol) {
             c_data_afterfilter(irow, icol) = m_c_data[plane](irow, icol) * roi_hf_filter_wf2.at(icol);
@@ -1231,7 +1277,8 @@ void OmnibusSigProc::decon_2D_looseROI(int plane)
     }
 
     // do the second round of inverse FFT on wire
-    Array::array_xxf tm_r_data = inv_c2r(m_dft, c_data_afterfilter, 1);
+    auto& tm_r_data = m_work[plane].r_padded;
+    inv_c2r(m_dft, c_data_afterfilter, tm_r_data, 1);
 
     m_r_data[plane] = tm_r_data.block(m_pad_nwires[plane], 0, m_nwires[plane], m_nticks);
     restore_baseline(m_r_data[plane]);
@@ -1245,31 +1292,16 @@ void OmnibusSigProc::decon_2D_looseROI_debug_mode(int plane)
         return;  // don't filter colleciton
     }
 
-    Waveform::realseq_t roi_hf_filter_wf;
-    if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_loose_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-        for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-            roi_hf_filter_wf.at(i) *= temp_filter.at(i);
-        }
-    }
-    else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-        auto ncr2 = Factory::find<IFilterWaveform>("LfFilter", "ROI_loose_lf");
-        auto temp_filter = ncr2->filter_waveform(m_c_data[plane].cols());
-        for (size_t i = 0; i != roi_hf_filter_wf.size(); i++) {
-            roi_hf_filter_wf.at(i) *= temp_filter.at(i);
-        }
-    }
-    else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_tight_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
+    const std::vector<std::string> filter_names{"HfFilter:Wiener_tight_U", "HfFilter:Wiener_tight_V",
+                                                "HfFilter:Wiener_tight_W"};
+    std::vector<std::string> filter_tns{filter_names[plane]};
+    if (plane != 2) {
+        filter_tns.push_back("LfFilter:ROI_loose_lf");
     }
+    const auto& roi_hf_filter_wf = filter_spectrum(filter_tns, m_c_data[plane].cols());
 
-    Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
+    auto& c_data_afterfilter = m_work[plane].c_filtered;
+    c_data_afterfilter.resize(m_c_data[plane].rows(), m_c_data[plane].cols());
     for (int irow = 0; irow < m_c_data[plane].rows(); ++irow) {
         for (int icol = 0; icol < m_c_data[plane].cols(); ++icol) {
             c_data_afterfilter(irow, icol) = m_c_data[plane](irow, icol) * roi_hf_filter_wf.at(icol);
@@ -1277,7 +1309,8 @@ void OmnibusSigProc::decon_2D_looseROI_debug_mode(int plane)
     }
 
     // do the second round of inverse FFT on wire
-    Array::array_xxf tm_r_data = inv_c2r(m_dft, c_data_afterfilter, 1);
+    auto& tm_r_data = m_work[plane].r_padded;
+    inv_c2r(m_dft, c_data_afterfilter, tm_r_data, 1);
 
     m_r_data[plane] = tm_r_data.block(m_pad_nwires[plane], 0, m_nwires[plane], m_nticks);
     restore_baseline(m_r_data[plane]);
@@ -1304,7 +1337,11 @@ bool OmnibusSigProc::masked_neighbors(const std::string& cmname, OspChan& ochan,
         return false;
     }
 
-    auto& cm = m_wanmm[cmname];
+    auto cmit = m_wanmm.find(cmname);
+    if (cmit == m_wanmm.end()) {
+        return false;
+    }
+    const auto& cm = cmit->second;
     for (int och = lo_chan; och <= hi_chan; ++och) {
         if (cm.find(och) != cm.end()) {
             return true;
@@ -1317,21 +1354,12 @@ void OmnibusSigProc::decon_2D_hits(int plane)
 {
     // apply software filter on time
 
-    Waveform::realseq_t roi_hf_filter_wf;
-    if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_wide_U");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-    }
-    else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_wide_V");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-    }
-    else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Wiener_wide_W");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-    }
+    const std::vector<std::string> filter_names{"HfFilter:Wiener_wide_U", "HfFilter:Wiener_wide_V",
+                                                "HfFilter:Wiener_wide_W"};
+    const auto& roi_hf_filter_wf = filter_spectrum({filter_names[plane]}, m_c_data[plane].cols());
 
-    Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
+    auto& c_data_afterfilter = m_work[plane].c_filtered;
+    c_data_afterfilter.resize(m_c_data[plane].rows(), m_c_data[plane].cols());
     for (int irow = 0; irow < m_c_data[plane].rows(); ++irow) {
         for (int icol = 0; icol < m_c_data[plane].cols(); ++icol) {
             c_data_afterfilter(irow, icol) = m_c_data[plane](irow, icol) * roi_hf_filter_wf.at(icol);
@@ -1339,7 +1367,8 @@ void OmnibusSigProc::decon_2D_hits(int plane)
     }
 
     // do the second round of inverse FFT on wire
-    Array::array_xxf tm_r_data = inv_c2r(m_dft, c_data_afterfilter, 1);
+    auto& tm_r_data = m_work[plane].r_padded;
+    inv_c2r(m_dft, c_data_afterfilter, tm_r_data, 1);
     m_r_data[plane] = tm_r_data.block(m_pad_nwires[plane], 0, m_nwires[plane], m_nticks);
     if (plane == 2) {
         restore_baseline(m_r_data[plane]);
@@ -1350,21 +1379,10 @@ void OmnibusSigProc::decon_2D_charge(int plane)
 {
     // apply software filter on time
 
-    Waveform::realseq_t roi_hf_filter_wf;
-    if (plane == 0) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Gaus_wide");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-    }
-    else if (plane == 1) {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Gaus_wide");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-    }
-    else {
-        auto ncr1 = Factory::find<IFilterWaveform>("HfFilter", "Gaus_wide");
-        roi_hf_filter_wf = ncr1->filter_waveform(m_c_data[plane].cols());
-    }
+    const auto& roi_hf_filter_wf = filter_spectrum({"HfFilter:Gaus_wide"}, m_c_data[plane].cols());
 
-    Array::array_xxc c_data_afterfilter(m_c_data[plane].rows(), m_c_data[plane].cols());
+    auto& c_data_afterfilter = m_work[plane].c_filtered;
+    c_data_afterfilter.resize(m_c_data[plane].rows(), m_c_data[plane].cols());
     for (int irow = 0; irow < m_c_data[plane].rows(); ++irow) {
         for (int icol = 0; icol < m_c_data[plane].cols(); ++icol) {
             c_data_afterfilter(irow, icol) = m_c_data[plane](irow, icol) * roi_hf_filter_wf.at(icol);
@@ -1372,7 +1390,8 @@ void OmnibusSigProc::decon_2D_charge(int plane)
     }
 
     // do the second round of inverse FFT on wire
-    Array::array_xxf tm_r_data = inv_c2r(m_dft, c_data_afterfilter, 1);
+    auto& tm_r_data = m_work[plane].r_padded;
+    inv_c2r(m_dft, c_data_afterfilter, tm_r_data, 1);
     m_r_data[plane] = tm_r_data.block(m_pad_nwires[plane], 0, m_nwires[plane], m_nticks);
     if (plane == 2) {
         restore_baseline(m_r_data[plane]);
@@ -1416,6 +1435,9 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
         }
     }
 
+    // The per-plane stages below only read the masks and expect "bad".
+    m_wanmm["bad"];
+
     ITrace::vector* itraces = new ITrace::vector;  // will become shared_ptr.
     IFrame::trace_summary_t thresholds;
     IFrame::trace_list_t wiener_traces, gauss_traces;
@@ -1425,6 +1447,21 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
     IFrame::trace_list_t mp2_roi_traces, mp3_roi_traces;
     IFrame::trace_list_t decon_charge_traces;
 
+    // Traces saved by the per-plane stages go to per-plane buffers
+    // which are merged in plane order so output does not depend on
+    // how the planes are scheduled.
+    std::vector<PlaneTraces> saved(3);
+    auto merge_saved = [&]() {
+        for (size_t iplane = 0; iplane != saved.size(); ++iplane) {
+            const size_t first = itraces->size();
+            saved[iplane].merge(*itraces, thresholds);
+            if (itraces->size() > first) {
+                log->debug("call={} merge plane index: {}, frame trace indices [{},{}]",
+                           m_count, iplane, first, itraces->size() - 1);
+            }
+        }
+    };
+
     // initialize the overall response function ...
     init_overall_response(in);
 
@@ -1440,26 +1477,31 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
     const std::vector<float>* perplane_thresholds[3] = {&roi_form.get_uplane_rms(), &roi_form.get_vplane_rms(),
                                                         &roi_form.get_wplane_rms()};
 
-    for (int iplane = 0; iplane != 3; ++iplane) {
-        auto it = std::find(m_process_planes.begin(), m_process_planes.end(), iplane);
-        if (it == m_process_planes.end()) continue;
+    // Decon and ROI formation only touch their own plane.
+    for_each_plane([&](int iplane) {
         const std::vector<float>& perwire_rmses = *perplane_thresholds[iplane];
+        auto& plane_saved = saved[iplane];
 
         // load data into EIGEN matrices ...
         load_data(in, iplane);  // load into a large matrix
         // initial decon ...
         decon_2D_init(iplane);  // decon in large matrix
-        check_data(iplane, "after 2D init");
+        check_data(m_work[iplane].r_padded, iplane, "after 2D init");
 
         // Form tight ROIs
         if (iplane != 2) {  // induction wire planes
             if (m_use_roi_refinement) {
                 decon_2D_tighterROI(iplane);
-                Array::array_xxf r_data_tight = m_r_data[iplane];
-                //      r_data_tight = m_r_data[plane];
+                auto& r_data_tight = m_work[iplane].r_tight;
+                r_data_tight = m_r_data[iplane];
                 decon_2D_tightROI(iplane);
                 roi_form.find_ROI_by_decon_itself(iplane, m_r_data[iplane], r_data_tight);
             }
+            else {
+                // decon_2D_init() leaves its result in the workspace
+                // but the saves below read m_r_data.
+                m_r_data[iplane] = m_work[iplane].r_padded;
+            }
         }
         else {  // collection wire planes
             decon_2D_tightROI(iplane);
@@ -1471,7 +1513,7 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
         std::vector<double> dummy;
         // [wgu] save decon result after tight LF
         if (m_use_roi_debug_mode and !m_tight_lf_tag.empty()) {
-            save_data(*itraces, tight_lf_traces, iplane, perwire_rmses, dummy, "tight_lf");
+            save_data(plane_saved.traces, plane_saved[tight_lf_traces], iplane, perwire_rmses, dummy, "tight_lf");
         }
 
         // Form loose ROIs
@@ -1480,7 +1522,7 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
             if (m_use_roi_debug_mode) {
                 decon_2D_looseROI_debug_mode(iplane);
                 if (!m_loose_lf_tag.empty()) {
-                    save_data(*itraces, loose_lf_traces, iplane, perwire_rmses, dummy, "loose_lf");
+                    save_data(plane_saved.traces, plane_saved[loose_lf_traces], iplane, perwire_rmses, dummy, "loose_lf");
                 }
             }
 
@@ -1495,27 +1537,28 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
         // but save something to be consistent
         if (m_use_roi_debug_mode and iplane == 2) {
             if (!m_loose_lf_tag.empty()) {
-                save_data(*itraces, loose_lf_traces, iplane, perwire_rmses, dummy, "loose_lf");
+                save_data(plane_saved.traces, plane_saved[loose_lf_traces], iplane, perwire_rmses, dummy, "loose_lf");
             }
         }
 
         check_data(iplane, "after 2D ROI refine");
 
-        // Refine ROIs
-        if (m_use_roi_refinement) roi_refine.load_data(iplane, m_r_data[iplane], roi_form);
-        else {
-            /// TODO: streamline the logics
-            // special case to dump decon without needs of ROIs
-            if (m_use_roi_debug_mode and !m_decon_charge_tag.empty()) {
-                decon_2D_charge(iplane);
-                save_data(*itraces, decon_charge_traces, iplane, perwire_rmses, dummy, "decon");
-            }
-            m_c_data[iplane].resize(0, 0);  // clear memory
-            m_r_data[iplane].resize(0, 0);  // clear memory
+        /// TODO: streamline the logics
+        // special case to dump decon without needs of ROIs
+        if (!m_use_roi_refinement and m_use_roi_debug_mode and !m_decon_charge_tag.empty()) {
+            decon_2D_charge(iplane);
+            save_data(plane_saved.traces, plane_saved[decon_charge_traces], iplane, perwire_rmses, dummy, "decon");
         }
-    }
+
+        if (m_use_roi_refinement) {
+            roi_refine.load_data(iplane, m_r_data[iplane], roi_form);
+        }
+    });
+    merge_saved();
 
     if (m_use_roi_refinement) {
+        // Multi-plane protection reads the ROIs of all planes and so
+        // is done serially.
         for (int iplane = 0; iplane != 3; ++iplane) {
             auto it = std::find(m_process_planes.begin(), m_process_planes.end(), iplane);
             if (it == m_process_planes.end()) continue;
@@ -1542,11 +1585,9 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
             }
         }
 
-        for (int iplane = 0; iplane != 3; ++iplane) {
-            auto it = std::find(m_process_planes.begin(), m_process_planes.end(), iplane);
-            if (it == m_process_planes.end()) continue;
-
-            const std::vector<float>& perwire_rmses = *perplane_thresholds[iplane];
+        // The remaining refinement only touches the ROIs of one plane.
+        for_each_plane([&](int iplane) {
+            auto& plane_saved = saved[iplane];
 
             for (int qx = 0; qx != m_r_break_roi_loop; qx++) {
                 roi_refine.BreakROIs(iplane, roi_form);
@@ -1554,10 +1595,10 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
                 roi_refine.CleanUpROIs(iplane);
                 if (m_use_roi_debug_mode) {
                     if (qx == 0 and !m_break_roi_loop1_tag.empty()) {
-                        save_roi(*itraces, break_roi_loop1_traces, iplane, roi_refine.get_rois_by_plane(iplane));
+                        save_roi(plane_saved.traces, plane_saved[break_roi_loop1_traces], iplane, roi_refine.get_rois_by_plane(iplane));
                     }
                     if (qx == 1 and !m_break_roi_loop2_tag.empty()) {
-                        save_roi(*itraces, break_roi_loop2_traces, iplane, roi_refine.get_rois_by_plane(iplane));
+                        save_roi(plane_saved.traces, plane_saved[break_roi_loop2_traces], iplane, roi_refine.get_rois_by_plane(iplane));
                     }
                 }
             }
@@ -1568,7 +1609,7 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
             check_data(iplane, "after roi refine check");
             roi_refine.CleanUpROIs(iplane);
             if (m_use_roi_debug_mode and !m_shrink_roi_tag.empty()) {
-                save_roi(*itraces, shrink_roi_traces, iplane, roi_refine.get_rois_by_plane(iplane));
+                save_roi(plane_saved.traces, plane_saved[shrink_roi_traces], iplane, roi_refine.get_rois_by_plane(iplane));
             }
 
             if (iplane == 2) {
@@ -1583,8 +1624,16 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
             check_data(iplane, "after roi refine extend");
 
             if (m_use_roi_debug_mode and !m_extend_roi_tag.empty()) {
-                save_ext_roi(*itraces, extend_roi_traces, iplane, roi_refine.get_rois_by_plane(iplane));
+                save_ext_roi(plane_saved.traces, plane_saved[extend_roi_traces], iplane, roi_refine.get_rois_by_plane(iplane));
             }
+        });
+
+        // The final decon and applying the refined ROIs only touch
+        // their own plane.  Saved traces are merged once after this
+        // so each plane's refinement and decon traces stay together.
+        for_each_plane([&](int iplane) {
+            const std::vector<float>& perwire_rmses = *perplane_thresholds[iplane];
+            auto& plane_saved = saved[iplane];
 
             // merge results ...
             decon_2D_hits(iplane);
@@ -1593,31 +1642,25 @@ bool OmnibusSigProc::operator()(const input_pointer& in, output_pointer& out)
             check_data(iplane, "after roi refine apply");
             // roi_form.apply_roi(iplane, m_r_data[plane],1);
             if (!m_wiener_tag.empty()) {
-                // We only use an intermediate index list here to give
-                // some clarity to log msg about range added
-                IFrame::trace_list_t perframe;
-                save_data(*itraces, perframe, iplane, perwire_rmses, thresholds, "wiener");
-                wiener_traces.insert(wiener_traces.end(), perframe.begin(), perframe.end());
+                save_data(plane_saved.traces, plane_saved[wiener_traces], iplane, perwire_rmses,
+                          plane_saved.thresholds, "wiener");
             }
 
             decon_2D_charge(iplane);
             std::vector<double> dummy_thresholds;
             if (m_use_roi_debug_mode and !m_decon_charge_tag.empty()) {
-                save_data(*itraces, decon_charge_traces, iplane, perwire_rmses, dummy_thresholds, "decon");
+                save_data(plane_saved.traces, plane_saved[decon_charge_traces], iplane, perwire_rmses,
+                          dummy_thresholds, "decon");
             }
             roi_refine.apply_roi(iplane, m_r_data[iplane]);
             // roi_form.apply_roi(iplane, m_r_data[plane],1);
             if (!m_gauss_tag.empty()) {
-                // We only use an intermediate index list here to give
-                // some clarity to log msg about range added
-                IFrame::trace_list_t perframe;
-                save_data(*itraces, perframe, iplane, perwire_rmses, dummy_thresholds, "gauss");
-                gauss_traces.insert(gauss_traces.end(), perframe.begin(), perframe.end());
+                save_data(plane_saved.traces, plane_saved[gauss_traces], iplane, perwire_rmses,
+                          dummy_thresholds, "gauss");
             }
 
-            m_c_data[iplane].resize(0, 0);  // clear memory
-            m_r_data[iplane].resize(0, 0);  // clear memory
-        } // loop over planes
+        });
+        merge_saved();
     } // m_use_roi_refinement
 
     // clear the overall response
@@ -17,6 +17,7 @@
 
 #include "WireCellUtil/NamedFactory.h"
 
+#include <atomic>
 #include <cmath>
 #include <complex>
 #include <iostream>
@@ -772,14 +773,13 @@ WireCell::Waveform::ChannelMaskMap Protodune::OneChannelNoise::apply(int ch, sig
     bool is_partial = m_check_partial(spectrum);  // Xin's "IS_RC()"
 
     if (!is_partial) {
-        static bool warned = false;
+        static std::atomic<bool> warned{false};  // channels may be filtered concurrently
         auto const& spec = m_noisedb->rcrc(ch);  // rc_layers set to 1 in channel noise db
         if (spec.size() == spectrum.size()) {
             WireCell::Waveform::shrink(spectrum, spec);
         }
-        else if (!warned) {
+        else if (!warned.exchange(true)) {
             log->warn("got empty rcrc for channel {}.  suppressing future warnings", ch);
-            warned = true;
         }
     }
 
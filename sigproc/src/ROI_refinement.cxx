@@ -82,37 +82,26 @@ ROI_refinement::~ROI_refinement() { Clear(); }
 void ROI_refinement::Clear()
 {
     for (int i = 0; i != nwire_u; i++) {
-        for (auto it = rois_u_tight.at(i).begin(); it != rois_u_tight.at(i).end(); it++) {
-            delete *it;
-        }
         rois_u_tight.at(i).clear();
-        for (auto it = rois_u_loose.at(i).begin(); it != rois_u_loose.at(i).end(); it++) {
-            delete *it;
-        }
         rois_u_loose.at(i).clear();
     }
 
     for (int i = 0; i != nwire_v; i++) {
-        for (auto it = rois_v_tight.at(i).begin(); it != rois_v_tight.at(i).end(); it++) {
-            delete *it;
-        }
         rois_v_tight.at(i).clear();
-        for (auto it = rois_v_loose.at(i).begin(); it != rois_v_loose.at(i).end(); it++) {
-            delete *it;
-        }
         rois_v_loose.at(i).clear();
     }
 
     for (int i = 0; i != nwire_w; i++) {
-        for (auto it = rois_w_tight.at(i).begin(); it != rois_w_tight.at(i).end(); it++) {
-            delete *it;
-        }
         rois_w_tight.at(i).clear();
     }
 
-    front_rois.clear();
-    back_rois.clear();
-    contained_rois.clear();
+    for (auto& plane_rois : m_planes) {
+        plane_rois.front_rois.clear();
+        plane_rois.back_rois.clear();
+        plane_rois.contained_rois.clear();
+        // all ROIs are freed together
+        plane_rois.store.clear();
+    }
 }
 
 void ROI_refinement::apply_roi(int plane, Array::array_xxf &r_data)
@@ -229,6 +218,10 @@ SignalROIChList &ROI_refinement::get_rois_by_plane(int plane)
 
 void ROI_refinement::unlink(SignalROI *prev_roi, SignalROI *next_roi)
 {
+    auto& plane_rois = m_planes[prev_roi->get_plane()];
+    auto& front_rois = plane_rois.front_rois;
+    auto& back_rois = plane_rois.back_rois;
+
     if (front_rois.find(prev_roi) != front_rois.end()) {
         SignalROISelection &temp_rois = front_rois[prev_roi];
         auto it = find(temp_rois.begin(), temp_rois.end(), next_roi);
@@ -243,6 +236,10 @@ void ROI_refinement::unlink(SignalROI *prev_roi, SignalROI *next_roi)
 
 void ROI_refinement::link(SignalROI *prev_roi, SignalROI *next_roi)
 {
+    auto& plane_rois = m_planes[prev_roi->get_plane()];
+    auto& front_rois = plane_rois.front_rois;
+    auto& back_rois = plane_rois.back_rois;
+
     if (front_rois.find(prev_roi) != front_rois.end()) {
         SignalROISelection &temp_rois = front_rois[prev_roi];
         auto it = find(temp_rois.begin(), temp_rois.end(), next_roi);
@@ -268,6 +265,11 @@ void ROI_refinement::link(SignalROI *prev_roi, SignalROI *next_roi)
 
 void ROI_refinement::load_data(int plane, const Array::array_xxf &r_data, ROI_formation &roi_form)
 {
+    auto& plane_rois = m_planes[plane];
+    auto& front_rois = plane_rois.front_rois;
+    auto& back_rois = plane_rois.back_rois;
+    auto& contained_rois = plane_rois.contained_rois;
+
     // fill RMS
     std::vector<float> plane_rms;
     int offset = 0;
@@ -290,9 +292,9 @@ void ROI_refinement::load_data(int plane, const Array::array_xxf &r_data, ROI_fo
         if (bad_ch_map.find(irow + offset) != bad_ch_map.end()) {
             for (int icol = 0; icol != r_data.cols(); icol++) {
                 bool flag = true;
-                for (size_t i = 0; i != bad_ch_map[irow + offset].size(); i++) {
-                    if (icol >= bad_ch_map[irow + offset].at(i).first &&
-                        icol <= bad_ch_map[irow + offset].at(i).second) {
+                for (size_t i = 0; i != bad_ch_map.at(irow + offset).size(); i++) {
+                    if (icol >= bad_ch_map.at(irow + offset).at(i).first &&
+                        icol <= bad_ch_map.at(irow + offset).at(i).second) {
                         flag = false;
                         break;
                     }
@@ -316,10 +318,10 @@ void ROI_refinement::load_data(int plane, const Array::array_xxf &r_data, ROI_fo
         std::vector<std::pair<int, int>> &uboone_rois = roi_form.get_self_rois(irow + offset);
         for (size_t i = 0; i != uboone_rois.size(); i++) {
             SignalROI *tight_roi =
-                new SignalROI(plane, irow + offset, uboone_rois.at(i).first, uboone_rois.at(i).second, signal);
+                plane_rois.store.make(plane, irow + offset, uboone_rois.at(i).first, uboone_rois.at(i).second, signal);
             float threshold = plane_rms.at(irow) * th_factor;
             if (tight_roi->get_above_threshold(threshold).size() == 0) {
-                delete tight_roi;
+                plane_rois.store.release(tight_roi);
                 continue;
             }
 
@@ -490,10 +492,10 @@ void ROI_refinement::load_data(int plane, const Array::array_xxf &r_data, ROI_fo
             uboone_rois = roi_form.get_loose_rois(chid);
             for (size_t i = 0; i != uboone_rois.size(); i++) {
                 SignalROI *loose_roi =
-                    new SignalROI(plane, chid, uboone_rois.at(i).first, uboone_rois.at(i).second, signal);
+                    plane_rois.store.make(plane, chid, uboone_rois.at(i).first, uboone_rois.at(i).second, signal);
                 float threshold = plane_rms.at(irow) * th_factor;
                 if (loose_roi->get_above_threshold(threshold).size() == 0) {
-                    delete loose_roi;
+                    plane_rois.store.release(loose_roi);
                     continue;
                 }
                 if (plane == 0) {
@@ -700,6 +702,11 @@ void ROI_refinement::load_data(int plane, const Array::array_xxf &r_data, ROI_fo
 
 void ROI_refinement::CleanUpROIs(int plane)
 {
+    auto& plane_rois = m_planes[plane];
+    auto& front_rois = plane_rois.front_rois;
+    auto& back_rois = plane_rois.back_rois;
+    auto& contained_rois = plane_rois.contained_rois;
+
     // clean up ROIs
     std::map<SignalROI *, int> ROIsaved_map;
 
@@ -779,7 +786,7 @@ void ROI_refinement::CleanUpROIs(int plane)
             for (auto it = to_be_removed.begin(); it != to_be_removed.end(); it++) {
                 auto it1 = find(rois_u_loose.at(i).begin(), rois_u_loose.at(i).end(), *it);
                 rois_u_loose.at(i).erase(it1);
-                delete (*it);
+                plane_rois.store.release(*it);
             }
         }
     }
@@ -859,7 +866,7 @@ void ROI_refinement::CleanUpROIs(int plane)
             for (auto it = to_be_removed.begin(); it != to_be_removed.end(); it++) {
                 auto it1 = find(rois_v_loose.at(i).begin(), rois_v_loose.at(i).end(), *it);
                 rois_v_loose.at(i).erase(it1);
-                delete (*it);
+                plane_rois.store.release(*it);
             }
         }
     }
@@ -874,6 +881,11 @@ void ROI_refinement::CleanUpROIs(int plane)
 
 void ROI_refinement::generate_merge_ROIs(int plane)
 {
+    auto& plane_rois = m_planes[plane];
+    auto& front_rois = plane_rois.front_rois;
+    auto& back_rois = plane_rois.back_rois;
+    auto& contained_rois = plane_rois.contained_rois;
+
     // find tight ROIs not contained by the loose ROIs
     if (plane == 0) {
         for (int i = 0; i != nwire_u; i++) {
@@ -902,7 +914,7 @@ void ROI_refinement::generate_merge_ROIs(int plane)
             for (auto it = saved_rois.begin(); it != saved_rois.end(); it++) {
                 SignalROI *roi = *it;
                 // Duplicate them
-                SignalROI *loose_roi = new SignalROI(roi);
+                SignalROI *loose_roi = plane_rois.store.make(roi);
 
                 rois_u_loose.at(i).push_back(loose_roi);
 
@@ -1043,7 +1055,7 @@ void ROI_refinement::generate_merge_ROIs(int plane)
             for (auto it = saved_rois.begin(); it != saved_rois.end(); it++) {
                 SignalROI *roi = *it;
                 // Duplicate them
-                SignalROI *loose_roi = new SignalROI(roi);
+                SignalROI *loose_roi = plane_rois.store.make(roi);
 
                 rois_v_loose.at(i).push_back(loose_roi);
 
@@ -1160,6 +1172,9 @@ void ROI_refinement::generate_merge_ROIs(int plane)
 
 void ROI_refinement::CheckROIs(int plane, ROI_formation &roi_form)
 {
+    auto& front_rois = m_planes[plane].front_rois;
+    auto& back_rois = m_planes[plane].back_rois;
+
     if (plane == 0) {
         std::vector<float> &rms_u = roi_form.get_uplane_rms();
 
@@ -1285,6 +1300,10 @@ void ROI_refinement::CheckROIs(int plane, ROI_formation &roi_form)
 
 void ROI_refinement::CleanUpCollectionROIs()
 {
+    auto& plane_rois = m_planes[2];
+    auto& front_rois = plane_rois.front_rois;
+    auto& back_rois = plane_rois.back_rois;
+
     // deal with tight ROIs,
     // scan with all the tight ROIs to look for peaks above certain threshold, put in a temporary set
     float mean_threshold = fake_signal_low_th;
@@ -1361,12 +1380,16 @@ void ROI_refinement::CleanUpCollectionROIs()
         auto it1 = find(rois_w_tight.at(chid).begin(), rois_w_tight.at(chid).end(), roi);
         if (it1 != rois_w_tight.at(chid).end()) rois_w_tight.at(chid).erase(it1);
 
-        delete roi;
+        plane_rois.store.release(roi);
     }
 }
 
 void ROI_refinement::CleanUpInductionROIs(int plane)
 {
+    auto& plane_rois = m_planes[plane];
+    auto& front_rois = plane_rois.front_rois;
+    auto& back_rois = plane_rois.back_rois;
+
     // deal with loose ROIs
     // focus on the isolated ones first
     float mean_threshold = fake_signal_low_th;
@@ -1525,7 +1548,7 @@ void ROI_refinement::CleanUpInductionROIs(int plane)
             auto it1 = find(rois_u_loose.at(chid).begin(), rois_u_loose.at(chid).end(), roi);
             if (it1 != rois_u_loose.at(chid).end()) rois_u_loose.at(chid).erase(it1);
 
-            delete roi;
+            plane_rois.store.release(roi);
         }
     }
     else if (plane == 1) {
@@ -1595,13 +1618,18 @@ void ROI_refinement::CleanUpInductionROIs(int plane)
             auto it1 = find(rois_v_loose.at(chid).begin(), rois_v_loose.at(chid).end(), roi);
             if (it1 != rois_v_loose.at(chid).end()) rois_v_loose.at(chid).erase(it1);
 
-            delete roi;
+            plane_rois.store.release(roi);
         }
     }
 }
 
 void ROI_refinement::ShrinkROI(SignalROI *roi, ROI_formation &roi_form)
 {
+    auto& plane_rois = m_planes[roi->get_plane()];
+    auto& front_rois = plane_rois.front_rois;
+    auto& back_rois = plane_rois.back_rois;
+    auto& contained_rois = plane_rois.contained_rois;
+
     // if(proteced_rois.find({roi->get_chid(),roi->get_start_bin()})!=proteced_rois.end()) {
     //   return;
     // }
@@ -1764,7 +1792,7 @@ void ROI_refinement::ShrinkROI(SignalROI *roi, ROI_formation &roi_form)
 
     SignalROISelection new_rois;
     if (new_start_bin >= 0 && new_end_bin > new_start_bin) {
-        SignalROI *new_roi = new SignalROI(plane, chid, new_start_bin, new_end_bin, signal);
+        SignalROI *new_roi = plane_rois.store.make(plane, chid, new_start_bin, new_end_bin, signal);
         new_rois.push_back(new_roi);
     }
 
@@ -1834,8 +1862,8 @@ void ROI_refinement::ShrinkROI(SignalROI *roi, ROI_formation &roi_form)
         contained_rois.erase(roi);
     }
 
-    // delete the old ROI
-    delete roi;
+    // release the old ROI
+    plane_rois.store.release(roi);
 
     // delete htemp;
     // delete h1;
@@ -1866,6 +1894,9 @@ void ROI_refinement::ShrinkROIs(int plane, ROI_formation &roi_form)
 
 void ROI_refinement::BreakROI(SignalROI *roi, float rms)
 {
+    auto& plane_rois = m_planes[roi->get_plane()];
+    auto& contained_rois = plane_rois.contained_rois;
+
     auto protected_zones = proteced_rois.equal_range({roi->get_chid(), roi->get_start_bin()});
     // if (protected_zones.first!=protected_zones.second) {
     //   return;
@@ -2329,6 +2360,11 @@ void ROI_refinement::BreakROI(SignalROI *roi, float rms)
 
 void ROI_refinement::BreakROI1(SignalROI *roi)
 {
+    auto& plane_rois = m_planes[roi->get_plane()];
+    auto& front_rois = plane_rois.front_rois;
+    auto& back_rois = plane_rois.back_rois;
+    auto& contained_rois = plane_rois.contained_rois;
+
     int start_bin = roi->get_start_bin();
     int end_bin = roi->get_end_bin();
     if (start_bin < 0 || end_bin < 0) return;
@@ -2370,7 +2406,7 @@ void ROI_refinement::BreakROI1(SignalROI *roi)
             //      h1->SetBinContent(j+1,htemp->GetBinContent(j-start_bin+1));
         }
         if (start_bin1 >= 0 && end_bin1 > start_bin1) {
-            SignalROI *sub_roi = new SignalROI(plane, chid, start_bin1, end_bin1, signal);
+            SignalROI *sub_roi = plane_rois.store.make(plane, chid, start_bin1, end_bin1, signal);
             new_rois.push_back(sub_roi);
         }
     }
@@ -2439,8 +2475,8 @@ void ROI_refinement::BreakROI1(SignalROI *roi)
         contained_rois.erase(roi);
     }
 
-    // delete the old ROI
-    delete roi;
+    // release the old ROI
+    plane_rois.store.release(roi);
     //  delete h1;
     //  delete htemp;
 }
@@ -2883,7 +2919,7 @@ void ROI_refinement::TestROIs()
         for (auto it = rois_u_loose.at(chid).begin(); it != rois_u_loose.at(chid).end(); it++) {
             SignalROI *roi = *it;
             // loop through front
-            for (auto it1 = front_rois[roi].begin(); it1 != front_rois[roi].end(); it1++) {
+            for (auto it1 = m_planes[0].front_rois[roi].begin(); it1 != m_planes[0].front_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
                 if (find(rois_u_loose.at(chid + 1).begin(), rois_u_loose.at(chid + 1).end(), roi1) ==
                     rois_u_loose.at(chid + 1).end())
@@ -2891,7 +2927,7 @@ void ROI_refinement::TestROIs()
             }
 
             // loop through back
-            for (auto it1 = back_rois[roi].begin(); it1 != back_rois[roi].end(); it1++) {
+            for (auto it1 = m_planes[0].back_rois[roi].begin(); it1 != m_planes[0].back_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
                 if (find(rois_u_loose.at(chid - 1).begin(), rois_u_loose.at(chid - 1).end(), roi1) ==
                     rois_u_loose.at(chid - 1).end())
@@ -2904,7 +2940,7 @@ void ROI_refinement::TestROIs()
         for (auto it = rois_v_loose.at(chid).begin(); it != rois_v_loose.at(chid).end(); it++) {
             SignalROI *roi = *it;
             // loop through front
-            for (auto it1 = front_rois[roi].begin(); it1 != front_rois[roi].end(); it1++) {
+            for (auto it1 = m_planes[1].front_rois[roi].begin(); it1 != m_planes[1].front_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
                 if (find(rois_v_loose.at(chid + 1).begin(), rois_v_loose.at(chid + 1).end(), roi1) ==
                     rois_v_loose.at(chid + 1).end())
@@ -2912,7 +2948,7 @@ void ROI_refinement::TestROIs()
             }
 
             // loop through back
-            for (auto it1 = back_rois[roi].begin(); it1 != back_rois[roi].end(); it1++) {
+            for (auto it1 = m_planes[1].back_rois[roi].begin(); it1 != m_planes[1].back_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
                 if (find(rois_v_loose.at(chid - 1).begin(), rois_v_loose.at(chid - 1).end(), roi1) ==
                     rois_v_loose.at(chid - 1).end())
@@ -2925,7 +2961,7 @@ void ROI_refinement::TestROIs()
         for (auto it = rois_w_tight.at(chid).begin(); it != rois_w_tight.at(chid).end(); it++) {
             SignalROI *roi = *it;
             // loop through front
-            for (auto it1 = front_rois[roi].begin(); it1 != front_rois[roi].end(); it1++) {
+            for (auto it1 = m_planes[2].front_rois[roi].begin(); it1 != m_planes[2].front_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
                 if (find(rois_w_tight.at(chid + 1).begin(), rois_w_tight.at(chid + 1).end(), roi1) ==
                     rois_w_tight.at(chid + 1).end())
@@ -2933,7 +2969,7 @@ void ROI_refinement::TestROIs()
             }
 
             // loop through back
-            for (auto it1 = back_rois[roi].begin(); it1 != back_rois[roi].end(); it1++) {
+            for (auto it1 = m_planes[2].back_rois[roi].begin(); it1 != m_planes[2].back_rois[roi].end(); it1++) {
                 SignalROI *roi1 = *it1;
                 if (find(rois_w_tight.at(chid - 1).begin(), rois_w_tight.at(chid - 1).end(), roi1) ==
                     rois_w_tight.at(chid - 1).end())
@@ -2945,6 +2981,9 @@ void ROI_refinement::TestROIs()
 
 void ROI_refinement::ExtendROIs(int plane)
 {
+    auto& front_rois = m_planes[plane].front_rois;
+    auto& back_rois = m_planes[plane].back_rois;
+
     bool flag = true;
     if (plane == 0) {
         // U plane ...
@@ -106,9 +106,18 @@ namespace WireCell {
             MapMPROI proteced_rois;  // using chid and start_bin as id
             MapMPROI mp_rois;        // using chid and start_bin as id
 
-            SignalROIMap front_rois;
-            SignalROIMap back_rois;
-            SignalROIMap contained_rois;
+            // ROI links and storage are kept per plane so that the
+            // per-plane methods may be called concurrently for
+            // different planes.
+            struct PlaneROIs {
+                SignalROIMap front_rois;
+                SignalROIMap back_rois;
+                SignalROIMap contained_rois;
+
+                // Owns all SignalROIs of the plane.
+                SignalROIStore store;
+            };
+            PlaneROIs m_planes[3];
 
             Log::logptr_t log;
 
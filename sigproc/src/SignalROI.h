@@ -7,6 +7,8 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <unordered_map>
+#include <utility>
 
 namespace WireCell {
     namespace SigProc {
@@ -50,7 +52,47 @@ namespace WireCell {
         typedef std::vector<SignalROI*> SignalROISelection;
         typedef std::vector<SignalROISelection> SignalROIChSelection;
         typedef std::vector<SignalROIList> SignalROIChList;
-        typedef std::map<SignalROI*, SignalROISelection> SignalROIMap;
+        typedef std::unordered_map<SignalROI*, SignalROISelection> SignalROIMap;
+
+        // Storage for the SignalROIs of one event.  ROIs are made in
+        // contiguous chunks and all are freed together by clear() or
+        // when the store is destroyed.  Pointers stay valid until then.
+        class SignalROIStore {
+           public:
+            explicit SignalROIStore(size_t chunk_size = 1024)
+              : m_chunk_size(chunk_size)
+            {
+            }
+
+            // Construct a new ROI in place.
+            template <typename... Args>
+            SignalROI* make(Args&&... args)
+            {
+                if (m_chunks.empty() or m_chunks.back().size() == m_chunk_size) {
+                    m_chunks.emplace_back();
+                    m_chunks.back().reserve(m_chunk_size);
+                }
+                auto& chunk = m_chunks.back();
+                chunk.emplace_back(std::forward<Args>(args)...);
+                return &chunk.back();
+            }
+
+            // Give back an ROI which is no longer referenced.  Its
+            // storage is reused only if it is the most recently made
+            // ROI, otherwise it is kept until clear().
+            void release(SignalROI* roi)
+            {
+                if (!m_chunks.empty() and !m_chunks.back().empty() and &m_chunks.back().back() == roi) {
+                    m_chunks.back().pop_back();
+                }
+            }
+
+            void clear() { m_chunks.clear(); }
+
+           private:
+            size_t m_chunk_size;
+            std::vector<std::vector<SignalROI>> m_chunks;
+        };
 
         struct CompareRois {
             bool operator()(SignalROI* roi1, SignalROI* roi2) const
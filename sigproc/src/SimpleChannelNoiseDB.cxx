@@ -247,7 +247,7 @@ void SimpleChannelNoiseDB::set_nominal_baseline(const std::vector<int>& channels
 {
     // std::cerr << "SimpleChannelNoiseDB: set baseline to " << channels.size() << " chans: " << baseline << std::endl;
     for (auto ch : channels) {
-        set_one(chind(ch), baseline, m_baseline, m_default_baseline);
+        set_one(add_chind(ch), baseline, m_baseline, m_default_baseline);
     }
 }
 void SimpleChannelNoiseDB::set_rcrc_constant(const std::vector<int>& channels, double rcrc)
@@ -279,7 +279,7 @@ void SimpleChannelNoiseDB::set_rcrc_constant(const std::vector<int>& channels, d
     auto filt = std::make_shared<filter_t>(spectrum2);
 
     for (auto ch : channels) {
-        set_one(chind(ch), filt, m_rcrc, m_default_filter);
+        set_one(add_chind(ch), filt, m_rcrc, m_default_filter);
     }
 }
 
@@ -290,7 +290,7 @@ void SimpleChannelNoiseDB::set_response(const std::vector<int>& channels, const
 
     auto filt = std::make_shared<filter_t>(spectrum);
     for (auto ch : channels) {
-        set_one(chind(ch), filt, m_response, m_default_response);
+        set_one(add_chind(ch), filt, m_response, m_default_response);
     }
 }
 
@@ -332,7 +332,7 @@ void SimpleChannelNoiseDB::set_gains_shapings(const std::vector<int>& channels,
     //           << std::endl;
 
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, filt, m_config, m_default_filter);
         set_one(ind, gain_ratio, m_gain, m_default_gain);
     }
@@ -343,7 +343,7 @@ void SimpleChannelNoiseDB::set_response_offset(const std::vector<int>& channels,
     // std::cerr << "SimpleChannelNoiseDB: set response offset " << channels.size() << " chans to: " << offset <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, offset, m_offset, m_default_offset);
     }
 }
@@ -353,7 +353,7 @@ void SimpleChannelNoiseDB::set_min_rms_cut(const std::vector<int>& channels, dou
     // std::cerr << "SimpleChannelNoiseDB: set min rms cut on "<<channels.size()<<":[" << channels.front() << "," <<
     // channels.back() << "] to: " << min_rms << std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, min_rms, m_min_rms, m_default_min_rms);
     }
 }
@@ -361,7 +361,7 @@ void SimpleChannelNoiseDB::set_min_rms_cut(const std::vector<int>& channels, dou
 void SimpleChannelNoiseDB::set_min_rms_cut_one(int ch, double min_rms)
 {
     // std::cerr << "SimpleChannelNoiseDB: set min rms cut on " << ch << " to: " << min_rms << std::endl;
-    int ind = chind(ch);
+    int ind = add_chind(ch);
     set_one(ind, min_rms, m_min_rms, m_default_min_rms);
 }
 
@@ -370,7 +370,7 @@ void SimpleChannelNoiseDB::set_max_rms_cut(const std::vector<int>& channels, dou
     // std::cerr << "SimpleChannelNoiseDB: set max rms cut on "<<channels.size()<<":[" << channels.front() << "," <<
     // channels.back() << "] to: " << max_rms << std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, max_rms, m_max_rms, m_default_max_rms);
     }
 }
@@ -378,7 +378,7 @@ void SimpleChannelNoiseDB::set_max_rms_cut(const std::vector<int>& channels, dou
 void SimpleChannelNoiseDB::set_max_rms_cut_one(int ch, double max_rms)
 {
     // std::cerr << "SimpleChannelNoiseDB: set max rms cut on " << ch << " to: " << max_rms << std::endl;
-    int ind = chind(ch);
+    int ind = add_chind(ch);
     set_one(ind, max_rms, m_max_rms, m_default_max_rms);
 }
 
@@ -387,7 +387,7 @@ void SimpleChannelNoiseDB::set_pad_window_front(const std::vector<int>& channels
     // std::cerr << "SimpleChannelNoiseDB: set pad window front on " << channels.size() << " channels: " << pad_f <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, pad_f, m_pad_f, m_default_pad_f);
     }
 }
@@ -397,7 +397,7 @@ void SimpleChannelNoiseDB::set_pad_window_back(const std::vector<int>& channels,
     // std::cerr << "SimpleChannelNoiseDB: set pad window back on " << channels.size() << " channels: " << pad_b <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, pad_b, m_pad_b, m_default_pad_b);
     }
 }
@@ -407,7 +407,7 @@ void SimpleChannelNoiseDB::set_coherent_nf_decon_limit(const std::vector<int>& c
     // std::cerr << "SimpleChannelNoiseDB: set pad window back on " << channels.size() << " channels: " << pad_b <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, decon_limit, m_decon_limit, m_default_decon_limit);
     }
 }
@@ -417,7 +417,7 @@ void SimpleChannelNoiseDB::set_coherent_nf_decon_lf_cutoff(const std::vector<int
     // std::cerr << "SimpleChannelNoiseDB: set pad window back on " << channels.size() << " channels: " << pad_b <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, decon_lf_cutoff, m_decon_lf_cutoff, m_default_decon_lf_cutoff);
     }
 }
@@ -427,7 +427,7 @@ void SimpleChannelNoiseDB::set_coherent_nf_decon_limit1(const std::vector<int>&
     // std::cerr << "SimpleChannelNoiseDB: set pad window back on " << channels.size() << " channels: " << pad_b <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, decon_limit1, m_decon_limit1, m_default_decon_limit1);
     }
 }
@@ -437,7 +437,7 @@ void SimpleChannelNoiseDB::set_coherent_nf_adc_limit(const std::vector<int>& cha
     // std::cerr << "SimpleChannelNoiseDB: set pad window back on " << channels.size() << " channels: " << pad_b <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, adc_limit, m_adc_limit, m_default_adc_limit);
     }
 }
@@ -447,7 +447,7 @@ void SimpleChannelNoiseDB::set_coherent_nf_protection_factor(const std::vector<i
     // std::cerr << "SimpleChannelNoiseDB: set pad window back on " << channels.size() << " channels: " << pad_b <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, protection_factor, m_protection_factor, m_default_protection_factor);
     }
 }
@@ -457,7 +457,7 @@ void SimpleChannelNoiseDB::set_coherent_nf_min_adc_limit(const std::vector<int>&
     // std::cerr << "SimpleChannelNoiseDB: set pad window back on " << channels.size() << " channels: " << pad_b <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, min_adc_limit, m_min_adc_limit, m_default_min_adc_limit);
     }
 }
@@ -467,7 +467,7 @@ void SimpleChannelNoiseDB::set_coherent_nf_roi_min_max_ratio(const std::vector<i
     // std::cerr << "SimpleChannelNoiseDB: set pad window back on " << channels.size() << " channels: " << pad_b <<
     // std::endl;
     for (auto ch : channels) {
-        int ind = chind(ch);
+        int ind = add_chind(ch);
         set_one(ind, roi_min_max_ratio, m_roi_min_max_ratio, m_default_roi_min_max_ratio);
     }
 }
@@ -488,7 +488,7 @@ void SimpleChannelNoiseDB::set_filter(const std::vector<int>& channels, const mu
     auto filt = std::make_shared<filter_t>(spectrum);
 
     for (auto ch : channels) {
-        set_one(chind(ch), filt, m_masks, m_default_filter);
+        set_one(add_chind(ch), filt, m_masks, m_default_filter);
     }
 }
 
@@ -506,6 +506,15 @@ void SimpleChannelNoiseDB::set_bad_channels(const channel_group_t& bc)
 }
 
 int SimpleChannelNoiseDB::chind(int ch) const
+{
+    auto it = m_ch2ind.find(ch);
+    if (it == m_ch2ind.end()) {
+        return -1;
+    }
+    return it->second;
+}
+
+int SimpleChannelNoiseDB::add_chind(int ch)
 {
     auto it = m_ch2ind.find(ch);
     if (it == m_ch2ind.end()) {
@@ -0,0 +1,41 @@
+#!/usr/bin/env bats
+
+# Check that OmnibusSigProc gives the same output frame when it
+# processes its wire planes concurrently and one after another.
+
+# bats file_tags=sigproc,PDSP
+
+bats_load_library wct-bats.sh
+
+@test "parallel planes match serial planes" {
+    skip_if_missing jq
+
+    cd_tmp
+
+    local cfgfile="$(relative_path check_pdsp_sim_sp.jsonnet)"
+    local depofile=( $(input_file depos/cosmic-500-1.npz) )
+    yell "depofile: ${depofile}"
+
+    for planes in parallel serial
+    do
+        compile_jsonnet "$cfgfile" "${planes}-orig.json" \
+                        -V input="$depofile" \
+                        -V output="${planes}.tar.bz2"
+    done
+    jq 'map(if .type == "OmnibusSigProc" then .data.parallel_planes = true else . end)' \
+       < parallel-orig.json > parallel.json
+    jq 'map(if .type == "OmnibusSigProc" then .data.parallel_planes = false else . end)' \
+       < serial-orig.json > serial.json
+
+    for planes in parallel serial
+    do
+        wire-cell -l "${planes}.log" -L debug -c "${planes}.json"
+        [[ -s "${planes}.tar.bz2" ]]
+        mkdir -p "$planes"
+        tar -C "$planes" -xjf "${planes}.tar.bz2"
+    done
+
+    # Same traces, tags and summaries for every frame.
+    [[ -n "$(ls parallel)" ]]
+    check diff -r parallel serial
+}
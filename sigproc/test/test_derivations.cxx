@@ -0,0 +1,105 @@
+/** Check Derivations::CalcMedian against a direct use of
+ * Waveform::median_binned() on each tick.
+ */
+
+#include "WireCellSigProc/Derivations.h"
+#include "WireCellUtil/Testing.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace WireCell;
+using namespace WireCell::SigProc;
+
+Waveform::realseq_t reference_median(const IChannelFilter::channel_signals_t& chansig)
+{
+    float max_rms = 0;
+    float count_max_rms = 0;
+    for (const auto& it : chansig) {
+        auto temp = Waveform::mean_rms(it.second);
+        if (temp.second > 0) {
+            max_rms += temp.second;
+            count_max_rms++;
+        }
+    }
+    if (count_max_rms > 0) {
+        max_rms /= count_max_rms;
+    }
+
+    const size_t nbins = chansig.begin()->second.size();
+    Waveform::realseq_t medians(nbins, 0);
+    for (size_t ibin = 0; ibin != nbins; ++ibin) {
+        Waveform::realseq_t temp;
+        for (const auto& it : chansig) {
+            if (ibin >= it.second.size()) {
+                continue;
+            }
+            const float cont = it.second[ibin];
+            if (fabs(cont) < 5 * max_rms && fabs(cont) > 0.001) {
+                temp.push_back(cont);
+            }
+        }
+        if (temp.size() > 1) {
+            medians[ibin] = Waveform::median_binned(temp);
+        }
+        else if (temp.size() == 1) {
+            // median_binned() has a zero bin size for a single value.
+            medians[ibin] = temp[0];
+        }
+    }
+    return medians;
+}
+
+static void check(const IChannelFilter::channel_signals_t& chansig)
+{
+    auto got = Derivations::CalcMedian(chansig);
+    auto want = reference_median(chansig);
+    Assert(got.size() == want.size());
+    for (size_t ind = 0; ind < got.size(); ++ind) {
+        if (got[ind] != want[ind]) {
+            std::cerr << "nchans=" << chansig.size() << " tick=" << ind << " got=" << got[ind]
+                      << " want=" << want[ind] << std::endl;
+        }
+        Assert(got[ind] == want[ind]);
+    }
+}
+
+int main()
+{
+    std::default_random_engine gen(1234);
+    std::normal_distribution<float> noise(0, 3);
+
+    // Ticks not a multiple of any tile size, some zero and some
+    // large samples which are excluded.
+    for (int nchans : {1, 2, 5, 48}) {
+        const int nticks = 1000 + nchans;
+        IChannelFilter::channel_signals_t chansig;
+        for (int ch = 0; ch < nchans; ++ch) {
+            auto& sig = chansig[100 + ch];
+            sig.resize(nticks);
+            for (int ind = 0; ind < nticks; ++ind) {
+                sig[ind] = noise(gen);
+            }
+            sig[ch % nticks] = 0;
+            sig[(7 * ch) % nticks] = 1000;
+        }
+        check(chansig);
+    }
+
+    // Channels shorter and longer than the first one.  A shorter
+    // channel takes no part in the median past its end.
+    {
+        IChannelFilter::channel_signals_t chansig;
+        const int nticks = 300;
+        for (int ch = 0; ch < 10; ++ch) {
+            auto& sig = chansig[100 + ch];
+            sig.resize(ch ? nticks - 37 * (ch % 3) + 5 * (ch % 2) : nticks);
+            for (auto& val : sig) {
+                val = noise(gen);
+            }
+        }
+        check(chansig);
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+/** OmnibusNoiseFilter must give the same output frame regardless of
+ * how many threads apply its filters and whether channel filters are
+ * applied to blocks of channels.
+ */
+
+#include "WireCellSigProc/OmnibusNoiseFilter.h"
+#include "WireCellSigProc/SimpleChannelNoiseDB.h"
+
+#include "WireCellAux/SimpleFrame.h"
+#include "WireCellAux/SimpleTrace.h"
+
+#include "WireCellUtil/PluginManager.h"
+#include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Testing.h"
+
+#include <iostream>
+#include <random>
+
+using namespace WireCell;
+using namespace WireCell::SigProc;
+
+// Subtract the mean and mask samples far from it.
+class ToyOneChannel : public IChannelFilter {
+   public:
+    virtual ~ToyOneChannel() {}
+    virtual Waveform::ChannelMaskMap apply(int channel, signal_t& sig) const
+    {
+        const float mean = Waveform::mean_rms(sig).first;
+        Waveform::ChannelMaskMap ret;
+        for (size_t ind = 0; ind < sig.size(); ++ind) {
+            sig[ind] -= mean;
+            if (std::abs(sig[ind]) > 25) {
+                ret["noisy"][channel].push_back(Waveform::BinRange(ind, ind + 1));
+            }
+        }
+        return ret;
+    }
+    virtual Waveform::ChannelMaskMap apply(channel_signals_t& chansig) const { return {}; }
+};
+
+// Subtract the per-tick average across the group.
+class ToyCoherent : public IChannelFilter {
+   public:
+    virtual ~ToyCoherent() {}
+    virtual Waveform::ChannelMaskMap apply(int channel, signal_t& sig) const { return {}; }
+    virtual Waveform::ChannelMaskMap apply(channel_signals_t& chansig) const
+    {
+        const size_t nticks = chansig.begin()->second.size();
+        signal_t avg(nticks, 0);
+        for (const auto& cs : chansig) {
+            Waveform::increase(avg, cs.second);
+        }
+        Waveform::scale(avg, 1.0 / chansig.size());
+        for (auto& cs : chansig) {
+            for (size_t ind = 0; ind < nticks; ++ind) {
+                cs.second[ind] -= avg[ind];
+            }
+        }
+        return {};
+    }
+};
+
+IFrame::pointer make_frame(int nchans, int nticks)
+{
+    std::default_random_engine gen(42);
+    std::normal_distribution<float> noise(100, 10);
+
+    ITrace::vector traces;
+    for (int ch = 0; ch < nchans; ++ch) {
+        ITrace::ChargeSequence charge(nticks);
+        for (auto& q : charge) {
+            q = noise(gen);
+        }
+        traces.push_back(std::make_shared<Aux::SimpleTrace>(ch, 0, charge));
+    }
+    return std::make_shared<Aux::SimpleFrame>(0, 0, traces);
+}
+
+IFrame::pointer filter(IFrame::pointer in, IChannelNoiseDatabase::pointer noisedb, int nthreads, int nbatch = 0)
+{
+    // Untagged input traces.
+    OmnibusNoiseFilter onf("", "raw");
+    onf.set_channel_noisedb(noisedb);
+    onf.set_channel_filters({std::make_shared<ToyOneChannel>()});
+    onf.set_grouped_filters({std::make_shared<ToyCoherent>()});
+    onf.set_channel_status_filters({std::make_shared<ToyOneChannel>()});
+    onf.set_nthreads(nthreads);
+    onf.set_batch_channels(nbatch);
+
+    IFrame::pointer out;
+    Assert(onf(in, out));
+    Assert(out);
+    return out;
+}
+
+int main()
+{
+    PluginManager& pm = PluginManager::instance();
+    pm.add("WireCellAux");
+    Factory::lookup_tn<IDFT>("FftwDFT");
+
+    const int nchans = 256;
+    const int nticks = 1000;
+    const int group_size = 32;
+
+    auto noisedb = std::make_shared<SimpleChannelNoiseDB>(0.5 * units::us, nticks);
+    noisedb->configure(noisedb->default_configuration());
+    std::vector<IChannelNoiseDatabase::channel_group_t> groups;
+    for (int ch = 0; ch < nchans; ++ch) {
+        if (ch % group_size == 0) {
+            groups.emplace_back();
+        }
+        groups.back().push_back(ch);
+    }
+    noisedb->set_channel_groups(groups);
+    noisedb->set_bad_channels({7, 100});
+
+    auto in = make_frame(nchans, nticks);
+    auto want = filter(in, noisedb, 1);
+
+    for (auto [nthreads, nbatch] : std::vector<std::pair<int, int>>{{0, 0}, {2, 0}, {4, 0}, {1, 7}, {1, 1000}, {4, 30}}) {
+        auto got = filter(in, noisedb, nthreads, nbatch);
+        std::cerr << "nthreads=" << nthreads << " nbatch=" << nbatch << " ntraces=" << got->traces()->size() << std::endl;
+
+        Assert(got->masks() == want->masks());
+        const auto& wtraces = *want->traces();
+        const auto& gtraces = *got->traces();
+        Assert(wtraces.size() == gtraces.size());
+        for (size_t ind = 0; ind < wtraces.size(); ++ind) {
+            Assert(wtraces[ind]->channel() == gtraces[ind]->channel());
+            Assert(wtraces[ind]->charge() == gtraces[ind]->charge());
+        }
+    }
+    Assert(!want->masks().empty());
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+/** Microboone::OneChannelNoise::apply_block() must give the same
+ * waveforms and masks as apply() called on each channel in turn.
+ */
+
+#include "WireCellSigProc/Microboone.h"
+#include "WireCellSigProc/SimpleChannelNoiseDB.h"
+
+#include "WireCellIface/IAnodePlane.h"
+
+#include "WireCellUtil/PluginManager.h"
+#include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Testing.h"
+
+#include <string>
+#include <vector>
+
+// Each provides a vector "horig" of 9594 samples.
+namespace chirp {
+#include "example-chirp.h"
+}
+namespace noisy {
+#include "example-noisy.h"
+}
+namespace partial {
+#include "example-partial-rc.h"
+}
+
+using namespace WireCell;
+using namespace WireCell::SigProc;
+
+// OneChannelNoise only asks the anode which plane a channel is in.
+// Channels 0-99 are on plane 0, 100-199 on plane 1, etc.
+class ToyAnode : public IAnodePlane {
+   public:
+    virtual ~ToyAnode() {}
+    virtual int ident() const { return 0; }
+    virtual int nfaces() const { return 0; }
+    virtual IAnodeFace::pointer face(int ident) const { return nullptr; }
+    virtual IAnodeFace::vector faces() const { return {}; }
+    virtual WirePlaneId resolve(int channel) const
+    {
+        const WirePlaneLayer_t layers[3] = {kUlayer, kVlayer, kWlayer};
+        return WirePlaneId(layers[(channel / 100) % 3], 0, 0);
+    }
+    virtual std::vector<int> channels() const { return {}; }
+    virtual IChannel::pointer channel(int chident) const { return nullptr; }
+    virtual IWire::vector wires(int chident) const { return {}; }
+};
+
+int main()
+{
+    PluginManager& pm = PluginManager::instance();
+    pm.add("WireCellAux");
+    Factory::lookup_tn<IDFT>("FftwDFT");
+
+    NamedFactory<ToyAnode> anode_factory;
+    Factory::associate<IAnodePlane>("ToyAnode", &anode_factory);
+    Factory::lookup_tn<IAnodePlane>("ToyAnode");
+    NamedFactory<SimpleChannelNoiseDB> noisedb_factory;
+    Factory::associate<IChannelNoiseDatabase>("SimpleChannelNoiseDB", &noisedb_factory);
+    Factory::associate<IConfigurable>("SimpleChannelNoiseDB", &noisedb_factory);
+
+    const int nticks = chirp::horig.size();
+    Assert(nticks == (int) noisy::horig.size());
+    Assert(nticks == (int) partial::horig.size());
+
+    // Each example on an induction and a collection channel, plus a
+    // shifted and scaled copy so no two rows are alike.
+    std::vector<int> channels;
+    std::vector<Waveform::realseq_t> signals;
+    for (int plane : {0, 2}) {
+        int ch = plane * 100;
+        for (const auto* wave : {&chirp::horig, &noisy::horig, &partial::horig}) {
+            signals.push_back(*wave);
+            channels.push_back(ch++);
+            auto other = *wave;
+            for (int ind = 0; ind < nticks; ++ind) {
+                other[ind] = 0.9 * (*wave)[(ind + 37 * ch) % nticks] + 3;
+            }
+            signals.push_back(other);
+            channels.push_back(ch++);
+        }
+    }
+    const int nchans = channels.size();
+
+    auto noisedb = Factory::lookup<IConfigurable>("SimpleChannelNoiseDB");
+    noisedb->configure(noisedb->default_configuration());
+    std::dynamic_pointer_cast<SimpleChannelNoiseDB>(noisedb)->set_sampling(0.5 * units::us, nticks);
+
+    Microboone::OneChannelNoise ocn("ToyAnode", "SimpleChannelNoiseDB");
+    ocn.configure(ocn.default_configuration());
+
+    // Channels are distinct so collecting per-channel masks needs no
+    // merging of bin ranges.
+    Waveform::ChannelMaskMap want;
+    std::vector<Waveform::realseq_t> want_signals = signals;
+    for (int ich = 0; ich < nchans; ++ich) {
+        for (const auto& [label, chmasks] : ocn.apply(channels[ich], want_signals[ich])) {
+            for (const auto& cm : chmasks) {
+                want[label][cm.first] = cm.second;
+            }
+        }
+    }
+
+    Array::array_xxf block(nchans, nticks);
+    for (int ich = 0; ich < nchans; ++ich) {
+        block.row(ich) = Eigen::Map<Eigen::ArrayXXf>(signals[ich].data(), 1, nticks);
+    }
+    auto got = ocn.apply_block(channels, block);
+
+    // The inputs give each kind of mask.
+    for (const std::string label : {"chirp", "lf_noisy", "noisy"}) {
+        Assert(want.count(label));
+        Assert(got.count(label));
+        Assert(got.at(label) == want.at(label));
+    }
+    Assert(got == want);
+
+    // Batched and single DFT plans may round differently.
+    for (int ich = 0; ich < nchans; ++ich) {
+        const auto& wsig = want_signals[ich];
+        for (int ind = 0; ind < nticks; ++ind) {
+            Assert(std::abs(block(ich, ind) - wsig[ind]) < 1e-3);
+        }
+    }
+
+    return 0;
+}
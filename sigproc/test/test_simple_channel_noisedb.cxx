@@ -44,5 +44,15 @@ int main()
     cerr << config1.size() << endl;
     Assert(config1.size() == nsamples);
 
+    // Bulk access matches the single value accessors, including for a
+    // channel which was never set.
+    auto params = cndb.channel_params({0, 1, 99});
+    Assert(params.size() == 3);
+    Assert(params[1].channel == 1);
+    Assert(params[1].gain_correction == cndb.gain_correction(1));
+    Assert(params[1].config == &cndb.config(1));
+    Assert(params[2].nominal_baseline == cndb.nominal_baseline(99));
+    Assert(params[2].rcrc->size() == nsamples);
+
     return 0;
 }
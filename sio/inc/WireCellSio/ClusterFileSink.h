@@ -153,8 +153,9 @@ namespace WireCell::Sio {
         using ostream_t = boost::iostreams::filtering_ostream;
 
       private:
-        // internal implmentation of the actual serializer.
-        using serializer_t = std::function<void(const ICluster& cluster)>;
+        // internal implmentation of the actual serializer.  It
+        // returns the number of files written.
+        using serializer_t = std::function<size_t(const ICluster& cluster)>;
 
         ostream_t m_out;
         serializer_t m_serializer;
@@ -162,9 +163,9 @@ namespace WireCell::Sio {
         size_t m_count{0};
 
         std::string fqn(const ICluster& cluster, std::string name, std::string ext);
-        void jsonify(const ICluster& cluster);
-        void dotify(const ICluster& cluster);
-        void numpify(const ICluster& cluster);
+        size_t jsonify(const ICluster& cluster);
+        size_t dotify(const ICluster& cluster);
+        size_t numpify(const ICluster& cluster);
 
         template<typename ArrayType>
         void write_numpy(const ArrayType& arr, const std::string& name) {
@@ -32,6 +32,10 @@ namespace WireCell::Sio {
         
         virtual bool operator()(ICluster::pointer& cluster);
 
+        /// Each cluster is one event.  Clusters of other worker
+        /// processes are skipped without being decoded.
+        virtual bool sharded() const { return true; }
+
     private:
         /**
            Configuration: "inname".
@@ -71,6 +75,7 @@ namespace WireCell::Sio {
         header_t m_cur;
 
         ICluster::pointer load();
+        void skip();
         bool load_filename();
         ICluster::pointer dispatch();
         void clear_load();
@@ -83,6 +88,7 @@ namespace WireCell::Sio {
 
         size_t m_count{0};
         bool m_eos_sent{false};
+        size_t m_nevents{0};    // clusters loaded or skipped
         std::vector<IAnodePlane::pointer> m_anodes;
     };
 
@@ -32,6 +32,10 @@ namespace WireCell::Sio {
         
         virtual bool operator()(IDepoSet::pointer& ds);
 
+        /// Each depo set is one event.  Depo sets of other worker
+        /// processes are skipped without being decoded.
+        virtual bool sharded() const { return true; }
+
       private:
 
         /// Configuration:
@@ -49,10 +53,12 @@ namespace WireCell::Sio {
         boost::iostreams::filtering_istream m_in;
 
         IDepoSet::pointer next();
+        void skip();
 
         double m_scale{1.0};
         size_t m_count{0};
         bool m_eos_sent{false};
+        size_t m_nevents{0};    // depo sets loaded or skipped
     };        
      
 }
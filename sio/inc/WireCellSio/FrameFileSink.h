@@ -77,9 +77,10 @@ namespace WireCell::Sio {
         // The output stream
         boost::iostreams::filtering_ostream m_out;
 
-        void one_tag(const IFrame::pointer& frame,
-                     const std::string& tag);
-        void masks(const IFrame::pointer& frame);
+        // Each returns the number of arrays written.
+        size_t one_tag(const IFrame::pointer& frame,
+                       const std::string& tag);
+        size_t masks(const IFrame::pointer& frame);
 
         size_t m_count{0};
     };        
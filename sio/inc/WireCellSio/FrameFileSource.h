@@ -22,6 +22,10 @@ namespace WireCell::Sio {
         virtual WireCell::Configuration default_configuration() const;
         
         virtual bool operator()(IFrame::pointer& frame);
+
+        /// Each frame is one event.  Frames of other worker
+        /// processes are skipped without being decoded.
+        virtual bool sharded() const { return true; }
         
       private:
         
@@ -77,6 +81,7 @@ namespace WireCell::Sio {
 
         size_t m_count{0};
         bool m_eos_sent{false};
+        size_t m_nevents{0};    // frames loaded or skipped
 
         // We must read-ahead one array to know that the sequence of
         // arrays for a given frame ident is complete.  This stashes
@@ -93,7 +98,8 @@ namespace WireCell::Sio {
         entry_t m_cur;
 
         void clear();
-        bool read();
+        bool read(bool body = true);
+        void skip();
 
     };        
      
@@ -86,7 +86,8 @@ namespace WireCell::Sio {
         ostream_t m_out;
         size_t m_count{0};
 
-        void numpyify(ITensor::pointer ten, const std::string& fname);
+        // Return false if the tensor has no array to write.
+        bool numpyify(ITensor::pointer ten, const std::string& fname);
         void jsonify(const Configuration& cfg, const std::string& fname);
 
 
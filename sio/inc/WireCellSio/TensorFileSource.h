@@ -29,6 +29,10 @@ namespace WireCell::Sio {
         // ITensorSetSource
         virtual bool operator()(ITensorSet::pointer &out);
 
+        /// Each tensor set is one event.  Tensor sets of other
+        /// worker processes are skipped without being decoded.
+        virtual bool sharded() const { return true; }
+
         /** Config: "inname"
 
             Name the input stream container.
@@ -75,8 +79,10 @@ namespace WireCell::Sio {
         istream_t m_in;
         size_t m_count{0};
         bool m_eos_sent{false};
+        size_t m_nevents{0};    // tensor sets loaded or skipped
 
         ITensorSet::pointer load();
+        void skip();
         bool read_head();
         void clear();
 
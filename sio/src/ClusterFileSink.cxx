@@ -7,6 +7,7 @@
 
 #include "WireCellUtil/Exceptions.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Shard.h"
 #include "WireCellUtil/GraphTools.h"
 #include "WireCellUtil/custard/custard_boost.hpp"
 
@@ -51,7 +52,7 @@ std::string Sio::ClusterFileSink::fqn(const ICluster& cluster, std::string name,
     return ss.str();
 }
 
-void Sio::ClusterFileSink::jsonify(const ICluster& cluster)
+size_t Sio::ClusterFileSink::jsonify(const ICluster& cluster)
 {
     auto top = Aux::jsonify(cluster.graph());
     std::stringstream topss;
@@ -60,11 +61,12 @@ void Sio::ClusterFileSink::jsonify(const ICluster& cluster)
     m_out << "name " << fqn(cluster, "graph", "json") << "\n"
           << "body " << tops.size() << "\n" << tops.data();
     m_out.flush();
+    return 1;
 }
 
 
 
-void Sio::ClusterFileSink::dotify(const ICluster& cluster)
+size_t Sio::ClusterFileSink::dotify(const ICluster& cluster)
 {
     auto top = Aux::dotify(cluster.graph());
     std::stringstream topss;
@@ -73,10 +75,11 @@ void Sio::ClusterFileSink::dotify(const ICluster& cluster)
     m_out << "name " << fqn(cluster, "graph", "dot") << "\n"
           << "body " << tops.size() << "\n" << tops.data();
     m_out.flush();
+    return 1;
 }
 
 
-void Sio::ClusterFileSink::numpify(const ICluster& cluster)
+size_t Sio::ClusterFileSink::numpify(const ICluster& cluster)
 {
     auto fn = [&](const std::string& name) {
         return this->fqn(cluster, name, "npy");
@@ -100,6 +103,7 @@ void Sio::ClusterFileSink::numpify(const ICluster& cluster)
         write_numpy(ea, fn(name));
     }
 
+    return nas.size() + eas.size();
 }
 
 void Sio::ClusterFileSink::configure(const WireCell::Configuration& cfg)
@@ -117,16 +121,16 @@ void Sio::ClusterFileSink::configure(const WireCell::Configuration& cfg)
         m_format = "numpy";
     }
     if (m_format == "json") {
-        m_serializer = [&](const ICluster& cluster){this->jsonify(cluster);};
+        m_serializer = [&](const ICluster& cluster){return this->jsonify(cluster);};
     }
     else if (m_format == "dot") {
-        m_serializer = [&](const ICluster& cluster){this->dotify(cluster);};
+        m_serializer = [&](const ICluster& cluster){return this->dotify(cluster);};
     }
     else if (m_format == "numpy") {
-        m_serializer = [&](const ICluster& cluster){this->numpify(cluster);};
+        m_serializer = [&](const ICluster& cluster){return this->numpify(cluster);};
     }
     else if (m_format == "dummy") {
-        m_serializer = [&](const ICluster& cluster){};
+        m_serializer = [&](const ICluster& cluster){return size_t(0);};
     }
     else {
         THROW(ValueError() << errmsg{"ClusterFileSink: unsupported format: " + m_format});
@@ -157,7 +161,8 @@ bool Sio::ClusterFileSink::operator()(const ICluster::pointer& cluster)
     }
     log->debug("save cluster {} at call={}: {}", cluster->ident(), m_count, dumps(gr));
 
-    m_serializer(*cluster);
+    const size_t nwritten = m_serializer(*cluster);
+    Shard::record(m_outname, cluster->ident(), nwritten);
 
     ++m_count;
     return true;
@@ -8,6 +8,7 @@
 
 #include "WireCellUtil/Exceptions.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Shard.h"
 #include "WireCellUtil/String.h"
 
 #include "WireCellAux/FrameTools.h"
@@ -304,10 +305,33 @@ void ClusterFileSource::clear_load()
     clear();
 }
 
+// Pass over the files of one cluster without reading them.  The
+// file name of the next cluster is left in m_cur.
+void ClusterFileSource::skip()
+{
+    int ident = -1;
+    while (true) {
+        if (! m_cur.fsize and ! load_filename()) {
+            return;
+        }
+        auto pf = parse_fname(log, m_cur.fname, m_prefix); // can throw
+        if (ident < 0) {
+            ident = pf.ident;
+            log->debug("call={} skip cluster ident={} of another worker", m_count, ident);
+        }
+        if (ident != pf.ident) {
+            return;
+        }
+        m_in.ignore(m_cur.fsize);
+        clear();
+    }
+}
+
 ICluster::pointer ClusterFileSource::load()
 {
     while (true) {
-        if (! load_filename()) {
+        // The file name may be left over from the previous cluster.
+        if (! m_cur.fsize and ! load_filename()) {
             return nullptr;
         }
         auto ret = dispatch();
@@ -324,6 +348,9 @@ bool ClusterFileSource::operator()(ICluster::pointer& cluster)
         return false;
     }
     try {
+        for (; !Shard::mine(m_nevents); ++m_nevents) {
+            skip();
+        }
         cluster = load();
     }
     catch (ValueError& err) {
@@ -339,6 +366,7 @@ bool ClusterFileSource::operator()(ICluster::pointer& cluster)
         m_eos_sent = true;
     }
     else {
+        ++m_nevents;
         // fixme: debugging. 
         const auto& cgraph = cluster->graph();
         for (auto vtx : mir(boost::vertices(cgraph))) {
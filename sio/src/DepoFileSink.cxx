@@ -4,6 +4,7 @@
 #include "WireCellUtil/Stream.h"
 #include "WireCellUtil/Exceptions.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Shard.h"
 #include "WireCellAux/DepoTools.h"
 
 WIRECELL_FACTORY(DepoFileSink,
@@ -76,6 +77,7 @@ bool Sio::DepoFileSink::operator()(const IDepoSet::pointer& deposet)
     write(m_out, iname, info);
     
     m_out.flush();
+    Shard::record(m_outname, deposet->ident(), 2);
 
     ++m_count;
     return true;
@@ -5,6 +5,7 @@
 #include "WireCellUtil/String.h"
 #include "WireCellUtil/Exceptions.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Shard.h"
 
 #include "WireCellAux/SimpleDepo.h"
 #include "WireCellAux/SimpleDepoSet.h"
@@ -243,6 +244,22 @@ IDepoSet::pointer Sio::DepoFileSource::next()
     return std::make_shared<Aux::SimpleDepoSet>(ident, idepos);
 }
 
+// Pass over the data/info pair of one depo set without reading it.
+// Errors are left for next() to find.
+void Sio::DepoFileSource::skip()
+{
+    for (int ind = 0; ind < 2; ++ind) {
+        std::string fname{""};
+        size_t fsize{0};
+        custard::read(m_in, fname, fsize);
+        if (!m_in) {
+            return;
+        }
+        log->debug("call={}, skip {} of another worker", m_count, fname);
+        m_in.ignore(fsize);
+    }
+}
+
 bool Sio::DepoFileSource::operator()(IDepoSet::pointer& ds)
 {
     ds = nullptr;
@@ -250,8 +267,14 @@ bool Sio::DepoFileSource::operator()(IDepoSet::pointer& ds)
         ++m_count;
         return false;
     }
+    for (; !Shard::mine(m_nevents); ++m_nevents) {
+        skip();
+    }
     ds = next();
-    if (!ds) {
+    if (ds) {
+        ++m_nevents;
+    }
+    else {
         m_eos_sent = true;
         log->debug("EOS at call={}", m_count);
     }
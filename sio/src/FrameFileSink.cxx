@@ -4,6 +4,7 @@
 #include "WireCellUtil/Stream.h"
 #include "WireCellUtil/Exceptions.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Shard.h"
 #include "WireCellUtil/Waveform.h"
 
 #include "WireCellAux/FrameTools.h"
@@ -120,8 +121,8 @@ void Sio::FrameFileSink::configure(const WireCell::Configuration& cfg)
                m_outname);
 }
 
-void Sio::FrameFileSink::one_tag(const IFrame::pointer& frame,
-                                 const std::string& tag)
+size_t Sio::FrameFileSink::one_tag(const IFrame::pointer& frame,
+                                   const std::string& tag)
 {
     ITrace::vector traces;
     IFrame::trace_summary_t summary;
@@ -139,7 +140,7 @@ void Sio::FrameFileSink::one_tag(const IFrame::pointer& frame,
     if (traces.empty()) {
         log->warn("call={} frame={} ntraces={} tag=\"{}\" zero traces",
                    m_count, frame->ident(),traces.size(), tag);
-        return;
+        return 0;
     }
 
     log->debug("call={} frame={} ntraces={} tag=\"{}\"",
@@ -178,10 +179,12 @@ void Sio::FrameFileSink::one_tag(const IFrame::pointer& frame,
             write(m_out, aname, arr);
         }
     }
+    size_t nwritten = 1;
 
     {  // the channel array
         const std::string aname = String::format("channels_%s_%d.npy", tag.c_str(), frame->ident());
         write(m_out, aname, channels);
+        ++nwritten;
         if (channels.size() != nrows) {
             log->warn("channels for tag \"{}\" ident {} has {} but there are {} waveform rows in frame",
                       tag, frame->ident(), channels.size(), nrows);
@@ -192,11 +195,13 @@ void Sio::FrameFileSink::one_tag(const IFrame::pointer& frame,
         const std::string aname = String::format("tickinfo_%s_%d.npy", tag.c_str(), frame->ident());
         const std::vector<double> tickinfo{frame->time(), frame->tick(), (double) tbinmm.first};
         write(m_out, aname, tickinfo);
+        ++nwritten;
     }
 
     if (summary.size()) { // the summary array
         const std::string aname = String::format("summary_%s_%d.npy", tag.c_str(), frame->ident());
         write(m_out, aname, summary);
+        ++nwritten;
         if (summary.size() != nrows) {
             log->warn("summary for tag \"{}\" ident {} has {} but there are {} waveform rows in frame",
                       tag, frame->ident(), summary.size(), nrows);
@@ -204,7 +209,7 @@ void Sio::FrameFileSink::one_tag(const IFrame::pointer& frame,
     }
 
     m_out.flush();
-
+    return nwritten;
 }
 
 static
@@ -217,7 +222,7 @@ size_t cms_size(const ChannelMasks& cms)
     return size;
 }
 
-void Sio::FrameFileSink::masks(const IFrame::pointer& frame)
+size_t Sio::FrameFileSink::masks(const IFrame::pointer& frame)
 {
     // - cmm :: string -> ChannelMasks
     // - ChannelMasks :: int -> BinRangeList
@@ -232,7 +237,7 @@ void Sio::FrameFileSink::masks(const IFrame::pointer& frame)
     auto cmm = frame->masks();
     if (cmm.empty()) {
         log->debug("no channel mask maps at call {}", m_count);
-        return;
+        return 0;
     }
 
     for (const auto& [name, cms] : cmm) {
@@ -254,6 +259,7 @@ void Sio::FrameFileSink::masks(const IFrame::pointer& frame)
 
         log->debug("save {} with {} entries", aname, nrows);
     }
+    return cmm.size();
 }
 
 
@@ -267,12 +273,14 @@ bool Sio::FrameFileSink::operator()(const IFrame::pointer& frame)
 
     log->debug("input frame: {}", Aux::taginfo(frame));
 
+    size_t nwritten = 0;
     for (auto tag : m_tags) {
-        one_tag(frame, tag);
+        nwritten += one_tag(frame, tag);
     }
     if (m_masks) {
-        masks(frame);
+        nwritten += masks(frame);
     }
+    Shard::record(m_outname, frame->ident(), nwritten);
 
     ++m_count;
     return true;
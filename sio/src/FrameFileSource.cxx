@@ -6,6 +6,7 @@
 #include "WireCellUtil/Waveform.h"
 #include "WireCellUtil/Exceptions.h"
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Shard.h"
 
 #include "WireCellAux/SimpleTrace.h"
 #include "WireCellAux/SimpleFrame.h"
@@ -93,12 +94,14 @@ bool FrameFileSource::is_tagged(const std::string& tag)
     return false;    
 }
 
-bool FrameFileSource::read()
+bool FrameFileSource::read(bool body)
 {
     clear();
 
     custard::read(m_in, m_cur.fname, m_cur.fsize);
-    m_cur.pig.read(m_in);
+    if (body) {
+        m_cur.pig.read(m_in);
+    }
 
     // log->debug("read file \"{}\" from stream with {} bytes", m_cur.fname, m_cur.fsize);
 
@@ -377,6 +380,47 @@ void FrameFileSource::clear()
     m_cur = entry_t();
 }
 
+// Pass over the arrays of one frame without reading their bodies.
+// As with load(), the first array of the next frame is left in
+// m_cur.
+void FrameFileSource::skip()
+{
+    int ident = -1;
+    while (true) {
+        bool unread = false;    // body still in stream
+        if (m_cur.fsize == 0) {
+            this->read(false);
+            if (m_cur.fsize == 0) {
+                return;         // EOF, left for load() to find
+            }
+            if (!m_in) {
+                log->error("call={}, bad header read with file={}", m_count, m_inname);
+                THROW(IOError() << errmsg{"bad header read with file " + m_inname});
+            }
+            if (!m_cur.okay) {
+                log->error("call={}, failed to parse npy file name {} in file={}",
+                           m_count, m_cur.fname, m_inname);
+                THROW(IOError() << errmsg{"numpy parse error with file " + m_inname});
+            }
+            unread = true;
+        }
+        if (ident < 0) {
+            ident = m_cur.ident;
+            log->debug("call={} skip frame ident={} of another worker", m_count, ident);
+        }
+        if (ident != m_cur.ident) {
+            if (unread) {
+                m_cur.pig.read(m_in);
+            }
+            return;
+        }
+        if (unread) {
+            m_in.ignore(m_cur.fsize);
+        }
+        clear();
+    }
+}
+
 bool FrameFileSource::operator()(IFrame::pointer& frame)
 {
     frame = nullptr;
@@ -384,9 +428,14 @@ bool FrameFileSource::operator()(IFrame::pointer& frame)
         return false;
     }
 
+    for (; !Shard::mine(m_nevents); ++m_nevents) {
+        skip();                 // throws
+    }
+
     frame = load();             // throws
 
     if (frame) {
+        ++m_nevents;
         log->debug("call={} load frame: {}", m_count++, Aux::taginfo(frame));
     }
     else {
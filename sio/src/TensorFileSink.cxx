@@ -2,6 +2,7 @@
 #include "WireCellUtil/Stream.h"
 
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Shard.h"
 
 WIRECELL_FACTORY(TensorFileSink, WireCell::Sio::TensorFileSink,
                  WireCell::INamed,
@@ -52,14 +53,15 @@ void TensorFileSink::finalize()
     m_out.pop();
 }
 
-void TensorFileSink::numpyify(ITensor::pointer ten, const std::string& fname)
+bool TensorFileSink::numpyify(ITensor::pointer ten, const std::string& fname)
 {
     const auto shape = ten->shape();
     if (shape.empty()) {
-        return;
+        return false;
     }
     Stream::write(m_out, fname, ten->data(), shape, ten->dtype());
     m_out.flush();
+    return true;
 }
 
 void TensorFileSink::jsonify(const Configuration& md, const std::string& fname)
@@ -87,6 +89,7 @@ bool TensorFileSink::operator()(const ITensorSet::pointer &in)
     if(m_dump_mode) {
         log->debug("dumping tensor set ident={} at call {}",
                    in->ident(), m_count);
+        Shard::record(m_outname, in->ident(), 0);
         return true;
     }
 
@@ -96,12 +99,17 @@ bool TensorFileSink::operator()(const ITensorSet::pointer &in)
     const size_t ntens = tens->size();
 
     jsonify(in->metadata(), pre + "set_" + sident + "_metadata.json");
+    size_t nwritten = 1;
     for (size_t ind=0; ind<ntens; ++ind) {
         auto ten = tens->at(ind);
         const std::string ppre = pre + "_" + sident + "_" + std::to_string(ind);
         jsonify(ten->metadata(), ppre + "_metadata.json");
-        numpyify(ten, ppre + "_array.npy");
+        ++nwritten;
+        if (numpyify(ten, ppre + "_array.npy")) {
+            ++nwritten;
+        }
     }
+    Shard::record(m_outname, in->ident(), nwritten);
 
     log->debug("write tensor set ident={} ntensors={} at call {}",
                sident, ntens, m_count);
@@ -5,6 +5,7 @@
 #include "WireCellAux/SimpleTensorSet.h"
 
 #include "WireCellUtil/NamedFactory.h"
+#include "WireCellUtil/Shard.h"
 
 WIRECELL_FACTORY(TensorFileSource, WireCell::Sio::TensorFileSource,
                  WireCell::INamed,
@@ -290,6 +291,36 @@ ITensorSet::pointer TensorFileSource::load()
     return std::make_shared<SimpleTensorSet>(ident, setmd, sv);
 }
 
+// Pass over the files of one tensor set without reading them.  As
+// with load(), the header of the next set is left in m_cur and errors
+// are left for load() to find.
+void TensorFileSource::skip()
+{
+    int ident = -1;
+    while (true) {
+        if (m_cur.fsize == 0) {
+            clear();
+            custard::read(m_in, m_cur.fname, m_cur.fsize);
+            if (m_in.eof() or !m_in or !m_cur.fsize) {
+                return;
+            }
+        }
+
+        auto pf = parse_fname(m_cur.fname, m_prefix);
+        if (pf.type != ParsedFilename::bad and pf.form != ParsedFilename::unknown) {
+            if (ident < 0) {
+                ident = pf.ident;
+                log->debug("call={} skip tensor set ident={} of another worker", m_count, ident);
+            }
+            if (ident != pf.ident) {
+                return;
+            }
+        }
+        m_in.ignore(m_cur.fsize);
+        clear();
+    }
+}
+
 void TensorFileSource::clear()
 {
     m_cur = header_t();
@@ -302,8 +333,14 @@ bool TensorFileSource::operator()(ITensorSet::pointer &out)
         log->debug("past EOS at call={}", m_count++);
         return false;
     }
+    for (; !Shard::mine(m_nevents); ++m_nevents) {
+        skip();
+    }
     out = load();
-    if (!out) {
+    if (out) {
+        ++m_nevents;
+    }
+    else {
         m_eos_sent = true;
     }
     if (!out) {
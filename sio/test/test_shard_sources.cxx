@@ -0,0 +1,115 @@
+// Check that the file sources pass over the events which are not in
+// the Shard of this process.
+
+#include "WireCellSio/FrameFileSink.h"
+#include "WireCellSio/FrameFileSource.h"
+#include "WireCellSio/TensorFileSink.h"
+#include "WireCellSio/TensorFileSource.h"
+
+#include "WireCellAux/SimpleFrame.h"
+#include "WireCellAux/SimpleTrace.h"
+#include "WireCellAux/SimpleTensor.h"
+#include "WireCellAux/SimpleTensorSet.h"
+
+#include "WireCellUtil/Shard.h"
+#include "WireCellUtil/Testing.h"
+
+#include <cstdio>
+#include <iostream>
+
+using namespace WireCell;
+
+const size_t nevents = 7;
+
+// Events differ in their number of traces and tensors so that a
+// source which skips a wrong number of files is caught.
+static void write_frames(const std::string& outname)
+{
+    Sio::FrameFileSink sink;
+    auto cfg = sink.default_configuration();
+    cfg["outname"] = outname;
+    sink.configure(cfg);
+    for (size_t event = 0; event < nevents; ++event) {
+        ITrace::vector traces;
+        for (size_t ch = 0; ch < 3 + event; ++ch) {
+            traces.push_back(std::make_shared<Aux::SimpleTrace>(ch, 0, std::vector<float>(10, event)));
+        }
+        sink(std::make_shared<Aux::SimpleFrame>(100 + event, 0, traces, 0.5));
+    }
+    sink(nullptr);
+    sink.finalize();
+}
+
+static void write_tensors(const std::string& outname)
+{
+    Sio::TensorFileSink sink;
+    auto cfg = sink.default_configuration();
+    cfg["outname"] = outname;
+    sink.configure(cfg);
+    for (size_t event = 0; event < nevents; ++event) {
+        auto sv = std::make_shared<ITensor::vector>();
+        for (size_t ind = 0; ind <= event % 3; ++ind) {
+            std::vector<float> data(4, event);
+            sv->push_back(std::make_shared<Aux::SimpleTensor>(ITensor::shape_t{4}, data.data(),
+                                                              Configuration(Json::objectValue)));
+        }
+        sink(std::make_shared<Aux::SimpleTensorSet>(200 + event, Json::objectValue, sv));
+    }
+    sink(nullptr);
+    sink.finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string name = argv[0];
+    const std::string fname = name + "-frames.tar";
+    const std::string tname = name + "-tensors.tar";
+    write_frames(fname);
+    write_tensors(tname);
+
+    for (size_t count : {1, 2, 3}) {
+        for (size_t index = 0; index < count; ++index) {
+            Shard::set(index, count);
+
+            Sio::FrameFileSource fsrc;
+            auto fcfg = fsrc.default_configuration();
+            fcfg["inname"] = fname;
+            fsrc.configure(fcfg);
+
+            Sio::TensorFileSource tsrc;
+            auto tcfg = tsrc.default_configuration();
+            tcfg["inname"] = tname;
+            tsrc.configure(tcfg);
+
+            std::cerr << "shard " << index << " of " << count << ":";
+            for (size_t event = index; event < nevents; event += count) {
+                IFrame::pointer frame;
+                Assert(fsrc(frame));
+                Assert(frame);
+                Assert(frame->ident() == (int) (100 + event));
+                Assert(frame->traces()->size() == 3 + event);
+
+                ITensorSet::pointer ts;
+                Assert(tsrc(ts));
+                Assert(ts);
+                Assert(ts->ident() == (int) (200 + event));
+                Assert(ts->tensors()->size() == event % 3 + 1);
+
+                std::cerr << " " << event;
+            }
+            std::cerr << "\n";
+
+            IFrame::pointer frame;
+            Assert(fsrc(frame));
+            Assert(!frame);
+            ITensorSet::pointer ts;
+            Assert(tsrc(ts));
+            Assert(!ts);
+        }
+    }
+
+    Shard::set(0, 1);
+    std::remove(fname.c_str());
+    std::remove(tname.c_str());
+    return 0;
+}
@@ -10,9 +10,46 @@
 #include <map>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 namespace WireCellTbb {
 
+    // Limits the number of messages from one source which are not yet
+    // consumed by all sinks downstream of the source.
+    struct InFlight;
+
+    /** A data flow graph using TBB flow graph.
+
+        The number of messages ("events") from a source which may be in
+        flight in the graph may be bounded in order to bound memory
+        usage.  A message is in flight until every sink reachable from
+        its source has consumed one message.  The "max_in_flight"
+        configuration parameter sets the bound for every source and
+        "source_max_in_flight" is an object mapping a source "type:name"
+        to a bound for that source.  A bound of 0 is unlimited, which
+        is the default.
+
+        Note, bounding assumes each sink downstream of a source
+        consumes one message for each message the source produces.
+        Graphs with nodes which reduce the message rate (eg, a
+        queuedout node emitting only at end of stream) may deadlock if
+        given too small a bound.
+
+        A "trace" may name a file to which a timeline of every call of
+        every WCT node is written in Chrome trace event JSON format.
+        Each event holds the start and duration, thread index and
+        message sequence number.  Default is empty, no trace.
+
+        Setting "fuse_chains" true runs each linear chain of function
+        nodes as a single TBB node so that one task carries a message
+        through the whole chain.  A chain link is an edge between two
+        function nodes where the tail has no other output edge and the
+        head no other input edge.  This saves scheduling and keeps
+        data in one core's cache at the cost of no pipelining between
+        the stages of a chain.  A fused chain has the smallest
+        concurrency of its nodes.  Per-node timing and tracing are
+        kept.  Default is false.
+    */
     class DataFlowGraph : public WireCell::Aux::Logger,
                           public WireCell::IDataFlowGraph,
                           public WireCell::IConfigurable
@@ -41,6 +78,36 @@ namespace WireCellTbb {
         // if 0, no summary logged, else log at level 1=debug, 2=info
         int m_summary{1};
         std::unordered_set<WireCellTbb::Node> m_nodes;
+
+        // Edges are recorded by connect() and made by run() so that
+        // limiters may be inserted after sources.
+        struct Edge {
+            WireCell::INode::pointer tail, head;
+            sender_type* sender;
+            receiver_type* receiver;
+        };
+        std::vector<Edge> m_edges;
+
+        // File name for a trace or empty for no tracing.
+        std::string m_trace{""};
+
+        // Bound on messages in flight per source, 0 is unlimited.
+        int m_max_in_flight{0};
+        std::map<std::string, int> m_source_max_in_flight;
+        std::vector<std::shared_ptr<InFlight>> m_inflight;
+
+        // Return the in flight bound for a source node.
+        int max_in_flight(WireCell::INode::pointer source) const;
+
+        // If true, fuse linear chains of function nodes.
+        bool m_fuse_chains{false};
+        std::vector<WireCellTbb::Node> m_fused;
+
+        // Replace chains in the recorded edges with fused nodes.
+        void fuse_chains();
+
+        // Insert limiters and make all recorded edges.
+        void make_edges();
     };
 
 }  // namespace WireCellTbb
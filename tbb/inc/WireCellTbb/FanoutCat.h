@@ -16,15 +16,8 @@ namespace WireCellTbb {
         WireCell::IFanoutNodeBase::pointer m_wcnode;
         NodeInfo& m_info;
 
-        // This is maybe better provided as a std::atomic.  However,
-        // the lack of copy constructor conflicts with the need for
-        // the body to be copied.  For now, we are safe as we ignore
-        // wcnode's desired concurrency and force the parent
-        // function_node to have concurrency=1.
-        mutable size_t m_seqno{0};
-
       public:
-        typedef typename WireCell::IFanoutNodeBase::any_vector any_vector;
+        typedef typename WireCell::IFanoutNodeBase::payload_vector payload_vector;
         typedef typename WireCell::type_repeater<N, msg_t>::type TupleType;
 
         FanoutBody(WireCell::INode::pointer wcnode, NodeInfo& info)
@@ -36,17 +29,18 @@ namespace WireCellTbb {
 
         TupleType operator()(msg_t in) const
         {
-            any_vector anyvec;
-            m_info.start();
-            bool ok = (*m_wcnode)(in.second, anyvec);
-            m_info.stop();
+            payload_vector outvec;
+            auto t0 = m_info.start();
+            bool ok = (*m_wcnode)(in.second, outvec);
+            m_info.stop(t0, in.first);
             if (!ok ) {
                 std::cerr << "TbbFlow: fanout call fails\n";
             }
             msg_vector_t savec;
-            const size_t seqno = m_seqno++;
-            for (auto& a : anyvec) {
-                savec.push_back(msg_t(seqno, a));
+            savec.reserve(outvec.size());
+            const seqno_t seqno = in.first;
+            for (auto& a : outvec) {
+                savec.push_back(msg_t(seqno, std::move(a)));
             }
             return WireCell::vectorToTuple<N>(savec);
         }
@@ -64,8 +58,9 @@ namespace WireCellTbb {
         using tuple_func_node = tbb::flow::function_node<msg_t, TupleType>;
 
         // This node takes user WC body and runs it after converting input verctor to tuple.
-        // We force-set concurency=1 so as not to upset to seqno in the body.
-        auto* fn = new tuple_func_node(graph, 1 /*wcnode->concurrency()*/,
+        // The body passes the input seqno to its outputs so any concurrency is corrected
+        // by the sequencers below.
+        auto* fn = new tuple_func_node(graph, wcnode->concurrency(),
                                        FanoutBody<N>(wcnode, info));
         // Below requires first to be the WCT body caller
         nodes.push_back(fn);
@@ -4,17 +4,18 @@
 #include "WireCellIface/IFunctionNode.h"
 #include "WireCellTbb/NodeWrapper.h"
 
+#include <algorithm>
 #include <iostream>  // temporary, don't ignore the error code, chump!
 
 namespace WireCellTbb {
 
-    // Body for a TBB function node.
+    // Body for a TBB function node.  It may be called concurrently
+    // if the WCT node allows it.  The output carries the seqno of the
+    // input so that order may be restored by the following sequencer.
     class FunctionBody {
         WireCell::IFunctionNodeBase::pointer m_wcnode;
         NodeInfo& m_info;
 
-        mutable seqno_t m_seqno{0};
-
       public:
         FunctionBody(WireCell::INode::pointer wcnode, NodeInfo& info)
             : m_wcnode(std::dynamic_pointer_cast<WireCell::IFunctionNodeBase>(wcnode))
@@ -26,13 +27,13 @@ namespace WireCellTbb {
         msg_t operator()(const msg_t& in) const
         {
             wct_t out;
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(in.second, out);
-            m_info.stop();
+            m_info.stop(t0, in.first);
             if (!ok) {
                 std::cerr << "TbbFlow: function node return false ignored\n";
             }
-            return msg_t(m_seqno++, out);
+            return msg_t(in.first, std::move(out));
         }
     };
 
@@ -45,7 +46,69 @@ namespace WireCellTbb {
         FunctionWrapper(tbb::flow::graph& graph, WireCell::INode::pointer wcnode)
         {
             m_info.set(wcnode);
-            auto fn = new func_node(graph, 1 /*wcnode->concurrency()*/, FunctionBody(wcnode, m_info));
+            auto fn = new func_node(graph, wcnode->concurrency(), FunctionBody(wcnode, m_info));
+            auto sn = new seq_node(graph, [](const msg_t& m) {return m.first;});
+            tbb::flow::make_edge(*fn, *sn);
+            m_fn = fn;
+            m_sn = sn;
+        }
+
+        virtual receiver_port_vector receiver_ports() { return {dynamic_cast<receiver_type*>(m_fn)}; }
+
+        virtual sender_port_vector sender_ports() { return {dynamic_cast<sender_type*>(m_sn)}; }
+    };
+
+    // A linear chain of WCT function nodes and the NodeInfo of their
+    // (otherwise unused) wrappers.
+    using function_chain_t = std::vector<std::pair<WireCell::IFunctionNodeBase::pointer, NodeInfo*>>;
+
+    // Body calling a chain of function nodes in turn as one task so
+    // the data of one message stays with one thread.  Each call is
+    // timed against the info of its own node.
+    class FusedFunctionBody {
+        function_chain_t m_chain;
+
+      public:
+        FusedFunctionBody(const function_chain_t& chain)
+            : m_chain(chain)
+        {
+        }
+
+        msg_t operator()(const msg_t& in) const
+        {
+            const wct_t* pin = &in.second;
+            wct_t data;
+            for (const auto& [wcnode, info] : m_chain) {
+                wct_t out;
+                auto t0 = info->start();
+                bool ok = (*wcnode)(*pin, out);
+                info->stop(t0, in.first);
+                if (!ok) {
+                    std::cerr << "TbbFlow: function node return false ignored\n";
+                }
+                data = std::move(out);
+                pin = &data;
+            }
+            return msg_t(in.first, std::move(data));
+        }
+    };
+
+    // Wrap a chain of function nodes as one function node.  The chain
+    // runs with the smallest concurrency of its nodes.
+    class FusedFunctionWrapper : public NodeWrapper {
+        tbb::flow::graph_node *m_fn, *m_sn;
+
+      public:
+        FusedFunctionWrapper(tbb::flow::graph& graph, const function_chain_t& chain)
+        {
+            size_t conc = tbb::flow::unlimited;  // which is 0
+            for (const auto& link : chain) {
+                const int nc = link.first->concurrency();
+                if (nc > 0) {
+                    conc = conc ? std::min(conc, (size_t) nc) : nc;
+                }
+            }
+            auto fn = new func_node(graph, conc, FusedFunctionBody(chain));
             auto sn = new seq_node(graph, [](const msg_t& m) {return m.first;});
             tbb::flow::make_edge(*fn, *sn);
             m_fn = fn;
@@ -24,7 +24,8 @@
 namespace WireCellTbb {
 
     /// The "any" interface to IHydraNode acccepts this type for both
-    /// input and output.
+    /// input and output.  Edge payloads are converted to and from
+    /// boost::any around each call.
     using any_queue_vector = WireCell::IHydraNodeBase::any_queue_vector;
 
     /// The TBB hydra implementation consists of an input side and an
@@ -125,7 +126,7 @@ namespace WireCellTbb {
     {
         const auto& oq = oqv[N];
         for (const auto& o : oq) {
-            bool accepted = std::get<N>(out).try_put(msg_t(counts[N]++, o));
+            bool accepted = std::get<N>(out).try_put(msg_t(counts[N]++, wct_t(o)));
             if (!accepted) {
                 std::cerr << "TbbFlow: hydra node input return false when try put on " << N << "\n";
             }
@@ -156,11 +157,11 @@ namespace WireCellTbb {
             any_queue_vector iqv(nin), oqv(Nout);
 
             size_t index = in.first;
-            iqv[index].push_back(in.second.second);
+            iqv[index].push_back(in.second.second.any());
 
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(iqv, oqv);
-            m_info.stop();
+            m_info.stop(t0, in.second.first);
             if (!ok) {
                 std::cerr << "TbbFlow: hydra body return false ignored\n";
             }
@@ -15,10 +15,8 @@ namespace WireCellTbb {
         WireCell::IJoinNodeBase::pointer m_wcnode;
         NodeInfo& m_info;
 
-        mutable seqno_t m_seqno{0};
-
        public:
-        typedef typename WireCell::IJoinNodeBase::any_vector any_vector;
+        typedef typename WireCell::IJoinNodeBase::payload_vector payload_vector;
         typedef typename WireCell::tuple_helper<TupleType> helper_type;
 
         JoinBody(WireCell::INode::pointer wcnode, NodeInfo& info)
@@ -31,18 +29,20 @@ namespace WireCellTbb {
         msg_t operator()(const TupleType& tup) const
         {
             auto msg_vec = as_msg_vector(tup);
-            any_vector in;
+            payload_vector in;
+            in.reserve(msg_vec.size());
             for (auto& msg : msg_vec) {
-                in.push_back(msg.second);
+                in.push_back(std::move(msg.second));
             }
             wct_t out;
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(in, out);
-            m_info.stop();
+            m_info.stop(t0, std::get<0>(tup).first);
             if (!ok) {
                 std::cerr << "TbbFlow: join node return false ignored\n";
             }
-            return msg_t(m_seqno++, out);
+            // All inputs in the tuple share the same seqno.
+            return msg_t(std::get<0>(tup).first, std::move(out));
         }
     };
 
@@ -56,7 +56,7 @@ namespace WireCellTbb {
 
         // this node takes user WC body and runs it after converting input tuple to vector
         typedef tbb::flow::function_node<TupleType, msg_t> joining_node;
-        auto* fn = new joining_node(graph, 1 /*wcnode->concurrency()*/,
+        auto* fn = new joining_node(graph, wcnode->concurrency(),
                                     JoinBody<TupleType>(wcnode, info));
 
         // this node is fully TBB and joins N receiver ports into a tuple
@@ -3,21 +3,26 @@
 
 #include "WireCellIface/INode.h"
 #include "WireCellIface/INamed.h"
+#include "WireCellUtil/Payload.h"
 #include "WireCellUtil/TupleHelpers.h"
+#include "WireCellUtil/TraceEvents.h"
+#include "WireCellUtil/Type.h"
 
 #include <tbb/flow_graph.h>
-#include <boost/any.hpp>
 #include <iostream>
 #include <utility>              // make_index_sequence
 #include <string>
 #include <memory>
 #include <chrono>
 #include <map>
+#include <mutex>
 
 namespace WireCellTbb {
 
-    // Message type passed through WCT nodes
-    using wct_t = boost::any;
+    // Message type passed through WCT nodes.  The bodies call the
+    // Payload level INode interface which takes it without a type
+    // check as DataFlowGraph::connect() checks port types.
+    using wct_t = WireCell::Payload;
 
     // We combine WCT data with a sequence number to assure order.
     using seqno_t = size_t;
@@ -42,9 +47,14 @@ namespace WireCellTbb {
 
     // tuple type nodes include join_node, split_node and indexer_node
 
-    // A helper to provide info about the node.
+    // A helper to provide info about the node.  The stop watch may be
+    // used concurrently by bodies of nodes with concurrency other
+    // than one.  If given a tracer, each call is also recorded as a
+    // trace event.
     class NodeInfo {
       public:
+        using clock_t = WireCell::TraceEvents::clock_t;
+        using time_point_t = clock_t::time_point;
 
         void set(WireCell::INode::pointer wcnode) { m_inode = wcnode; }
 
@@ -60,12 +70,19 @@ namespace WireCellTbb {
             return "(unknown)";
         }
 
-        // Start/stop the stop watch.
-        void start() {
-            m_clock = std::chrono::high_resolution_clock::now();
+        // Start the stop watch, returning the start time which must
+        // be passed to stop().
+        time_point_t start() const {
+            return clock_t::now();
         }
-        void stop() {
-            duration_t delta = std::chrono::high_resolution_clock::now() - m_clock;
+        void stop(time_point_t started, seqno_t seqno) {
+            const auto stopped = clock_t::now();
+            if (m_tracer) {
+                m_tracer->add({m_label, "tbb", started, stopped,
+                        WireCell::TraceEvents::thread_index(), (long)seqno});
+            }
+            duration_t delta = stopped - started;
+            std::lock_guard<std::mutex> lock(m_mutex);
             m_runtime += delta;
             if (delta > m_maxrt) {
                 m_maxrt = delta;
@@ -89,14 +106,24 @@ namespace WireCellTbb {
             return m_calls;
         }
 
+        // Set a tracer, null to turn off.  Must not be called while
+        // the graph runs.
+        void set_tracer(std::shared_ptr<WireCell::TraceEvents> tracer) {
+            m_tracer = tracer;
+            m_label = WireCell::type(*m_inode.get());
+            auto inamed = std::dynamic_pointer_cast<WireCell::INamed>(m_inode);
+            if (inamed and !inamed->get_name().empty()) {
+                m_label += ":" + inamed->get_name();
+            }
+        }
+
       private:
         WireCell::INode::pointer m_inode;
         duration_t m_runtime {0}, m_maxrt{0};
-        using clock_t = std::chrono::high_resolution_clock;
-        using time_point_t = clock_t::time_point;
-        time_point_t m_clock;
-
         size_t m_calls{0};
+        std::mutex m_mutex;
+        std::shared_ptr<WireCell::TraceEvents> m_tracer;
+        std::string m_label;
     };
     std::ostream& operator<<(std::ostream& os, const NodeInfo& info);
 
@@ -114,6 +141,10 @@ namespace WireCellTbb {
         virtual void initialize() {}
 
         const NodeInfo& info() const { return m_info; };
+        NodeInfo& info() { return m_info; };
+
+        // Record each call of the WCT node to the tracer.
+        void set_tracer(std::shared_ptr<WireCell::TraceEvents> tracer) { m_info.set_tracer(tracer); }
       protected:
         NodeInfo m_info;
     };
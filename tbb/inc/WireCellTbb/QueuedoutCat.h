@@ -1,4 +1,4 @@
-/** This adapts the queued out node category to a TBB multifunction node.
+/** This adapts the queued out node category to a small TBB subgraph.
  */
 
 #ifndef WIRECELLTBB_QUEUEDOUT
@@ -11,41 +11,66 @@
 
 namespace WireCellTbb {
 
+    // The queued output from one call along with the input seqno.
+    using queued_msg_t = std::pair<seqno_t, WireCell::IQueuedoutNodeBase::payload_queue>;
+    using queued_seq_node = tbb::flow::sequencer_node<queued_msg_t>;
+    using queued_func_node = tbb::flow::function_node<msg_t, queued_msg_t>;
+    using unqueue_node = tbb::flow::multifunction_node<queued_msg_t, std::tuple<msg_t>>;
+
+    // Call the WCT node.  This may run concurrently if the WCT node
+    // allows it.
     class QueuedoutBody {
         WireCell::IQueuedoutNodeBase::pointer m_wcnode;
         NodeInfo& m_info;
 
-        seqno_t m_seqno{0};
-
       public:
-        using mfunc_port = mfunc_node::output_ports_type;
-
         ~QueuedoutBody() {}
         QueuedoutBody(WireCell::INode::pointer wcnode, NodeInfo& info)
             : m_wcnode(std::dynamic_pointer_cast<WireCell::IQueuedoutNodeBase>(wcnode))
             , m_info(info)
         {
         }
-        void operator()(const msg_t& in, mfunc_port& out)
+        queued_msg_t operator()(const msg_t& in) const
         {
-            WireCell::IQueuedoutNodeBase::queuedany outq;
-            m_info.start();
+            WireCell::IQueuedoutNodeBase::payload_queue outq;
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(in.second, outq);
-            m_info.stop();
+            m_info.stop(t0, in.first);
             if (!ok) {
                 std::cerr << "TbbFlow: queuedout node return false ignored\n";
-                return;
+                outq.clear();
             }
-            for (auto a : outq) {
+            // Always send, even if empty, to not stall the sequencer.
+            return queued_msg_t(in.first, std::move(outq));
+        }
+    };
+
+    // Serially unpack the queued output, in input order, giving each
+    // element its own seqno.
+    class UnqueueBody {
+        seqno_t m_seqno{0};
+
+      public:
+        using mfunc_port = unqueue_node::output_ports_type;
+
+        void operator()(const queued_msg_t& in, mfunc_port& out)
+        {
+            for (const auto& a : in.second) {
                 // does not block.
                 bool accepted = std::get<0>(out).try_put(msg_t(m_seqno++, a));
                 if (!accepted) {
-                    std::cerr << "TbbFlow: unaccepted try_put " << m_wcnode->signature() << std::endl;
+                    std::cerr << "TbbFlow: unaccepted try_put from queuedout node\n";
                 }
             }
         }
     };
 
+    // The subgraph is:
+    //
+    //   [func(concurrency) - sequencer] - [mfunc(serial) - sequencer]
+    //
+    // The first half calls the WCT node and restores input order and
+    // the second half unpacks each output queue.
     class QueuedoutWrapper : public NodeWrapper {
         tbb::flow::graph_node *m_fn, *m_qn;
 
@@ -54,9 +79,13 @@ namespace WireCellTbb {
         QueuedoutWrapper(tbb::flow::graph& graph, WireCell::INode::pointer wcnode)
         {
             m_info.set(wcnode);
-            auto fn = new mfunc_node(graph, wcnode->concurrency(), QueuedoutBody(wcnode, m_info));
+            auto fn = new queued_func_node(graph, wcnode->concurrency(), QueuedoutBody(wcnode, m_info));
+            auto fsn = new queued_seq_node(graph, [](const queued_msg_t& m) {return m.first;});
+            auto un = new unqueue_node(graph, tbb::flow::serial, UnqueueBody());
             auto qn = new seq_node(graph, [](const msg_t& m) {return m.first;});
-            tbb::flow::make_edge(*fn, *qn);
+            tbb::flow::make_edge(*fn, *fsn);
+            tbb::flow::make_edge(*fsn, *un);
+            tbb::flow::make_edge(tbb::flow::output_port<0>(*un), *qn);
             m_fn = fn;
             m_qn = qn;
         }
@@ -5,45 +5,64 @@
 #include "WireCellIface/ISinkNode.h"
 
 #include <iostream> // fixme: for non-error handling
+#include <functional>
+#include <vector>
 
 namespace WireCellTbb {
 
+    // Functions called after each message is consumed by a sink.
+    using consumed_callbacks = std::vector<std::function<void()>>;
+
     // adapter to convert from WC sink node to TBB sink node body.
     class SinkBody {
         WireCell::ISinkNodeBase::pointer m_wcnode;
         NodeInfo& m_info;
+        const consumed_callbacks& m_consumed;
 
       public:
         ~SinkBody() {}
 
-        SinkBody(WireCell::INode::pointer wcnode, NodeInfo& info)
+        SinkBody(WireCell::INode::pointer wcnode, NodeInfo& info,
+                 const consumed_callbacks& consumed)
             : m_wcnode(std::dynamic_pointer_cast<WireCell::ISinkNodeBase>(wcnode))
             , m_info(info)
+            , m_consumed(consumed)
         {
               
         }
         tbb::flow::continue_msg operator()(const msg_t& in)
         {
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(in.second);
-            m_info.stop();
+            m_info.stop(t0, in.first);
             if (!ok) {
                 std::cerr << "TbbFlow: sink node return false ignored\n";
             }
+            for (const auto& cb : m_consumed) {
+                cb();
+            }
             return {};
         }
     };
 
     // implement facade to access ports for sink nodes
     class SinkNodeWrapper : public NodeWrapper {
+        consumed_callbacks m_consumed;
         sink_node* m_tbbnode;
 
       public:
         SinkNodeWrapper(tbb::flow::graph& graph, WireCell::INode::pointer wcnode)
-            : m_tbbnode(new sink_node(graph, 1 /*wcnode->concurrency()*/, SinkBody(wcnode, m_info)))
+            : m_tbbnode(new sink_node(graph, wcnode->concurrency(), SinkBody(wcnode, m_info, m_consumed)))
         {
             m_info.set(wcnode);
         }
+
+        // Add a function to call after each message is consumed.
+        // This must be called before the graph runs.
+        void add_consumed_callback(std::function<void()> cb)
+        {
+            m_consumed.push_back(cb);
+        }
         ~SinkNodeWrapper() {
             delete m_tbbnode;
         }
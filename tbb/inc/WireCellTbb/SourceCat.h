@@ -24,11 +24,11 @@ namespace WireCellTbb {
         }
         msg_t operator()(tbb::flow_control& fc) {
             wct_t out;
-            m_info.start();
+            auto t0 = m_info.start();
             bool ok = (*m_wcnode)(out);
-            m_info.stop();
+            m_info.stop(t0, m_seqno);
             if (ok) {
-                return msg_t(m_seqno++, out);
+                return msg_t(m_seqno++, std::move(out));
             }
             fc.stop();
             return {};
@@ -1,11 +1,16 @@
 #include "WireCellTbb/DataFlowGraph.h"
+#include "WireCellTbb/SinkCat.h"
+#include "WireCellTbb/FunctionCat.h"
 
 #include "WireCellUtil/Type.h"
 #include "WireCellUtil/NamedFactory.h"
 
 #include <tbb/global_control.h>
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
+#include <set>
 
 WIRECELL_FACTORY(TbbDataFlowGraph, WireCellTbb::DataFlowGraph, WireCell::IDataFlowGraph, WireCell::IConfigurable)
 
@@ -22,11 +27,45 @@ DataFlowGraph::DataFlowGraph(int max_threads)
 
 DataFlowGraph::~DataFlowGraph() {}
 
+struct WireCellTbb::InFlight {
+    tbb::flow::limiter_node<msg_t> limiter;
+    std::mutex mutex;
+    std::vector<size_t> consumed;  // count per sink
+    size_t returned{0};
+
+    InFlight(tbb::flow::graph& graph, size_t max_in_flight, size_t nsinks)
+        : limiter(graph, max_in_flight)
+        , consumed(nsinks, 0)
+    {
+    }
+
+    // Called by the isink'th sink after it consumes a message.  A
+    // token returns to the limiter once all sinks have consumed.
+    void consume(size_t isink)
+    {
+        size_t nreturn = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++consumed[isink];
+            const size_t done = *std::min_element(consumed.begin(), consumed.end());
+            nreturn = done - returned;
+            returned = done;
+        }
+        while (nreturn--) {
+            limiter.decrementer().try_put(tbb::flow::continue_msg());
+        }
+    }
+};
+
 Configuration DataFlowGraph::default_configuration() const
 {
     Configuration cfg;
     cfg["max_threads"] = 0;
     cfg["summary"] = m_summary;
+    cfg["max_in_flight"] = m_max_in_flight;
+    cfg["source_max_in_flight"] = Json::objectValue;
+    cfg["trace"] = m_trace;
+    cfg["fuse_chains"] = m_fuse_chains;
     return cfg;
 }
 
@@ -36,6 +75,173 @@ void DataFlowGraph::configure(const Configuration& cfg)
         m_thread_limit = cfg["max_threads"].asInt();
     }
     m_summary = get(cfg, "summary", m_summary);
+    m_trace = get(cfg, "trace", m_trace);
+    m_fuse_chains = get(cfg, "fuse_chains", m_fuse_chains);
+    m_max_in_flight = get(cfg, "max_in_flight", m_max_in_flight);
+    m_source_max_in_flight.clear();
+    const auto& jsmif = cfg["source_max_in_flight"];
+    if (jsmif.isObject()) {
+        for (const auto& tn : jsmif.getMemberNames()) {
+            m_source_max_in_flight[tn] = jsmif[tn].asInt();
+        }
+    }
+}
+
+int DataFlowGraph::max_in_flight(INode::pointer source) const
+{
+    for (const auto& [tn, num] : m_source_max_in_flight) {
+        if (Factory::find_maybe_tn<INode>(tn) == source) {
+            return num;
+        }
+    }
+    return m_max_in_flight;
+}
+
+void DataFlowGraph::fuse_chains()
+{
+    std::map<INode::pointer, size_t> nout, nin;
+    for (const auto& edge : m_edges) {
+        ++nout[edge.tail];
+        ++nin[edge.head];
+    }
+
+    // Index of the edge linking a node to the next in its chain.
+    std::map<INode::pointer, size_t> link;
+    std::set<INode::pointer> linked_head;
+    for (size_t ind = 0; ind < m_edges.size(); ++ind) {
+        const auto& edge = m_edges[ind];
+        if (edge.tail->category() != INode::functionNode or edge.head->category() != INode::functionNode) {
+            continue;
+        }
+        if (nout[edge.tail] != 1 or nin[edge.head] != 1) {
+            continue;
+        }
+        link[edge.tail] = ind;
+        linked_head.insert(edge.head);
+    }
+
+    std::vector<bool> interior(m_edges.size(), false);
+    for (const auto& [first, ind0] : link) {
+        if (linked_head.count(first)) {
+            continue;  // not the start of a chain
+        }
+
+        function_chain_t chain;
+        auto node = first;
+        while (true) {
+            chain.emplace_back(std::dynamic_pointer_cast<IFunctionNodeBase>(node), &m_factory(node)->info());
+            auto lit = link.find(node);
+            if (lit == link.end()) {
+                break;
+            }
+            interior[lit->second] = true;
+            node = m_edges[lit->second].head;
+        }
+
+        auto fused = std::make_shared<FusedFunctionWrapper>(m_graph, chain);
+        auto receiver = fused->receiver_ports()[0];
+        auto sender = fused->sender_ports()[0];
+        for (auto& edge : m_edges) {
+            if (edge.head == first) {
+                edge.receiver = receiver;
+            }
+            if (edge.tail == node) {
+                edge.sender = sender;
+            }
+        }
+        log->debug("fused chain of {} function nodes from {} to {}", chain.size(),
+                   demangle(first->signature()), demangle(node->signature()));
+        m_fused.push_back(fused);
+    }
+
+    std::vector<Edge> edges;
+    for (size_t ind = 0; ind < m_edges.size(); ++ind) {
+        if (!interior[ind]) {
+            edges.push_back(m_edges[ind]);
+        }
+    }
+    m_edges.swap(edges);
+}
+
+void DataFlowGraph::make_edges()
+{
+    std::map<INode::pointer, std::vector<INode::pointer>> children;
+    std::set<INode::pointer> sources;
+    for (const auto& edge : m_edges) {
+        children[edge.tail].push_back(edge.head);
+        if (edge.tail->category() == INode::sourceNode) {
+            sources.insert(edge.tail);
+        }
+    }
+
+    // Fuse after finding children as fusing drops chain interior edges.
+    if (m_fuse_chains) {
+        fuse_chains();
+    }
+
+    // Limiter to place after a source.
+    std::map<INode::pointer, InFlight*> limited;
+    for (auto source : sources) {
+        const int mif = max_in_flight(source);
+        if (mif <= 0) {
+            continue;
+        }
+
+        // Find all sinks reachable from the source.
+        std::vector<INode::pointer> sinks, todo{source};
+        std::set<INode::pointer> seen{source};
+        while (!todo.empty()) {
+            auto node = todo.back();
+            todo.pop_back();
+            if (node->category() == INode::sinkNode) {
+                sinks.push_back(node);
+            }
+            for (auto child : children[node]) {
+                if (seen.insert(child).second) {
+                    todo.push_back(child);
+                }
+            }
+        }
+        const std::string sname = demangle(source->signature());
+        if (sinks.empty()) {
+            log->warn("no sinks downstream of {}, not limiting messages in flight", sname);
+            continue;
+        }
+
+        auto inflight = std::make_shared<InFlight>(m_graph, mif, sinks.size());
+        for (size_t isink = 0; isink < sinks.size(); ++isink) {
+            auto sinkw = std::dynamic_pointer_cast<SinkNodeWrapper>(m_factory(sinks[isink]));
+            if (!sinkw) {
+                log->critical("sink node lacks sink wrapper: {}", demangle(sinks[isink]->signature()));
+                THROW(ValueError() << errmsg{"sink node lacks sink wrapper"});
+            }
+            std::weak_ptr<InFlight> winf = inflight;
+            sinkw->add_consumed_callback([winf, isink]() {
+                auto inf = winf.lock();
+                if (inf) {
+                    inf->consume(isink);
+                }
+            });
+        }
+        log->debug("limit {} messages in flight from {} to {} sinks", mif, sname, sinks.size());
+        m_inflight.push_back(inflight);
+        limited[source] = inflight.get();
+    }
+
+    std::set<sender_type*> fed;
+    for (const auto& edge : m_edges) {
+        sender_type* sender = edge.sender;
+        auto lit = limited.find(edge.tail);
+        if (lit != limited.end()) {
+            auto& limiter = lit->second->limiter;
+            if (fed.insert(sender).second) {
+                make_edge(*sender, limiter);
+            }
+            sender = &limiter;
+        }
+        make_edge(*sender, *edge.receiver);
+    }
+    m_edges.clear();
 }
 
 bool DataFlowGraph::connect(INode::pointer tail, INode::pointer head, size_t sport, size_t rport)
@@ -101,7 +307,7 @@ bool DataFlowGraph::connect(INode::pointer tail, INode::pointer head, size_t spo
         return false;
     }
 
-    make_edge(*s, *r);
+    m_edges.push_back(Edge{tail, head, s, r});
     m_nodes.insert(mytail);
     m_nodes.insert(myhead);
     return true;
@@ -109,6 +315,16 @@ bool DataFlowGraph::connect(INode::pointer tail, INode::pointer head, size_t spo
 
 bool DataFlowGraph::run()
 {
+    make_edges();
+
+    std::shared_ptr<TraceEvents> tracer;
+    if (!m_trace.empty()) {
+        tracer = std::make_shared<TraceEvents>();
+        for (auto it : m_factory.seen()) {
+            it.second->set_tracer(tracer);
+        }
+    }
+
     for (auto it : m_factory.seen()) {
         //log->debug("Initialize node of type: {}", demangle(it.first->signature()));
         it.second->initialize();
@@ -122,6 +338,14 @@ bool DataFlowGraph::run()
     }
     m_graph.wait_for_all();
 
+    if (tracer) {
+        log->debug("writing {} trace events to {}", tracer->size(), m_trace);
+        tracer->write(m_trace);
+        for (auto it : m_factory.seen()) {
+            it.second->set_tracer(nullptr);
+        }
+    }
+
     if (m_summary) {
         std::vector<WireCellTbb::Node> nodes(m_nodes.begin(), m_nodes.end());
         std::sort(nodes.begin(), nodes.end(),
@@ -68,7 +68,7 @@ struct SinkBody {
     {
         auto& [p,m] = in;
         auto& [n,aid] = m;
-        auto id = boost::any_cast<int>(aid);
+        auto id = aid.get<int>();
         std::stringstream ss;
         ss << "<- " << id << ": " << n << " " << p << "\n";
         std::cerr << ss.str();
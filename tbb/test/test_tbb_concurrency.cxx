@@ -0,0 +1,123 @@
+// Check that TbbFlow node wrappers honor INode::concurrency() while
+// still delivering data to the sink in order.
+
+#include "WireCellTbb/SourceCat.h"
+#include "WireCellTbb/FunctionCat.h"
+#include "WireCellTbb/QueuedoutCat.h"
+#include "WireCellTbb/SinkCat.h"
+
+#include "WireCellIface/ISourceNode.h"
+#include "WireCellIface/IFunctionNode.h"
+#include "WireCellIface/IQueuedoutNode.h"
+#include "WireCellIface/ISinkNode.h"
+#include "WireCellUtil/Testing.h"
+
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <iostream>
+
+using namespace WireCell;
+using namespace WireCellTbb;
+
+const int nints = 200;
+
+class IntSource : public ISourceNode<int> {
+    int m_count{0};
+  public:
+    virtual ~IntSource() {}
+    virtual bool operator()(output_pointer& out)
+    {
+        if (m_count >= nints) {
+            return false;
+        }
+        out = std::make_shared<int>(m_count++);
+        return true;
+    }
+};
+
+// Reentrant and slow with a duration that varies with the data so
+// outputs tend to be produced out of order.
+class IntSlow : public IFunctionNode<int, int> {
+  public:
+    std::atomic<int> nbusy{0}, maxbusy{0};
+    virtual ~IntSlow() {}
+    virtual int concurrency() { return 0; }
+    virtual bool operator()(const input_pointer& in, output_pointer& out)
+    {
+        int busy = ++nbusy;
+        int seen = maxbusy;
+        while (busy > seen && !maxbusy.compare_exchange_weak(seen, busy)) {}
+        std::this_thread::sleep_for(std::chrono::microseconds(100 * (7 - *in % 7)));
+        out = in;
+        --nbusy;
+        return true;
+    }
+};
+
+// Reentrant, emits each input twice.
+class IntTwice : public IQueuedoutNode<int, int> {
+  public:
+    virtual ~IntTwice() {}
+    virtual std::string signature() { return typeid(IntTwice).name(); }
+    virtual int concurrency() { return 4; }
+    virtual bool operator()(const input_pointer& in, output_queue& outq)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100 * (5 - *in % 5)));
+        outq.push_back(in);
+        outq.push_back(in);
+        return true;
+    }
+};
+
+class IntSink : public ISinkNode<int> {
+  public:
+    std::vector<int> got;
+    virtual ~IntSink() {}
+    virtual bool operator()(const input_pointer& in)
+    {
+        got.push_back(*in);
+        return true;
+    }
+};
+
+void run_graph()
+{
+    auto src = std::make_shared<IntSource>();
+    auto slow = std::make_shared<IntSlow>();
+    auto twice = std::make_shared<IntTwice>();
+    auto sink = std::make_shared<IntSink>();
+
+    tbb::flow::graph graph;
+    SourceNodeWrapper wsrc(graph, src);
+    FunctionWrapper wslow(graph, slow);
+    QueuedoutWrapper wtwice(graph, twice);
+    SinkNodeWrapper wsink(graph, sink);
+
+    make_edge(*wsrc.sender_ports()[0], *wslow.receiver_ports()[0]);
+    make_edge(*wslow.sender_ports()[0], *wtwice.receiver_ports()[0]);
+    make_edge(*wtwice.sender_ports()[0], *wsink.receiver_ports()[0]);
+
+    wsrc.initialize();
+    graph.wait_for_all();
+
+    std::cerr << "max concurrent calls: " << slow->maxbusy << "\n";
+    std::cerr << "sink got: " << sink->got.size() << "\n";
+    Assert(sink->got.size() == 2 * nints);
+    for (int ind = 0; ind < 2 * nints; ++ind) {
+        AssertMsg(sink->got[ind] == ind / 2, "out of order");
+    }
+    Assert(wslow.info().calls() == nints);
+}
+
+int main()
+{
+    // Explicit arena so concurrency is exercised even on few cores.
+    tbb::global_control gc(tbb::global_control::max_allowed_parallelism, 8);
+    tbb::task_arena arena(8);
+    arena.execute(run_graph);
+    return 0;
+}
@@ -109,11 +109,11 @@ int main()
 
     graph.wait_for_all();
 
-    auto source_info = source->info();
+    const auto& source_info = source->info();
     std::cerr << source_info << std::endl;
-    auto drift_info = drift->info();
+    const auto& drift_info = drift->info();
     std::cerr << drift_info << std::endl;
-    auto sink_info = sink->info();
+    const auto& sink_info = sink->info();
     std::cerr << sink_info << std::endl;
     return 0;
 }
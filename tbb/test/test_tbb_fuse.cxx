@@ -0,0 +1,110 @@
+// Check that TbbDataFlowGraph runs a fused chain of function nodes
+// as one task per message.
+
+#include "WireCellTbb/DataFlowGraph.h"
+
+#include "WireCellIface/ISourceNode.h"
+#include "WireCellIface/IFunctionNode.h"
+#include "WireCellIface/ISinkNode.h"
+#include "WireCellUtil/Testing.h"
+
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <iostream>
+
+using namespace WireCell;
+
+const int nints = 100;
+const int nfuncs = 3;
+
+// Thread of each call, per message and chain stage.
+std::mutex threads_mutex;
+std::map<int, std::vector<std::thread::id>> threads;
+
+class IntSource : public ISourceNode<int> {
+    int m_count{0};
+
+  public:
+    virtual ~IntSource() {}
+    virtual bool operator()(output_pointer& out)
+    {
+        if (m_count >= nints) {
+            return false;
+        }
+        out = std::make_shared<int>(m_count++);
+        return true;
+    }
+};
+
+// Pass on the input value, recording the calling thread.
+class IntTrace : public IFunctionNode<int, int> {
+  public:
+    virtual ~IntTrace() {}
+    virtual int concurrency() { return 0; }
+    virtual bool operator()(const input_pointer& in, output_pointer& out)
+    {
+        {
+            std::lock_guard<std::mutex> lock(threads_mutex);
+            threads[*in].push_back(std::this_thread::get_id());
+        }
+        std::this_thread::yield();
+        out = in;
+        return true;
+    }
+};
+
+class IntSink : public ISinkNode<int> {
+  public:
+    int consumed{0};
+    virtual ~IntSink() {}
+    virtual bool operator()(const input_pointer& in)
+    {
+        AssertMsg(*in == consumed, "out of order");
+        ++consumed;
+        return true;
+    }
+};
+
+void run_graph()
+{
+    auto src = std::make_shared<IntSource>();
+    auto sink = std::make_shared<IntSink>();
+    std::vector<INode::pointer> funcs;
+    for (int ind = 0; ind < nfuncs; ++ind) {
+        funcs.push_back(std::make_shared<IntTrace>());
+    }
+
+    WireCellTbb::DataFlowGraph dfg;
+    auto cfg = dfg.default_configuration();
+    cfg["fuse_chains"] = true;
+    dfg.configure(cfg);
+
+    Assert(dfg.connect(src, funcs.front()));
+    for (int ind = 1; ind < nfuncs; ++ind) {
+        Assert(dfg.connect(funcs[ind - 1], funcs[ind]));
+    }
+    Assert(dfg.connect(funcs.back(), sink));
+    dfg.run();
+
+    std::cerr << "consumed: " << sink->consumed << "\n";
+    Assert(sink->consumed == nints);
+    Assert(threads.size() == (size_t) nints);
+    for (const auto& [num, tids] : threads) {
+        Assert(tids.size() == (size_t) nfuncs);
+        for (const auto& tid : tids) {
+            AssertMsg(tid == tids.front(), "fused chain changed threads");
+        }
+    }
+}
+
+int main()
+{
+    tbb::global_control gc(tbb::global_control::max_allowed_parallelism, 8);
+    tbb::task_arena arena(8);
+    arena.execute(run_graph);
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Check that TbbDataFlowGraph bounds the number of messages in flight
+// between a source and its sinks.
+
+#include "WireCellTbb/DataFlowGraph.h"
+
+#include "WireCellIface/ISourceNode.h"
+#include "WireCellIface/IFunctionNode.h"
+#include "WireCellIface/ISinkNode.h"
+#include "WireCellUtil/Testing.h"
+
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <iostream>
+
+using namespace WireCell;
+
+const int nints = 100;
+const int max_in_flight = 3;
+
+std::atomic<int> produced{0};
+
+class IntSource : public ISourceNode<int> {
+  public:
+    virtual ~IntSource() {}
+    virtual bool operator()(output_pointer& out)
+    {
+        if (produced >= nints) {
+            return false;
+        }
+        out = std::make_shared<int>(produced++);
+        return true;
+    }
+};
+
+class IntSlow : public IFunctionNode<int, int> {
+  public:
+    virtual ~IntSlow() {}
+    virtual int concurrency() { return 0; }
+    virtual bool operator()(const input_pointer& in, output_pointer& out)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        out = in;
+        return true;
+    }
+};
+
+class IntSink : public ISinkNode<int> {
+  public:
+    int consumed{0}, maxinflight{0};
+    virtual ~IntSink() {}
+    virtual bool operator()(const input_pointer& in)
+    {
+        // The source may hold one more message than the limiter
+        // accepts.
+        maxinflight = std::max(maxinflight, produced - consumed);
+        AssertMsg(*in == consumed, "out of order");
+        ++consumed;
+        return true;
+    }
+};
+
+void run_graph()
+{
+    auto src = std::make_shared<IntSource>();
+    auto slow = std::make_shared<IntSlow>();
+    auto sink = std::make_shared<IntSink>();
+
+    WireCellTbb::DataFlowGraph dfg;
+    auto cfg = dfg.default_configuration();
+    cfg["max_in_flight"] = max_in_flight;
+    dfg.configure(cfg);
+
+    Assert(dfg.connect(src, slow));
+    Assert(dfg.connect(slow, sink));
+    dfg.run();
+
+    std::cerr << "consumed: " << sink->consumed << " max in flight: " << sink->maxinflight << "\n";
+    Assert(sink->consumed == nints);
+    Assert(sink->maxinflight <= max_in_flight + 1);
+}
+
+int main()
+{
+    tbb::global_control gc(tbb::global_control::max_allowed_parallelism, 8);
+    tbb::task_arena arena(8);
+    arena.execute(run_graph);
+    return 0;
+}
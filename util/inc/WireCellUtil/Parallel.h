@@ -0,0 +1,26 @@
+#ifndef WIRECELL_PARALLEL
+#define WIRECELL_PARALLEL
+
+#include <cstddef>
+#include <functional>
+
+namespace WireCell {
+
+    // Simple fork/join helpers for code which splits a fixed amount
+    // of independent work over a few threads.
+    namespace Parallel {
+
+        // Call func(ind) for each ind in [0,num) on up to nthreads
+        // threads.  A nonpositive nthreads uses one thread per
+        // hardware core.  With one thread, or num less than two, the
+        // calls are made in order on the calling thread and the
+        // first exception propagates.  Otherwise each thread takes
+        // the next index not yet taken, every index is called even
+        // if some throw and the exception of the lowest index is
+        // rethrown once all threads are done.
+        void for_each_index(size_t num, int nthreads, const std::function<void(size_t)>& func);
+
+    }  // namespace Parallel
+}  // namespace WireCell
+
+#endif
@@ -0,0 +1,128 @@
+/** A type-indexed payload for data flow graph edges.
+
+    A Payload holds the shared pointer that a typed INode produces
+    directly, along with the std::type_info of that pointer type.  The
+    pointer is stored in place so making, copying and moving a Payload
+    does not allocate, unlike a boost::any which puts each held value
+    in a new heap holder.
+
+    Any other value, such as a plain int in tests or the boost::any
+    that a hydra node produces, is held in a boost::any.
+
+    get<T>() is checked and throws boost::bad_any_cast like
+    boost::any_cast.  get_unchecked<T>() does no type check for a held
+    pointer.  It is only for callers which already know the held type,
+    such as the INode templates when called by a graph engine which
+    checks port signatures once at connect time.
+ */
+
+#ifndef WIRECELLUTIL_PAYLOAD
+#define WIRECELLUTIL_PAYLOAD
+
+#include <boost/any.hpp>
+
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+
+namespace WireCell {
+
+    class Payload {
+        // Held shared pointer type T.
+        template <typename T>
+        struct is_shared_ptr : std::false_type {
+        };
+        template <typename T>
+        struct is_shared_ptr<std::shared_ptr<T>> : std::true_type {
+        };
+
+       public:
+        Payload() = default;
+
+        // Hold a shared pointer in place.
+        template <typename T>
+        Payload(std::shared_ptr<T> ptr)
+          : m_ptr(std::move(ptr))
+          , m_type(&typeid(std::shared_ptr<T>))
+          , m_to_any(&to_any<T>)
+        {
+        }
+
+        // Hold any other value in a boost::any.
+        template <typename ValueType,
+                  typename Bare = std::decay_t<ValueType>,
+                  typename = std::enable_if_t<!std::is_same<Bare, Payload>::value &&
+                                              !std::is_same<Bare, boost::any>::value &&
+                                              !is_shared_ptr<Bare>::value>>
+        Payload(ValueType&& value)
+          : m_any(std::forward<ValueType>(value))
+        {
+        }
+
+        // Hold an existing boost::any as-is.
+        Payload(boost::any any)
+          : m_any(std::move(any))
+        {
+        }
+
+        bool empty() const { return !m_type && m_any.empty(); }
+
+        // The type of the held value, as boost::any::type() would give.
+        const std::type_info& type() const { return m_type ? *m_type : m_any.type(); }
+
+        // Return the held value, throw boost::bad_any_cast if it is
+        // not of type ValueType.
+        template <typename ValueType>
+        ValueType get() const
+        {
+            if constexpr (is_shared_ptr<ValueType>::value) {
+                if (m_type) {
+                    if (*m_type != typeid(ValueType)) {
+                        throw boost::bad_any_cast();
+                    }
+                    return get_unchecked<ValueType>();
+                }
+            }
+            else {
+                if (m_type) {
+                    throw boost::bad_any_cast();
+                }
+            }
+            return boost::any_cast<ValueType>(m_any);
+        }
+
+        // Return the held pointer without a type check.  The caller
+        // must know the payload holds a ValueType.  A value held in a
+        // boost::any is still cast with a check.
+        template <typename ValueType>
+        ValueType get_unchecked() const
+        {
+            if constexpr (is_shared_ptr<ValueType>::value) {
+                if (m_type) {
+                    using element_type = typename ValueType::element_type;
+                    return std::static_pointer_cast<element_type>(std::const_pointer_cast<void>(m_ptr));
+                }
+            }
+            return boost::any_cast<ValueType>(m_any);
+        }
+
+        // Return the held value as a boost::any.  This allocates and
+        // is for the boost::any level INode interface.
+        boost::any any() const { return m_type ? m_to_any(m_ptr) : m_any; }
+
+       private:
+        template <typename T>
+        static boost::any to_any(const std::shared_ptr<const void>& ptr)
+        {
+            return std::static_pointer_cast<T>(std::const_pointer_cast<void>(ptr));
+        }
+
+        std::shared_ptr<const void> m_ptr;
+        const std::type_info* m_type{nullptr};
+        boost::any (*m_to_any)(const std::shared_ptr<const void>&){nullptr};
+        boost::any m_any;
+    };
+
+}  // namespace WireCell
+
+#endif
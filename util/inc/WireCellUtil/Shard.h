@@ -0,0 +1,63 @@
+#ifndef WIRECELL_SHARD
+#define WIRECELL_SHARD
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace WireCell {
+
+    // A process may be one of several which share the processing of
+    // a stream of events.  Each process handles a disjoint shard of
+    // the events.  The event with count (from zero) "num" belongs to
+    // the shard with index num % count.  The default is a single
+    // shard holding all events.  See "wire-cell --workers".
+    namespace Shard {
+
+        // Set the shard of this process.  Throws ValueError if index
+        // is not less than count.
+        void set(size_t index, size_t count);
+
+        // The index of this process's shard.
+        size_t index();
+
+        // The total number of shards.
+        size_t count();
+
+        // Return true if the event with the given count belongs to
+        // this process's shard.
+        bool mine(size_t num);
+
+        // Return the name of a shard's copy of an output file.  The
+        // shard index is inserted before the extensions so that the
+        // file type is kept, eg "out.tar.bz2" for shard 1 becomes
+        // "out-worker1.tar.bz2".
+        std::string outname(const std::string& name, size_t index);
+
+        // Record that a file sink wrote one event with the given
+        // ident as its next nmembers members of the archive outname.
+        // The n-th event recorded for an outname is event number
+        // index() + n*count() of the stream.  Does nothing if there
+        // is a single shard.  This may be called from any thread.
+        void record(const std::string& outname, int ident, size_t nmembers);
+
+        // Return the name of the index file which save() writes for
+        // the archive outname.
+        std::string indexname(const std::string& outname);
+
+        // Write an index file for each archive given to record().
+        // Each line of an index gives the event number, ident and
+        // number of members of one event in the order written.
+        void save();
+
+        // Merge the archives of shards 0, 1, ... into one archive
+        // named outname.  The index file of each part gives the
+        // events it holds, which are copied in order of event number.
+        // Throws IOError if a part or its index can not be read or
+        // if the two disagree.
+        void merge(const std::string& outname, const std::vector<std::string>& partnames);
+    }  // namespace Shard
+
+}  // namespace WireCell
+
+#endif
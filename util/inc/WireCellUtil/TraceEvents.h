@@ -0,0 +1,76 @@
+#ifndef WIRECELLUTIL_TRACEEVENTS
+#define WIRECELLUTIL_TRACEEVENTS
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace WireCell {
+
+    /** Collect a timeline of calls and write it in the Chrome trace
+     * event JSON format.
+     *
+     * The result may be viewed with chrome://tracing or
+     * https://ui.perfetto.dev/.  Each event is a "complete" event
+     * ("ph":"X") with its start time and duration, a small thread
+     * index and optional sequence number and queue depths which are
+     * stored in the event "args".
+     *
+     * Use like
+     *
+     *   TraceEvents te;
+     *   ...
+     *   auto t0 = TraceEvents::clock_t::now();
+     *   do_something();
+     *   te.add({"something", "node", t0, TraceEvents::clock_t::now(),
+     *           TraceEvents::thread_index(), seqno});
+     *   ...
+     *   te.write("trace.json");
+     *
+     * Adding events is thread safe.
+     */
+    class TraceEvents {
+       public:
+        using clock_t = std::chrono::steady_clock;
+        using time_point = clock_t::time_point;
+
+        struct Event {
+            std::string name;
+            std::string cat;
+            time_point start, stop;
+            size_t tid{0};
+            // A negative sequence number is not written.
+            long seqno{-1};
+            // Depths of input and output queues at call time.
+            std::vector<size_t> iqueue{}, oqueue{};
+        };
+
+        // Event times are written relative to the given origin.
+        explicit TraceEvents(time_point origin = clock_t::now());
+
+        // Record one event.
+        void add(Event event);
+
+        // Number of events recorded so far.
+        size_t size() const;
+
+        // Write all events as a Chrome trace JSON document.
+        void write_json(std::ostream& out) const;
+
+        // Write to a file, throws IOError if it can not be opened.
+        void write(const std::string& filename) const;
+
+        // Return a small integer identifying the calling thread,
+        // counting from zero in order of first call.
+        static size_t thread_index();
+
+       private:
+        time_point m_origin;
+        mutable std::mutex m_mutex;
+        std::vector<Event> m_events;
+    };
+
+}  // namespace WireCell
+#endif
@@ -10,6 +10,8 @@
 #ifndef WIRECELLUTIL_TUPLEHELPERS
 #define WIRECELLUTIL_TUPLEHELPERS
 
+#include "WireCellUtil/Payload.h"
+
 #include <boost/any.hpp>
 
 #include <tuple>
@@ -78,6 +80,7 @@ namespace WireCell {
         };
 
         typedef std::vector<boost::any> any_vector_type;
+        typedef std::vector<Payload> payload_vector_type;
 
         /** Compile-time mapping of methods on tuple element types
          *
@@ -119,6 +122,35 @@ namespace WireCell {
             return from_any_impl(anyv, std::make_index_sequence<std::tuple_size<tuple_type>::value>{});
         }
 
+        // internal
+        template <std::size_t... Indices>
+        payload_vector_type as_payload_impl(tuple_type& t, std::index_sequence<Indices...>)
+        {
+            return {Payload(std::move(std::get<Indices>(t)))...};
+        }
+
+        /** Move a tuple of shared pointers into a vector of Payload.
+         */
+        payload_vector_type as_payload(tuple_type& t)
+        {
+            return as_payload_impl(t, std::make_index_sequence<std::tuple_size<tuple_type>::value>{});
+        }
+
+        // internal
+        template <std::size_t... Indices>
+        tuple_type from_payload_impl(const payload_vector_type& pv, std::index_sequence<Indices...>)
+        {
+            return std::make_tuple(pv[Indices].template get_unchecked<Types>()...);
+        }
+
+        /** Return a tuple of shared pointers from a vector of
+         *  Payload.  The payload types are not checked, see Payload.
+         */
+        tuple_type from_payload(const payload_vector_type& pv)
+        {
+            return from_payload_impl(pv, std::make_index_sequence<std::tuple_size<tuple_type>::value>{});
+        }
+
     };  // tuple_helpers
 
     template <typename T, std::size_t... Indices>
@@ -0,0 +1,47 @@
+#include "WireCellUtil/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+using namespace WireCell;
+
+void Parallel::for_each_index(size_t num, int nthreads, const std::function<void(size_t)>& func)
+{
+    if (nthreads <= 0) {
+        nthreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t nworkers = std::min<size_t>(nthreads, num);
+    if (nworkers <= 1) {
+        for (size_t ind = 0; ind < num; ++ind) {
+            func(ind);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::vector<std::exception_ptr> errors(num);
+    std::vector<std::thread> workers;
+    for (size_t iworker = 0; iworker < nworkers; ++iworker) {
+        workers.emplace_back([&]() {
+            for (size_t ind = next++; ind < num; ind = next++) {
+                try {
+                    func(ind);
+                }
+                catch (...) {
+                    errors[ind] = std::current_exception();
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include "WireCellUtil/Shard.h"
+#include "WireCellUtil/Exceptions.h"
+#include "WireCellUtil/Stream.h"
+#include "WireCellUtil/String.h"
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+using namespace WireCell;
+
+static size_t g_index = 0;
+static size_t g_count = 1;
+
+void Shard::set(size_t index, size_t count)
+{
+    if (!count or index >= count) {
+        THROW(ValueError() << errmsg{"Shard: index must be less than a nonzero count"});
+    }
+    g_index = index;
+    g_count = count;
+}
+
+size_t Shard::index() { return g_index; }
+
+size_t Shard::count() { return g_count; }
+
+bool Shard::mine(size_t num) { return g_count == 1 or num % g_count == g_index; }
+
+std::string Shard::outname(const std::string& name, size_t index)
+{
+    const size_t slash = name.rfind('/');
+    const size_t base = slash == std::string::npos ? 0 : slash + 1;
+    const size_t dot = name.find('.', base);
+    const std::string tag = "-worker" + std::to_string(index);
+    if (dot == std::string::npos) {
+        return name + tag;
+    }
+    return name.substr(0, dot) + tag + name.substr(dot);
+}
+
+namespace {
+    // One line of an index file.
+    struct Entry {
+        size_t num{0};
+        int ident{0};
+        size_t nmembers{0};
+    };
+    std::map<std::string, std::vector<Entry>> g_index_entries;
+    std::mutex g_index_mutex;
+}  // namespace
+
+void Shard::record(const std::string& outname, int ident, size_t nmembers)
+{
+    if (g_count == 1) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_index_mutex);
+    auto& entries = g_index_entries[outname];
+    entries.push_back({g_index + entries.size() * g_count, ident, nmembers});
+}
+
+std::string Shard::indexname(const std::string& outname) { return outname + ".shard"; }
+
+void Shard::save()
+{
+    std::lock_guard<std::mutex> lock(g_index_mutex);
+    for (const auto& [outname, entries] : g_index_entries) {
+        std::ofstream out(indexname(outname));
+        for (const auto& entry : entries) {
+            out << entry.num << " " << entry.ident << " " << entry.nmembers << "\n";
+        }
+        if (!out) {
+            THROW(IOError() << errmsg{"Shard: failed to write " + indexname(outname)});
+        }
+    }
+}
+
+void Shard::merge(const std::string& outname, const std::vector<std::string>& partnames)
+{
+    struct Part {
+        boost::iostreams::filtering_istream in;
+        std::vector<Entry> entries;
+        size_t next{0};  // index of the next entry to copy
+    };
+    std::vector<std::unique_ptr<Part>> parts;
+    for (const auto& partname : partnames) {
+        auto part = std::make_unique<Part>();
+        std::ifstream index(indexname(partname));
+        if (!index) {
+            THROW(IOError() << errmsg{"Shard: no index for " + partname});
+        }
+        Entry entry;
+        while (index >> entry.num >> entry.ident >> entry.nmembers) {
+            part->entries.push_back(entry);
+        }
+        Stream::input_filters(part->in, partname);
+        parts.push_back(std::move(part));
+    }
+
+    boost::iostreams::filtering_ostream out;
+    Stream::output_filters(out, outname);
+    std::string name, body;
+    size_t size = 0;
+    while (true) {
+        // The part holding the lowest numbered event not yet copied.
+        Part* first = nullptr;
+        for (auto& part : parts) {
+            if (part->next < part->entries.size() and
+                (!first or part->entries[part->next].num < first->entries[first->next].num)) {
+                first = part.get();
+            }
+        }
+        if (!first) {
+            break;
+        }
+        const auto& entry = first->entries[first->next++];
+        for (size_t ind = 0; ind < entry.nmembers; ++ind) {
+            if (!custard::read(first->in, name, size)) {
+                THROW(IOError() << errmsg{"Shard: archive ends before event " + std::to_string(entry.ident)});
+            }
+            body.resize(size);
+            first->in.read(body.data(), size);
+            custard::write(out, name, size);
+            out.write(body.data(), size);
+        }
+    }
+    out.pop();
+
+    for (size_t ind = 0; ind < parts.size(); ++ind) {
+        if (custard::read(parts[ind]->in, name, size)) {
+            THROW(IOError() << errmsg{"Shard: member " + name + " is not in the index of " + partnames[ind]});
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include "WireCellUtil/TraceEvents.h"
+#include "WireCellUtil/Exceptions.h"
+
+#include <atomic>
+#include <fstream>
+
+using namespace WireCell;
+
+TraceEvents::TraceEvents(time_point origin)
+  : m_origin(origin)
+{
+}
+
+void TraceEvents::add(Event event)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_events.push_back(std::move(event));
+}
+
+size_t TraceEvents::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_events.size();
+}
+
+size_t TraceEvents::thread_index()
+{
+    static std::atomic<size_t> next{0};
+    thread_local const size_t index = next++;
+    return index;
+}
+
+static void write_string(std::ostream& out, const std::string& str)
+{
+    out << '"';
+    for (char c : str) {
+        switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if ((unsigned char) c < 0x20) {
+                continue;
+            }
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+static void write_sizes(std::ostream& out, const std::vector<size_t>& sizes)
+{
+    out << '[';
+    for (size_t ind = 0; ind < sizes.size(); ++ind) {
+        if (ind) out << ',';
+        out << sizes[ind];
+    }
+    out << ']';
+}
+
+void TraceEvents::write_json(std::ostream& out) const
+{
+    using usec = std::chrono::duration<double, std::micro>;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t ind = 0; ind < m_events.size(); ++ind) {
+        const auto& ev = m_events[ind];
+        if (ind) out << ",";
+        out << "\n{\"ph\":\"X\",\"pid\":0,\"tid\":" << ev.tid << ",\"name\":";
+        write_string(out, ev.name);
+        out << ",\"cat\":";
+        write_string(out, ev.cat);
+        out << ",\"ts\":" << usec(ev.start - m_origin).count()
+            << ",\"dur\":" << usec(ev.stop - ev.start).count()
+            << ",\"args\":{";
+        bool comma = false;
+        if (ev.seqno >= 0) {
+            out << "\"seqno\":" << ev.seqno;
+            comma = true;
+        }
+        if (!ev.iqueue.empty()) {
+            if (comma) out << ",";
+            out << "\"iqueue\":";
+            write_sizes(out, ev.iqueue);
+            comma = true;
+        }
+        if (!ev.oqueue.empty()) {
+            if (comma) out << ",";
+            out << "\"oqueue\":";
+            write_sizes(out, ev.oqueue);
+        }
+        out << "}}";
+    }
+    out << "\n]}\n";
+}
+
+void TraceEvents::write(const std::string& filename) const
+{
+    std::ofstream out(filename);
+    if (!out) {
+        THROW(IOError() << errmsg{"failed to open trace file: " + filename});
+    }
+    write_json(out);
+}
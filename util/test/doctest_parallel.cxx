@@ -0,0 +1,44 @@
+#include "WireCellUtil/Parallel.h"
+#include "WireCellUtil/doctest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace WireCell;
+
+TEST_CASE("parallel for each index")
+{
+    const size_t num = 100;
+    for (int nthreads : {1, 0, 4, 200}) {
+        std::vector<int> ncalls(num, 0);
+        Parallel::for_each_index(num, nthreads, [&](size_t ind) { ++ncalls[ind]; });
+        CHECK(ncalls == std::vector<int>(num, 1));
+    }
+    Parallel::for_each_index(0, 4, [](size_t ind) { CHECK(false); });
+}
+
+TEST_CASE("parallel rethrows lowest index")
+{
+    for (int nthreads : {1, 4}) {
+        std::atomic<size_t> ncalls{0};
+        try {
+            Parallel::for_each_index(20, nthreads, [&](size_t ind) {
+                ++ncalls;
+                if (ind == 7 or ind == 13) {
+                    throw std::runtime_error(std::to_string(ind));
+                }
+            });
+            CHECK(false);
+        }
+        catch (const std::runtime_error& err) {
+            CHECK(std::string(err.what()) == "7");
+        }
+        if (nthreads == 1) {
+            CHECK(ncalls == 8);  // serial calls stop at the first throw
+        }
+        else {
+            CHECK(ncalls == 20);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#include "WireCellUtil/Payload.h"
+#include "WireCellUtil/TupleHelpers.h"
+
+#include "WireCellUtil/doctest.h"
+
+#include <deque>
+
+using namespace WireCell;
+
+struct Thing {
+    int num{0};
+};
+using thing_ptr = std::shared_ptr<const Thing>;
+
+TEST_CASE("payload empty")
+{
+    Payload p;
+    CHECK(p.empty());
+    CHECK(p.type() == typeid(void));
+}
+
+TEST_CASE("payload shared pointer")
+{
+    auto thing = std::make_shared<const Thing>(Thing{42});
+    Payload p = thing;
+    CHECK(!p.empty());
+    CHECK(p.type() == typeid(thing_ptr));
+
+    // Shares the producer's pointer, no copy of the Thing.
+    CHECK(thing.use_count() == 2);
+    CHECK(p.get<thing_ptr>().get() == thing.get());
+    CHECK(p.get_unchecked<thing_ptr>()->num == 42);
+
+    Payload copy = p;
+    CHECK(thing.use_count() == 3);
+    Payload moved = std::move(copy);
+    CHECK(thing.use_count() == 3);
+    CHECK(moved.get_unchecked<thing_ptr>().get() == thing.get());
+
+    CHECK_THROWS_AS(p.get<std::shared_ptr<const int>>(), boost::bad_any_cast);
+    CHECK_THROWS_AS(p.get<int>(), boost::bad_any_cast);
+
+    // The boost::any level holds the same pointer type.
+    boost::any a = p.any();
+    CHECK(boost::any_cast<thing_ptr>(a).get() == thing.get());
+}
+
+TEST_CASE("payload null pointer is typed")
+{
+    // An EOS keeps its type.
+    Payload p = thing_ptr();
+    CHECK(!p.empty());
+    CHECK(p.type() == typeid(thing_ptr));
+    CHECK(!p.get_unchecked<thing_ptr>());
+    CHECK(!boost::any_cast<thing_ptr>(p.any()));
+}
+
+TEST_CASE("payload other values")
+{
+    Payload p = 42;
+    CHECK(p.type() == typeid(int));
+    CHECK(p.get<int>() == 42);
+    CHECK(p.get_unchecked<int>() == 42);
+    CHECK_THROWS_AS(p.get<float>(), boost::bad_any_cast);
+    CHECK_THROWS_AS(p.get<thing_ptr>(), boost::bad_any_cast);
+
+    std::deque<Payload> q{1, 2, 3};
+    Payload pq = q;
+    CHECK(pq.get<std::deque<Payload>>().size() == 3);
+
+    // A pointer given as boost::any, as a hydra node makes, stays
+    // in the any and is still reachable.
+    auto thing = std::make_shared<const Thing>(Thing{7});
+    Payload pa = boost::any(thing);
+    CHECK(pa.type() == typeid(thing_ptr));
+    CHECK(pa.get<thing_ptr>()->num == 7);
+    CHECK(pa.get_unchecked<thing_ptr>()->num == 7);
+}
+
+TEST_CASE("payload tuple helper")
+{
+    using tuple_type = std::tuple<thing_ptr, std::shared_ptr<const int>>;
+    tuple_helper<tuple_type> th;
+
+    tuple_type tup{std::make_shared<const Thing>(Thing{1}), std::make_shared<const int>(2)};
+    auto pv = th.as_payload(tup);
+    REQUIRE(pv.size() == 2);
+    CHECK(pv[0].type() == typeid(thing_ptr));
+    CHECK(pv[1].type() == typeid(std::shared_ptr<const int>));
+
+    auto back = th.from_payload(pv);
+    CHECK(std::get<0>(back)->num == 1);
+    CHECK(*std::get<1>(back) == 2);
+}
@@ -0,0 +1,93 @@
+#include "WireCellUtil/Shard.h"
+#include "WireCellUtil/Exceptions.h"
+#include "WireCellUtil/Stream.h"
+#include "WireCellUtil/doctest.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace WireCell;
+
+TEST_CASE("shard events")
+{
+    CHECK(Shard::count() == 1);
+    CHECK(Shard::mine(0));
+    CHECK(Shard::mine(7));
+
+    Shard::set(1, 3);
+    CHECK(Shard::index() == 1);
+    CHECK(Shard::count() == 3);
+    CHECK(!Shard::mine(0));
+    CHECK(Shard::mine(1));
+    CHECK(!Shard::mine(2));
+    CHECK(Shard::mine(4));
+
+    CHECK_THROWS_AS(Shard::set(3, 3), ValueError);
+    CHECK_THROWS_AS(Shard::set(0, 0), ValueError);
+
+    Shard::set(0, 1);
+    CHECK(Shard::mine(5));
+}
+
+TEST_CASE("shard outname")
+{
+    CHECK(Shard::outname("out.tar.bz2", 1) == "out-worker1.tar.bz2");
+    CHECK(Shard::outname("out", 0) == "out-worker0");
+    CHECK(Shard::outname("dir.d/out.npz", 2) == "dir.d/out-worker2.npz");
+    CHECK(Shard::outname("dir.d/out", 3) == "dir.d/out-worker3");
+}
+
+TEST_CASE("shard merge")
+{
+    // Three workers, seven events, as a frame file sink would write.
+    // Member names need not hold the event number and events may have
+    // differing numbers of members.
+    const size_t nworkers = 3, nevents = 7;
+    auto nmembers = [](size_t event) -> size_t { return event % 2 ? 3 : 2; };
+    std::vector<std::string> partnames;
+    for (size_t worker = 0; worker < nworkers; ++worker) {
+        Shard::set(worker, nworkers);
+        partnames.push_back(Shard::outname("doctest_shard_merge.tar", worker));
+        boost::iostreams::filtering_ostream out;
+        Stream::output_filters(out, partnames.back());
+        for (size_t event = worker; event < nevents; event += nworkers) {
+            const int ident = 100 - event;
+            for (size_t member = 0; member < nmembers(event); ++member) {
+                const std::vector<int> data(event + 1, member);
+                Stream::write(out, "frame_orig_" + std::to_string(ident) + ".npy", data);
+            }
+            Shard::record(partnames.back(), ident, nmembers(event));
+        }
+        out.pop();
+    }
+    Shard::set(0, 1);
+    Shard::save();
+
+    Shard::merge("doctest_shard_merge.tar", partnames);
+
+    boost::iostreams::filtering_istream in;
+    Stream::input_filters(in, "doctest_shard_merge.tar");
+    for (size_t event = 0; event < nevents; ++event) {
+        for (size_t member = 0; member < nmembers(event); ++member) {
+            std::string name;
+            std::vector<int> data;
+            Stream::read(in, name, data);
+            REQUIRE(in);
+            CHECK(name == "frame_orig_" + std::to_string(100 - event) + ".npy");
+            CHECK(data == std::vector<int>(event + 1, member));
+        }
+    }
+    std::string name;
+    size_t size = 0;
+    CHECK(!custard::read(in, name, size));
+
+    std::remove(Shard::indexname(partnames[1]).c_str());
+    CHECK_THROWS_AS(Shard::merge("doctest_shard_merge.tar", partnames), IOError);
+
+    for (const auto& partname : partnames) {
+        std::remove(partname.c_str());
+        std::remove(Shard::indexname(partname).c_str());
+    }
+    std::remove("doctest_shard_merge.tar");
+}
@@ -0,0 +1,45 @@
+#include "WireCellUtil/TraceEvents.h"
+#include "WireCellUtil/Persist.h"
+#include "WireCellUtil/doctest.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace WireCell;
+
+TEST_CASE("trace events chrome json")
+{
+    const auto t0 = TraceEvents::clock_t::now();
+    TraceEvents te(t0);
+
+    TraceEvents::Event ev;
+    ev.name = "node \"one\"";
+    ev.cat = "test";
+    ev.start = t0 + std::chrono::microseconds(10);
+    ev.stop = t0 + std::chrono::microseconds(30);
+    ev.tid = TraceEvents::thread_index();
+    ev.seqno = 42;
+    ev.iqueue = {1, 2};
+    te.add(ev);
+
+    std::thread other([&]() {
+        te.add({"two", "test", t0, t0, TraceEvents::thread_index()});
+    });
+    other.join();
+    CHECK(te.size() == 2);
+
+    std::stringstream ss;
+    te.write_json(ss);
+    auto jdoc = Persist::loads(ss.str());
+    auto jevs = jdoc["traceEvents"];
+    REQUIRE(jevs.size() == 2);
+    CHECK(jevs[0]["name"].asString() == "node \"one\"");
+    CHECK(jevs[0]["ph"].asString() == "X");
+    CHECK(jevs[0]["ts"].asDouble() == doctest::Approx(10));
+    CHECK(jevs[0]["dur"].asDouble() == doctest::Approx(20));
+    CHECK(jevs[0]["args"]["seqno"].asInt() == 42);
+    CHECK(jevs[0]["args"]["iqueue"][1].asInt() == 2);
+    CHECK(jevs[0]["args"]["oqueue"].isNull());
+    CHECK(jevs[1]["args"]["seqno"].isNull());
+    CHECK(jevs[0]["tid"].asInt() != jevs[1]["tid"].asInt());
+}